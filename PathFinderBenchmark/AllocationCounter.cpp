@@ -0,0 +1,151 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+std::atomic<uint64_t> g_allocationCount(0);
+
+static void* allocate(size_t size)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	return malloc(size == 0 ? 1 : size);
+}
+
+// aligned_alloc()은 크기가 정렬 단위의 배수여야 하고, MSVC에는 없으므로 _aligned_malloc()을 쓴다 (해제도 짝을 맞춘다)
+static void* allocateAligned(size_t size, std::align_val_t alignment)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	const size_t align = static_cast<size_t>(alignment);
+	size = size == 0 ? align : (size + align - 1) / align * align;
+
+#ifdef _WIN32
+	return _aligned_malloc(size, align);
+#else
+	return aligned_alloc(align, size);
+#endif
+}
+
+static void deallocateAligned(void* address)
+{
+#ifdef _WIN32
+	_aligned_free(address);
+#else
+	free(address);
+#endif
+}
+
+void* operator new(size_t size)
+{
+	void* address = allocate(size);
+
+	if (address == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return address;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* address = allocateAligned(size, alignment);
+
+	if (address == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return address;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocateAligned(size, alignment);
+}
+
+void operator delete(void* address) noexcept
+{
+	free(address);
+}
+
+void operator delete[](void* address) noexcept
+{
+	free(address);
+}
+
+void operator delete(void* address, size_t) noexcept
+{
+	free(address);
+}
+
+void operator delete[](void* address, size_t) noexcept
+{
+	free(address);
+}
+
+void operator delete(void* address, const std::nothrow_t&) noexcept
+{
+	free(address);
+}
+
+void operator delete[](void* address, const std::nothrow_t&) noexcept
+{
+	free(address);
+}
+
+void operator delete(void* address, std::align_val_t) noexcept
+{
+	deallocateAligned(address);
+}
+
+void operator delete[](void* address, std::align_val_t) noexcept
+{
+	deallocateAligned(address);
+}
+
+void operator delete(void* address, size_t, std::align_val_t) noexcept
+{
+	deallocateAligned(address);
+}
+
+void operator delete[](void* address, size_t, std::align_val_t) noexcept
+{
+	deallocateAligned(address);
+}
+
+void operator delete(void* address, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	deallocateAligned(address);
+}
+
+void operator delete[](void* address, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	deallocateAligned(address);
+}
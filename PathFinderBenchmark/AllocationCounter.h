@@ -0,0 +1,18 @@
+// 전역 operator new/delete를 바꿔서 힙 할당 횟수를 셉니다. (alloc 벤치마크용)
+// 일반, 배열, nothrow, 크기 지정, 정렬 지정 형태를 모두 같은 malloc/free 계열로 바꾸므로 어느 짝으로 해제해도 맞습니다.
+// 바꾼 함수들은 AllocationCounter.cpp에만 두어, 호출하는 쪽에 인라인되지 않게 합니다.
+// (같은 파일에 두면 인라인된 delete의 free()를 컴파일러가 operator new의 결과와 짝이 맞지 않는다고 경고한다)
+
+/************************************** 사용법 **************************************/
+// uint64_t before = g_allocationCount.load();
+// ...
+// uint64_t allocationCount = g_allocationCount.load() - before;
+/************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 프로그램 시작 이후 operator new를 호출한 횟수 (모든 형태 포함)
+extern std::atomic<uint64_t> g_allocationCount;
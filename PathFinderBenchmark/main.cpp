@@ -0,0 +1,3496 @@
+// 길찾기 성능 측정용 벤치마크
+// 서버 없이 길찾기 모듈만 단독으로 돌려서 쿼리 당 소요 시간을 측정합니다.
+// 인자 없이 실행하면 모든 벤치마크를 실행하고, 인자로 벤치마크 이름을 주면 해당 벤치마크만 실행합니다.
+
+// 클릭 기록 파일을 fopen/fscanf로 읽기 위해 (다른 플랫폼과 같은 코드 사용)
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <list>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <cmath>
+#include <functional>
+
+#include "../UnityJPSPortfolio/JPSPathFinder.h"
+#include "../UnityJPSPortfolio/AStarPathFinder.h"
+#include "../UnityJPSPortfolio/PathFindService.h"
+#include "../UnityJPSPortfolio/HPAPathFinder.h"
+#include "../UnityJPSPortfolio/PriorityQueue.h"
+#include "../UnityJPSPortfolio/IndexedPriorityQueue.h"
+#include "../UnityJPSPortfolio/Line.h"
+#include "../UnityJPSPortfolio/LineOfSight.h"
+#include "../UnityJPSPortfolio/FlowFieldCache.h"
+#include "../UnityJPSPortfolio/DStarLitePathFinder.h"
+#include "../UnityJPSPortfolio/PathSegmentIndex.h"
+#include "../UnityJPSPortfolio/MapFile.h"
+
+#include "AllocationCounter.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/************************************** 테스트 맵 **************************************/
+
+// 무작위 장애물 맵
+// 시작점과 도착점이 서로 연결된 쿼리만 뽑을 수 있도록 연결 요소 번호를 같이 계산해둔다
+struct TestMap
+{
+	int Width;
+	int Height;
+	std::vector<bool> Walkable;
+	std::vector<int> Component;
+
+	TestMap(int width, int height, double obstacleRatio, unsigned int seed)
+		: Width(width)
+		, Height(height)
+		, Walkable(width * height, true)
+		, Component(width * height, -1)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<double> ratio(0.0, 1.0);
+
+		for (int i = 0; i < width * height; ++i)
+		{
+			Walkable[i] = ratio(random) >= obstacleRatio;
+		}
+
+		labelComponents();
+	}
+
+	inline bool IsWalkable(int x, int y) const { return Walkable[y * Width + x]; }
+
+	// Walkable을 직접 바꾼 뒤 연결 요소를 다시 계산한다
+	void Relabel()
+	{
+		Component.assign(Width * Height, -1);
+		labelComponents();
+	}
+
+	template <typename PathFinder>
+	void ApplyTo(PathFinder& pathFinder) const
+	{
+		for (int y = 0; y < Height; ++y)
+		{
+			for (int x = 0; x < Width; ++x)
+			{
+				if (IsWalkable(x, y) == false)
+				{
+					pathFinder.Block(x, y);
+				}
+			}
+		}
+	}
+
+private:
+	// 8방향 연결 기준 연결 요소
+	void labelComponents()
+	{
+		std::vector<int> stack;
+		int componentID = 0;
+
+		for (int i = 0; i < Width * Height; ++i)
+		{
+			if (Walkable[i] == false || Component[i] != -1)
+			{
+				continue;
+			}
+
+			Component[i] = componentID;
+			stack.push_back(i);
+
+			while (stack.empty() == false)
+			{
+				int cell = stack.back();
+				stack.pop_back();
+
+				int cx = cell % Width;
+				int cy = cell / Width;
+
+				for (int dy = -1; dy <= 1; ++dy)
+				{
+					for (int dx = -1; dx <= 1; ++dx)
+					{
+						int nx = cx + dx;
+						int ny = cy + dy;
+
+						if (nx < 0 || nx >= Width || ny < 0 || ny >= Height)
+						{
+							continue;
+						}
+
+						int next = ny * Width + nx;
+
+						if (Walkable[next] && Component[next] == -1)
+						{
+							Component[next] = componentID;
+							stack.push_back(next);
+						}
+					}
+				}
+			}
+
+			componentID++;
+		}
+	}
+};
+
+struct Query
+{
+	int StartX;
+	int StartY;
+	int EndX;
+	int EndY;
+};
+
+// 시작점과 도착점 사이의 체비쇼프 거리가 [minDistance, maxDistance]인 쿼리를 만든다
+static std::vector<Query> makeQueries(const TestMap& map, int count, int minDistance, int maxDistance, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<int> randomX(0, map.Width - 1);
+	std::uniform_int_distribution<int> randomY(0, map.Height - 1);
+	std::uniform_int_distribution<int> randomDistance(minDistance, maxDistance);
+	std::uniform_int_distribution<int> randomSign(0, 1);
+
+	std::vector<Query> queries;
+
+	while ((int)queries.size() < count)
+	{
+		int startX = randomX(random);
+		int startY = randomY(random);
+		int distance = randomDistance(random);
+		int major = randomSign(random) ? distance : -distance;
+		int minor = std::uniform_int_distribution<int>(-distance, distance)(random);
+		int endX;
+		int endY;
+
+		if (randomSign(random))
+		{
+			endX = startX + major;
+			endY = startY + minor;
+		}
+		else
+		{
+			endX = startX + minor;
+			endY = startY + major;
+		}
+
+		if (endX < 0 || endX >= map.Width || endY < 0 || endY >= map.Height)
+		{
+			continue;
+		}
+
+		if (map.IsWalkable(startX, startY) == false || map.IsWalkable(endX, endY) == false)
+		{
+			continue;
+		}
+
+		if (map.Component[startY * map.Width + startX] != map.Component[endY * map.Width + endX])
+		{
+			continue;
+		}
+
+		queries.push_back(Query{ startX, startY, endX, endY });
+	}
+
+	return queries;
+}
+
+// 쿼리들을 모두 수행하고 쿼리 당 평균 소요 시간(us)을 반환한다
+template <typename PathFinder>
+static double measurePerQueryMicroseconds(PathFinder& pathFinder, const std::vector<Query>& queries)
+{
+	auto begin = std::chrono::steady_clock::now();
+
+	for (const Query& query : queries)
+	{
+		pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::micro>(end - begin).count() / queries.size();
+}
+
+/************************************** 벤치마크 **************************************/
+
+// 맵 크기에 따른 쿼리 당 소요 시간 (짧은/중간/긴 경로)
+// 탐색 상태 초기화 비용이 맵 크기에 비례하는지 확인하기 위한 용도
+static void benchMapSize(void)
+{
+	const int MAP_SIZES[] = { 200, 500, 1000, 2000 };
+	const double OBSTACLE_RATIO = 0.2;
+
+	printf("[map-size] JPSPathFinder per-query time (us)\n");
+	printf("%10s %12s %12s %12s\n", "map", "short", "medium", "long");
+
+	for (int size : MAP_SIZES)
+	{
+		TestMap map(size, size, OBSTACLE_RATIO, 1234);
+
+		JPSPathFinder pathFinder(size, size);
+		map.ApplyTo(pathFinder);
+
+		std::vector<Query> shortQueries = makeQueries(map, 2000, 2, 8, 1);
+		std::vector<Query> mediumQueries = makeQueries(map, 500, 30, 60, 2);
+		std::vector<Query> longQueries = makeQueries(map, 50, size / 2, size - 1, 3);
+
+		double shortTime = measurePerQueryMicroseconds(pathFinder, shortQueries);
+		double mediumTime = measurePerQueryMicroseconds(pathFinder, mediumQueries);
+		double longTime = measurePerQueryMicroseconds(pathFinder, longQueries);
+
+		printf("%5dx%-4d %12.2f %12.2f %12.2f\n", size, size, shortTime, mediumTime, longTime);
+	}
+
+	printf("\n");
+}
+
+// OPEN LIST 연산 비용 비교 (기존 이진 힙 vs 인덱스 d-ary 힙)
+// 탐색과 비슷하게 Pop 한 번마다 새 노드 Push와 DecreaseKey가 섞여 들어오는 작업을 똑같이 재생한다
+
+// 기존 이진 힙 : 노드를 하나씩 new로 만들어 포인터를 넣고, 비교할 때마다 노드를 읽는다
+static double measureOpenListMilliseconds(PriorityQueue& openList, int width, int height, int expandCount, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<int> randomX(0, width - 1);
+	std::uniform_int_distribution<int> randomY(0, height - 1);
+	std::uniform_int_distribution<int> randomG(0, width * 5);
+
+	std::vector<bool> pushed(width * height, false);
+
+	auto begin = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < expandCount; ++i)
+	{
+		// 확장 한 번에 새 노드 4개, 기존 노드 갱신 4번
+		for (int j = 0; j < 4; ++j)
+		{
+			int x = randomX(random);
+			int y = randomY(random);
+
+			if (pushed[y * width + x] == false)
+			{
+				pushed[y * width + x] = true;
+				openList.Push(new Node(x, y, randomG(random), nullptr, OctileHeuristic<>(width / 2, height / 2).Get(x, y)));
+				continue;
+			}
+
+			int index;
+			Node* node = openList.GetNodeOrNull(x, y, index);
+
+			if (node != nullptr && node->G > 0)
+			{
+				node->G--;
+				node->F--;
+				openList.RepairHeap(index);
+			}
+		}
+
+		if (openList.Empty() == false)
+		{
+			Node* top = openList.Top();
+			openList.Pop();
+			delete top;
+		}
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	while (openList.Empty() == false)
+	{
+		Node* top = openList.Top();
+		openList.Pop();
+		delete top;
+	}
+
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// 인덱스 d-ary 힙 : 노드는 NodeArena에 두고, 힙에는 (F, H, 노드 번호) 키만 넣는다 (같은 작업을 같은 순서로 재생)
+template <int ARITY>
+static double measureOpenListMilliseconds(IndexedPriorityQueue<ARITY>& openList, int width, int height, int expandCount, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<int> randomX(0, width - 1);
+	std::uniform_int_distribution<int> randomY(0, height - 1);
+	std::uniform_int_distribution<int> randomG(0, width * 5);
+
+	NodeArena nodes;
+	std::vector<NodeIndex> cellNodes(width * height, NULL_NODE);
+
+	auto begin = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < expandCount; ++i)
+	{
+		// 확장 한 번에 새 노드 4개, 기존 노드 갱신 4번
+		for (int j = 0; j < 4; ++j)
+		{
+			int x = randomX(random);
+			int y = randomY(random);
+			NodeIndex& cellNode = cellNodes[y * width + x];
+
+			if (cellNode == NULL_NODE)
+			{
+				int g = randomG(random);
+				int h = OctileHeuristic<>(width / 2, height / 2).Get(x, y);
+
+				cellNode = nodes.Alloc(x, y, g, NULL_NODE, h);
+				openList.Push(cellNode, g + h, h);
+				continue;
+			}
+
+			if (openList.Contains(cellNode) && nodes.GetG(cellNode) > 0)
+			{
+				nodes.SetG(cellNode, nodes.GetG(cellNode) - 1);
+				openList.DecreaseKey(cellNode, nodes.GetG(cellNode) + nodes.GetH(cellNode));
+			}
+		}
+
+		if (openList.Empty() == false)
+		{
+			openList.Pop();
+		}
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	openList.Clear();
+
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+static void benchOpenList(void)
+{
+	const int MAP_SIZES[] = { 200, 500, 1000 };
+	const int EXPAND_COUNT = 20'000;
+
+	printf("[open-list] %d expansions (4 push + 4 decrease-key each), total ms\n", EXPAND_COUNT);
+	printf("%10s %16s %16s %16s\n", "map", "PriorityQueue", "Indexed 2-ary", "Indexed 4-ary");
+
+	for (int size : MAP_SIZES)
+	{
+		PriorityQueue binaryHeap(size * size);
+		IndexedPriorityQueue<2> indexedBinaryHeap;
+		IndexedPriorityQueue<4> indexedQuaternaryHeap;
+
+		double binaryTime = measureOpenListMilliseconds(binaryHeap, size, size, EXPAND_COUNT, 7);
+		double indexedBinaryTime = measureOpenListMilliseconds(indexedBinaryHeap, size, size, EXPAND_COUNT, 7);
+		double indexedQuaternaryTime = measureOpenListMilliseconds(indexedQuaternaryHeap, size, size, EXPAND_COUNT, 7);
+
+		printf("%5dx%-4d %16.2f %16.2f %16.2f\n", size, size, binaryTime, indexedBinaryTime, indexedQuaternaryTime);
+	}
+
+	printf("\n");
+}
+
+// 두 경로가 완전히 같은가
+static bool isSamePoints(const Path& pointsA, const Path& pointsB)
+{
+	if (pointsA.Size() != pointsB.Size())
+	{
+		return false;
+	}
+
+	for (int i = 0; i < pointsA.Size(); ++i)
+	{
+		if (pointsA[i].X != pointsB[i].X || pointsA[i].Y != pointsB[i].Y)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// 두 길찾기 결과의 경로가 완전히 같은가
+template <typename PathFinderA, typename PathFinderB>
+static bool isSamePath(PathFinderA& a, PathFinderB& b)
+{
+	return isSamePoints(a.GetPoints(), b.GetPoints());
+}
+
+// JPS 결과 검증
+// 무작위 맵과 무작위 쿼리에 대해 JPS와 A*의 도달 가능 여부와 경로 비용(경로를 줄이기 전)이 같은지 비교한다
+// JPS+ 모드는 JPS와 경로가 완전히 같은지 비교하며, 중간중간 맵을 바꿔 테이블의 부분 갱신도 같이 검증한다
+static void benchVerify(void)
+{
+	const int MAP_SIZES[] = { 1, 2, 17, 63, 64, 65, 128, 129, 200 };
+	const int MAP_COUNT = 100;
+	const int QUERY_COUNT_PER_MAP = 200;
+	const int QUERY_COUNT_PER_EDIT = 20;
+	const int CELL_COUNT_PER_EDIT = 5;
+
+	std::mt19937 random(2024);
+	std::uniform_int_distribution<int> randomSize(0, sizeof(MAP_SIZES) / sizeof(MAP_SIZES[0]) - 1);
+	std::uniform_real_distribution<double> randomRatio(0.0, 0.45);
+
+	int queryCount = 0;
+	int failCount = 0;
+	int jumpTableFailCount = 0;
+
+	for (int i = 0; i < MAP_COUNT; ++i)
+	{
+		int width = MAP_SIZES[randomSize(random)];
+		int height = MAP_SIZES[randomSize(random)];
+		TestMap map(width, height, randomRatio(random), random());
+
+		JPSPathFinder jps(width, height);
+		JPSPathFinder jpsPlus(width, height);
+		AStarPathFinder aStar(width, height);
+		map.ApplyTo(jps);
+		map.ApplyTo(jpsPlus);
+		map.ApplyTo(aStar);
+		jpsPlus.EnableJumpTable();
+
+		std::uniform_int_distribution<int> randomX(0, width - 1);
+		std::uniform_int_distribution<int> randomY(0, height - 1);
+
+		for (int j = 0; j < QUERY_COUNT_PER_MAP; ++j)
+		{
+			if (j % QUERY_COUNT_PER_EDIT == QUERY_COUNT_PER_EDIT - 1)
+			{
+				for (int k = 0; k < CELL_COUNT_PER_EDIT; ++k)
+				{
+					int x = randomX(random);
+					int y = randomY(random);
+					bool bWalkable = map.IsWalkable(x, y) == false;
+
+					map.Walkable[y * width + x] = bWalkable;
+
+					if (bWalkable)
+					{
+						jps.UnBlock(x, y);
+						jpsPlus.UnBlock(x, y);
+						aStar.UnBlock(x, y);
+					}
+					else
+					{
+						jps.Block(x, y);
+						jpsPlus.Block(x, y);
+						aStar.Block(x, y);
+					}
+				}
+			}
+
+			Query query{ randomX(random), randomY(random), randomX(random), randomY(random) };
+
+			if (map.IsWalkable(query.StartX, query.StartY) == false || map.IsWalkable(query.EndX, query.EndY) == false)
+			{
+				continue;
+			}
+
+			jps.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			jpsPlus.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			aStar.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+
+			queryCount++;
+
+			if (jps.GetPathCost() != aStar.GetPathCost())
+			{
+				failCount++;
+				printf("  FAIL %dx%d (%d, %d) -> (%d, %d): JPS cost %d, A* cost %d\n",
+					width, height, query.StartX, query.StartY, query.EndX, query.EndY, jps.GetPathCost(), aStar.GetPathCost());
+			}
+
+			if (jpsPlus.GetPathCost() != jps.GetPathCost() || isSamePath(jps, jpsPlus) == false)
+			{
+				jumpTableFailCount++;
+				printf("  FAIL %dx%d (%d, %d) -> (%d, %d): JPS+ path differs from JPS\n",
+					width, height, query.StartX, query.StartY, query.EndX, query.EndY);
+			}
+		}
+	}
+
+	printf("[verify] JPS vs A*: %d queries, %d failed\n", queryCount, failCount);
+	printf("[verify] JPS+ vs JPS: %d queries, %d failed\n\n", queryCount, jumpTableFailCount);
+}
+
+// JPS와 JPS+의 쿼리 당 소요 시간, 테이블 전체 계산과 셀 하나 변경 시 부분 갱신 비용
+static void benchJumpTable(void)
+{
+	const int MAP_SIZES[] = { 200, 500, 1000, 2000 };
+	const double OBSTACLE_RATIO = 0.2;
+	const int EDIT_COUNT = 200;
+
+	printf("[jump-table] per-query time (us) for medium / long paths, table build and per-cell update (ms)\n");
+	printf("%10s %10s %10s %10s %10s %10s %10s\n", "map", "JPS mid", "JPS+ mid", "JPS long", "JPS+ long", "build", "update");
+
+	for (int size : MAP_SIZES)
+	{
+		TestMap map(size, size, OBSTACLE_RATIO, 1234);
+
+		JPSPathFinder jps(size, size);
+		JPSPathFinder jpsPlus(size, size);
+		map.ApplyTo(jps);
+		map.ApplyTo(jpsPlus);
+
+		auto buildBegin = std::chrono::steady_clock::now();
+		jpsPlus.EnableJumpTable();
+		auto buildEnd = std::chrono::steady_clock::now();
+
+		std::vector<Query> mediumQueries = makeQueries(map, 500, 30, 60, 2);
+		std::vector<Query> longQueries = makeQueries(map, 50, size / 2, size - 1, 3);
+
+		double jpsMediumTime = measurePerQueryMicroseconds(jps, mediumQueries);
+		double jpsPlusMediumTime = measurePerQueryMicroseconds(jpsPlus, mediumQueries);
+		double jpsLongTime = measurePerQueryMicroseconds(jps, longQueries);
+		double jpsPlusLongTime = measurePerQueryMicroseconds(jpsPlus, longQueries);
+
+		// 같은 칸을 막았다가 다시 뚫어서 맵은 그대로 둔다
+		std::mt19937 random(5);
+		std::uniform_int_distribution<int> randomPosition(0, size - 1);
+
+		auto updateBegin = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < EDIT_COUNT; ++i)
+		{
+			int x = randomPosition(random);
+			int y = randomPosition(random);
+
+			if (map.IsWalkable(x, y))
+			{
+				jpsPlus.Block(x, y);
+				jpsPlus.UnBlock(x, y);
+			}
+		}
+
+		auto updateEnd = std::chrono::steady_clock::now();
+
+		double buildTime = std::chrono::duration<double, std::milli>(buildEnd - buildBegin).count();
+		double updateTime = std::chrono::duration<double, std::milli>(updateEnd - updateBegin).count() / (EDIT_COUNT * 2);
+
+		printf("%5dx%-4d %10.2f %10.2f %10.2f %10.2f %10.2f %10.3f\n",
+			size, size, jpsMediumTime, jpsPlusMediumTime, jpsLongTime, jpsPlusLongTime, buildTime, updateTime);
+	}
+
+	printf("\n");
+}
+
+// 맵 하나를 공유하는 PathFindService를 여러 스레드에서 동시에 호출했을 때의 처리량
+// 스레드마다 같은 쿼리 목록을 나눠서 수행하고, 결과가 단일 스레드 JPSPathFinder와 같은지도 확인한다
+static void benchService(void)
+{
+	const int MAP_SIZE = 500;
+	const int THREAD_COUNTS[] = { 1, 2, 4, 8 };
+	const int QUERY_COUNT = 4000;
+
+	TestMap map(MAP_SIZE, MAP_SIZE, 0.2, 1234);
+
+	PathFindMap sharedMap(MAP_SIZE, MAP_SIZE);
+	map.ApplyTo(sharedMap);
+
+	std::vector<Query> queries = makeQueries(map, QUERY_COUNT, 30, 120, 4);
+
+	// 기준 결과
+	JPSPathFinder reference(sharedMap);
+	std::vector<Path> expected;
+
+	for (const Query& query : queries)
+	{
+		reference.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+		expected.push_back(reference.GetPoints());
+	}
+
+	printf("[service] %d queries on a shared %dx%d map\n", QUERY_COUNT, MAP_SIZE, MAP_SIZE);
+	printf("%10s %14s %14s %10s\n", "threads", "queries/sec", "path finders", "mismatch");
+
+	for (int threadCount : THREAD_COUNTS)
+	{
+		PathFindService service(sharedMap);
+		std::vector<std::thread> threads;
+		std::vector<int> mismatchCounts(threadCount, 0);
+
+		auto begin = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back([&, i]()
+				{
+					Path points;
+
+					for (int j = i; j < QUERY_COUNT; j += threadCount)
+					{
+						const Query& query = queries[j];
+						service.PathFind(query.StartX, query.StartY, query.EndX, query.EndY, points);
+
+						if (isSamePoints(points, expected[j]) == false)
+						{
+							mismatchCounts[i]++;
+						}
+					}
+				});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		auto end = std::chrono::steady_clock::now();
+
+		int mismatchCount = 0;
+
+		for (int count : mismatchCounts)
+		{
+			mismatchCount += count;
+		}
+
+		double seconds = std::chrono::duration<double>(end - begin).count();
+
+		printf("%10d %14.0f %14d %10d\n", threadCount, QUERY_COUNT / seconds, service.GetPathFinderCount(), mismatchCount);
+	}
+
+	printf("\n");
+}
+
+// 비동기 요청 파이프라인
+// 요청자마다 여러 번 연속으로 클릭(요청)하고, 업데이트 스레드처럼 20ms 틱마다 예산을 채우며 결과를 가져온다
+// 틱 당 확장 노드 수가 예산 근처로 유지되는지, 요청자마다 마지막 요청의 결과만 전달되는지 확인한다
+static void benchAsync(void)
+{
+	const int MAP_SIZE = 500;
+	const int REQUESTER_COUNT = 300;
+	const int CLICK_COUNT_PER_REQUESTER = 4;
+	const int THREAD_COUNT = 2;
+	const int EXPAND_BUDGETS[] = { 0, 20'000, 5'000 };
+	const auto TICK = std::chrono::milliseconds(20);
+
+	TestMap map(MAP_SIZE, MAP_SIZE, 0.2, 1234);
+
+	PathFindMap sharedMap(MAP_SIZE, MAP_SIZE);
+	map.ApplyTo(sharedMap);
+
+	std::vector<Query> queries = makeQueries(map, REQUESTER_COUNT * CLICK_COUNT_PER_REQUESTER, 30, 200, 5);
+
+	// 요청자 i의 마지막 요청에 대한 기준 결과
+	JPSPathFinder reference(sharedMap);
+	std::vector<Path> expected(REQUESTER_COUNT);
+
+	for (int i = 0; i < REQUESTER_COUNT; ++i)
+	{
+		const Query& query = queries[(CLICK_COUNT_PER_REQUESTER - 1) * REQUESTER_COUNT + i];
+		reference.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+		expected[i] = reference.GetPoints();
+	}
+
+	printf("[async] %d requesters x %d clicks, %d threads, 20ms ticks\n", REQUESTER_COUNT, CLICK_COUNT_PER_REQUESTER, THREAD_COUNT);
+	printf("%10s %8s %14s %10s %10s %10s %10s %10s\n", "budget", "ticks", "max expand/t", "delivered", "cancelled", "wait ms", "search ms", "mismatch");
+
+	for (int budget : EXPAND_BUDGETS)
+	{
+		PathFindService service(sharedMap);
+		service.Start(THREAD_COUNT, budget);
+
+		// 앞쪽 요청자의 첫 클릭이 다음 클릭 전에 끝나서 결과가 두 번 나오지 않도록 다 넣은 뒤에 찾기 시작한다
+		service.Pause();
+
+		for (int click = 0; click < CLICK_COUNT_PER_REQUESTER; ++click)
+		{
+			for (int i = 0; i < REQUESTER_COUNT; ++i)
+			{
+				const Query& query = queries[click * REQUESTER_COUNT + i];
+				service.Submit(i, query.StartX, query.StartY, query.EndX, query.EndY);
+			}
+		}
+
+		service.Resume();
+
+		std::vector<PathFindService::Result> results;
+		uint64_t lastExpandedNodeCount = 0;
+		uint64_t maxExpandedPerTick = 0;
+		int tickCount = 0;
+
+		while ((int)results.size() < REQUESTER_COUNT)
+		{
+			std::this_thread::sleep_for(TICK);
+
+			service.OnTick();
+			service.TakeResults(results);
+			tickCount++;
+
+			uint64_t expandedNodeCount = service.GetStatistics().ExpandedNodeCount;
+
+			if (expandedNodeCount - lastExpandedNodeCount > maxExpandedPerTick)
+			{
+				maxExpandedPerTick = expandedNodeCount - lastExpandedNodeCount;
+			}
+
+			lastExpandedNodeCount = expandedNodeCount;
+		}
+
+		service.Stop();
+
+		PathFindService::Statistics statistics = service.GetStatistics();
+		int mismatchCount = 0;
+
+		for (const PathFindService::Result& result : results)
+		{
+			if (isSamePoints(result.Points, expected[result.RequesterID]) == false)
+			{
+				mismatchCount++;
+			}
+		}
+
+		printf("%10d %8d %14llu %10llu %10llu %10.3f %10.3f %10d\n",
+			budget, tickCount, (unsigned long long)maxExpandedPerTick,
+			(unsigned long long)statistics.CompletedCount, (unsigned long long)statistics.CancelledCount,
+			statistics.WaitMicroseconds / 1000.0 / statistics.StartedCount,
+			statistics.SearchMicroseconds / 1000.0 / statistics.StartedCount,
+			mismatchCount);
+	}
+
+	printf("\n");
+}
+
+// 클릭 기록 (한 줄에 "시작X 시작Y 도착X 도착Y")
+// 인자로 파일을 주지 않으면, 부하 테스트처럼 봇들이 몇 개의 인기 지점 사이를 오가는 기록을 만들어 사용한다
+static const char* g_traceFileName = nullptr;
+
+static std::vector<Query> loadClickTrace(const char* fileName)
+{
+	std::vector<Query> trace;
+	FILE* file = fopen(fileName, "r");
+
+	if (file == nullptr)
+	{
+		return trace;
+	}
+
+	Query query;
+
+	while (fscanf(file, "%d %d %d %d", &query.StartX, &query.StartY, &query.EndX, &query.EndY) == 4)
+	{
+		trace.push_back(query);
+	}
+
+	fclose(file);
+
+	return trace;
+}
+
+static std::vector<Query> makeClickTrace(const TestMap& map, int botCount, int hotSpotCount, int clickCount, double hotSpotRatio, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<int> randomX(0, map.Width - 1);
+	std::uniform_int_distribution<int> randomY(0, map.Height - 1);
+	std::uniform_real_distribution<double> randomRatio(0.0, 1.0);
+
+	// 모든 지점은 같은 연결 요소 안에서 고른다
+	auto randomCell = [&](int component)
+		{
+			while (true)
+			{
+				Point cell{ randomX(random), randomY(random) };
+
+				if (map.IsWalkable(cell.X, cell.Y) && (component < 0 || map.Component[cell.Y * map.Width + cell.X] == component))
+				{
+					return cell;
+				}
+			}
+		};
+
+	Point first = randomCell(-1);
+	int component = map.Component[first.Y * map.Width + first.X];
+
+	std::vector<Point> hotSpots;
+
+	for (int i = 0; i < hotSpotCount; ++i)
+	{
+		hotSpots.push_back(randomCell(component));
+	}
+
+	// 봇은 이전에 클릭한 지점에서 다음 클릭을 시작한다
+	std::vector<Point> bots;
+
+	for (int i = 0; i < botCount; ++i)
+	{
+		bots.push_back(hotSpots[i % hotSpotCount]);
+	}
+
+	std::uniform_int_distribution<int> randomBot(0, botCount - 1);
+	std::uniform_int_distribution<int> randomHotSpot(0, hotSpotCount - 1);
+
+	std::vector<Query> trace;
+
+	while ((int)trace.size() < clickCount)
+	{
+		Point& bot = bots[randomBot(random)];
+		Point goal = randomRatio(random) < hotSpotRatio ? hotSpots[randomHotSpot(random)] : randomCell(component);
+
+		if (goal.X == bot.X && goal.Y == bot.Y)
+		{
+			continue;
+		}
+
+		trace.push_back(Query{ bot.X, bot.Y, goal.X, goal.Y });
+		bot = goal;
+	}
+
+	return trace;
+}
+
+// 클릭 기록을 캐시를 끄고 켠 PathFindService로 각각 재생한다
+// 중간중간 맵을 바꿔서 (맵 버전 증가) 이전 맵의 경로가 쓰이지 않는지도 같이 확인한다
+static void benchCache(void)
+{
+	const int MAP_SIZE = 500;
+	const int CACHE_CAPACITY = 4096;
+	const int CLICK_COUNT_PER_EDIT = 2000;
+
+	TestMap map(MAP_SIZE, MAP_SIZE, 0.2, 1234);
+
+	std::vector<Query> trace;
+
+	if (g_traceFileName != nullptr)
+	{
+		trace = loadClickTrace(g_traceFileName);
+		printf("[cache] trace %s: %d clicks\n", g_traceFileName, (int)trace.size());
+	}
+	else
+	{
+		trace = makeClickTrace(map, 500, 16, 20000, 0.9, 6);
+		printf("[cache] synthetic trace: 500 bots, 16 hot spots, %d clicks\n", (int)trace.size());
+	}
+
+	printf("%10s %12s %10s %10s %10s\n", "cache", "us/click", "hit", "miss", "mismatch");
+
+	std::vector<Path> expected;
+
+	for (int capacity : { 0, CACHE_CAPACITY })
+	{
+		PathFindMap sharedMap(MAP_SIZE, MAP_SIZE);
+		map.ApplyTo(sharedMap);
+
+		PathFindService service(sharedMap);
+
+		if (capacity > 0)
+		{
+			service.EnablePathCache(capacity);
+		}
+
+		std::mt19937 random(8);
+		std::uniform_int_distribution<int> randomPosition(0, MAP_SIZE - 1);
+		Path points;
+		int mismatchCount = 0;
+		double totalMicroseconds = 0.0;
+
+		for (int i = 0; i < (int)trace.size(); ++i)
+		{
+			// 두 번의 재생 모두 같은 순서로 같은 칸을 바꾼다
+			if (i % CLICK_COUNT_PER_EDIT == CLICK_COUNT_PER_EDIT - 1)
+			{
+				int x = randomPosition(random);
+				int y = randomPosition(random);
+
+				if (sharedMap.IsBlocked(x, y))
+				{
+					sharedMap.UnBlock(x, y);
+				}
+				else
+				{
+					sharedMap.Block(x, y);
+				}
+			}
+
+			const Query& query = trace[i];
+
+			auto begin = std::chrono::steady_clock::now();
+			service.PathFind(query.StartX, query.StartY, query.EndX, query.EndY, points);
+			auto end = std::chrono::steady_clock::now();
+
+			totalMicroseconds += std::chrono::duration<double, std::micro>(end - begin).count();
+
+			if (capacity == 0)
+			{
+				expected.push_back(points);
+			}
+			else if (isSamePoints(points, expected[i]) == false)
+			{
+				mismatchCount++;
+			}
+		}
+
+		PathFindService::Statistics statistics = service.GetStatistics();
+
+		printf("%10d %12.2f %10llu %10llu %10d\n", capacity, totalMicroseconds / trace.size(),
+			(unsigned long long)statistics.CacheHitCount, (unsigned long long)statistics.CacheMissCount, mismatchCount);
+	}
+
+	printf("\n");
+}
+
+// 평면 JPS와 HPA*의 쿼리 당 소요 시간, 탐색에 쓰는 메모리, 경로 비용 비교
+// HPA*는 추상 그래프 생성 시간과 칸 하나 변경 시 부분 갱신 비용도 같이 잰다
+static void benchHierarchical(void)
+{
+	const int MAP_SIZES[] = { 200, 1000, 2000 };
+	const double OBSTACLE_RATIO = 0.2;
+	const int EDIT_COUNT = 200;
+
+	printf("[hpa] per-query time (us) for medium / long paths, reserved memory (KB) excluding the map, HPA* cost / JPS cost\n");
+	printf("%10s %10s %10s %10s %10s %10s %10s %8s %10s %10s %8s\n",
+		"map", "JPS mid", "HPA mid", "JPS long", "HPA long", "JPS KB", "HPA KB", "cost", "build ms", "update ms", "failed");
+
+	for (int size : MAP_SIZES)
+	{
+		TestMap map(size, size, OBSTACLE_RATIO, 1234);
+
+		PathFindMap flatMap(size, size);
+		PathFindMap hierarchicalMap(size, size);
+		map.ApplyTo(flatMap);
+		map.ApplyTo(hierarchicalMap);
+
+		JPSPathFinder jps(flatMap);
+
+		auto buildBegin = std::chrono::steady_clock::now();
+		HPAPathFinder hpa(hierarchicalMap);
+		auto buildEnd = std::chrono::steady_clock::now();
+
+		std::vector<Query> mediumQueries = makeQueries(map, 500, 30, 60, 2);
+		std::vector<Query> longQueries = makeQueries(map, 50, size / 2, size - 1, 3);
+
+		double jpsMediumTime = measurePerQueryMicroseconds(jps, mediumQueries);
+		double hpaMediumTime = measurePerQueryMicroseconds(hpa, mediumQueries);
+		double jpsLongTime = measurePerQueryMicroseconds(jps, longQueries);
+		double hpaLongTime = measurePerQueryMicroseconds(hpa, longQueries);
+
+		// 같은 칸을 막았다가 다시 뚫어서 맵은 그대로 둔다
+		std::mt19937 random(5);
+		std::uniform_int_distribution<int> randomPosition(0, size - 1);
+
+		auto updateBegin = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < EDIT_COUNT; ++i)
+		{
+			int x = randomPosition(random);
+			int y = randomPosition(random);
+
+			if (map.IsWalkable(x, y))
+			{
+				hpa.Block(x, y);
+				hpa.UnBlock(x, y);
+			}
+		}
+
+		auto updateEnd = std::chrono::steady_clock::now();
+
+		// 연결된 쿼리만 뽑았으므로 둘 다 경로를 찾아야 한다
+		long long jpsCost = 0;
+		long long hpaCost = 0;
+		int failCount = 0;
+
+		for (const Query& query : longQueries)
+		{
+			jps.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			hpa.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+
+			if (jps.GetPathCost() == -1 || hpa.GetPathCost() == -1)
+			{
+				failCount++;
+				continue;
+			}
+
+			jpsCost += jps.GetPathCost();
+			hpaCost += hpa.GetPathCost();
+		}
+
+		double buildTime = std::chrono::duration<double, std::milli>(buildEnd - buildBegin).count();
+		double updateTime = std::chrono::duration<double, std::milli>(updateEnd - updateBegin).count() / (EDIT_COUNT * 2);
+
+		printf("%5dx%-4d %10.2f %10.2f %10.2f %10.2f %10zu %10zu %8.3f %10.2f %10.3f %8d\n",
+			size, size, jpsMediumTime, hpaMediumTime, jpsLongTime, hpaLongTime,
+			jps.GetReservedBytes() / 1024, hpa.GetReservedBytes() / 1024,
+			jpsCost > 0 ? (double)hpaCost / jpsCost : 0.0, buildTime, updateTime, failCount);
+	}
+
+	printf("\n");
+}
+
+// 쿼리들을 batch 크기만큼씩 묶어서 찾을 때의 처리량 (queries/sec)
+// 개별 호출(PathFind + GetPoints)과 JPSPathFinder::PathFindBatch(), 스레드로 나누는 PathFindService::PathFindBatch()를 비교한다
+static void benchBatch(void)
+{
+	const int MAP_SIZE = 500;
+	const int QUERY_COUNT = 16384;
+	const int BATCH_SIZES[] = { 1, 8, 64, 512, 4096 };
+	const int THREAD_COUNTS[] = { 2, 4 };
+
+	TestMap map(MAP_SIZE, MAP_SIZE, 0.2, 1234);
+
+	PathFindMap sharedMap(MAP_SIZE, MAP_SIZE);
+	map.ApplyTo(sharedMap);
+
+	std::vector<JPSPathFinder::Query> queries;
+
+	for (const Query& query : makeQueries(map, QUERY_COUNT, 2, 30, 9))
+	{
+		queries.push_back(JPSPathFinder::Query{ query.StartX, query.StartY, query.EndX, query.EndY });
+	}
+
+	JPSPathFinder pathFinder(sharedMap);
+	PathFindService service(sharedMap);
+
+	// 개별 호출 결과 (비교용)
+	std::vector<int> expectedCosts;
+
+	for (const JPSPathFinder::Query& query : queries)
+	{
+		pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+		expectedCosts.push_back(pathFinder.GetPathCost());
+	}
+
+	printf("[batch] %dx%d map, %d queries, throughput (queries/sec)\n", MAP_SIZE, MAP_SIZE, QUERY_COUNT);
+	printf("%10s %12s %12s %12s %12s %10s\n", "batch", "PathFind", "batch", "2 threads", "4 threads", "mismatch");
+
+	std::vector<JPSPathFinder::BatchResult> results(QUERY_COUNT);
+	std::vector<Point> points;
+
+	for (int batchSize : BATCH_SIZES)
+	{
+		int mismatchCount = 0;
+
+		// 개별 호출 (서비스의 동기 호출처럼 결과를 복사)
+		auto begin = std::chrono::steady_clock::now();
+
+		for (const JPSPathFinder::Query& query : queries)
+		{
+			pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			Path copied = pathFinder.GetPoints();
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		double singleSeconds = std::chrono::duration<double>(end - begin).count();
+
+		// 일괄 호출 (스레드 수 1, 2, 4)
+		double batchSeconds[3];
+		int threadCounts[3] = { 1, THREAD_COUNTS[0], THREAD_COUNTS[1] };
+
+		for (int t = 0; t < 3; ++t)
+		{
+			begin = std::chrono::steady_clock::now();
+
+			for (int offset = 0; offset < QUERY_COUNT; offset += batchSize)
+			{
+				int count = std::min(batchSize, QUERY_COUNT - offset);
+				points.clear();
+
+				if (threadCounts[t] == 1)
+				{
+					pathFinder.PathFindBatch(queries.data() + offset, count, results.data() + offset, points);
+				}
+				else
+				{
+					service.PathFindBatch(queries.data() + offset, count, results.data() + offset, points, threadCounts[t]);
+				}
+
+				for (int i = offset; i < offset + count; ++i)
+				{
+					const JPSPathFinder::BatchResult& result = results[i];
+
+					if (result.PathCost != expectedCosts[i] || (result.PointCount > 0) != (result.PathCost != -1)
+						|| result.PointOffset + result.PointCount > (int)points.size())
+					{
+						mismatchCount++;
+					}
+				}
+			}
+
+			end = std::chrono::steady_clock::now();
+			batchSeconds[t] = std::chrono::duration<double>(end - begin).count();
+		}
+
+		printf("%10d %12.0f %12.0f %12.0f %12.0f %10d\n", batchSize, QUERY_COUNT / singleSeconds,
+			QUERY_COUNT / batchSeconds[0], QUERY_COUNT / batchSeconds[1], QUERY_COUNT / batchSeconds[2], mismatchCount);
+	}
+
+	printf("\n");
+}
+
+// CS_MOVE 한 번을 처리하는 동안의 힙 할당 횟수
+// 서버와 같은 흐름(Submit -> 길찾기 스레드 -> TakeResults -> 플레이어의 목적지 목록 -> SC_PATH_FIND 작성)을 재현한다
+// "std::list"는 이전 방식처럼 탐색 결과, GetPoints() 복사본, 플레이어의 목적지 목록을 std::list로 만들었을 때의 횟수
+// 탐색 자체(JPSPathFinder::PathFind)의 할당은 같은 쿼리를 따로 찾아서 세고, 나머지와 나눠서 보여준다
+static void benchAllocation(void)
+{
+	const int MAP_SIZE = 500;
+	const int REQUESTER_COUNT = 100;
+	const int MOVE_COUNT = 2000;
+	const int WARM_UP_COUNT = 200;
+
+	TestMap map(MAP_SIZE, MAP_SIZE, 0.2, 1234);
+
+	PathFindMap sharedMap(MAP_SIZE, MAP_SIZE);
+	map.ApplyTo(sharedMap);
+
+	std::vector<Query> queries = makeQueries(map, WARM_UP_COUNT + MOVE_COUNT, 10, 100, 11);
+
+	printf("[alloc] heap allocations per CS_MOVE (%d moves, 1 path find thread)\n", MOVE_COUNT);
+	printf("%12s %12s %12s %12s %12s\n", "path", "alloc/move", "search", "other", "points/move");
+
+	JPSPathFinder reference(sharedMap);
+
+	for (bool bList : { true, false })
+	{
+		PathFindService service(sharedMap);
+		service.Start(1, 0);
+
+		std::vector<PathFindService::Result> results;
+		std::vector<Path> destPositions(REQUESTER_COUNT);
+		std::vector<std::list<Point>> destPositionLists(REQUESTER_COUNT);
+		std::vector<char> packet;
+		packet.reserve(4096);
+		results.reserve(16);
+
+		uint64_t allocationCount = 0;
+		uint64_t searchAllocationCount = 0;
+		uint64_t pointCount = 0;
+
+		for (int i = 0; i < WARM_UP_COUNT + MOVE_COUNT; ++i)
+		{
+			const Query& query = queries[i];
+			const uint64_t requesterID = i % REQUESTER_COUNT;
+
+			uint64_t searchBefore = g_allocationCount.load();
+			reference.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			uint64_t searchAfter = g_allocationCount.load();
+
+			uint64_t before = g_allocationCount.load();
+
+			service.Submit(requesterID, query.StartX, query.StartY, query.EndX, query.EndY);
+
+			while (results.empty())
+			{
+				std::this_thread::yield();
+				service.TakeResults(results);
+			}
+
+			const Path& points = results[0].Points;
+
+			if (bList)
+			{
+				// 탐색 결과(push_front), GetPoints() 복사본, 플레이어의 목록
+				std::list<Point> found;
+
+				for (int j = points.Size() - 1; j >= 0; --j)
+				{
+					found.push_front(points[j]);
+				}
+
+				std::list<Point> copied = found;
+				std::list<Point>& player = destPositionLists[requesterID];
+
+				for (auto it = std::next(copied.begin()); it != copied.end(); ++it)
+				{
+					player.push_back(*it);
+				}
+
+				packet.clear();
+
+				for (const Point& point : copied)
+				{
+					packet.insert(packet.end(), (const char*)&point, (const char*)&point + sizeof(Point));
+				}
+			}
+			else
+			{
+				Path& player = destPositions[requesterID];
+
+				for (const Point* it = points.Begin() + 1; it < points.End(); ++it)
+				{
+					player.PushBack(*it);
+				}
+
+				packet.clear();
+
+				for (const Point& point : points)
+				{
+					packet.insert(packet.end(), (const char*)&point, (const char*)&point + sizeof(Point));
+				}
+			}
+
+			uint64_t after = g_allocationCount.load();
+
+			if (i >= WARM_UP_COUNT)
+			{
+				allocationCount += after - before;
+				searchAllocationCount += searchAfter - searchBefore;
+				pointCount += points.Size();
+			}
+
+			results.clear();
+
+			// 다음 요청 전에 도착한 것으로 치고 목적지를 모두 소비한다
+			while (destPositions[requesterID].Empty() == false)
+			{
+				destPositions[requesterID].PopFront();
+			}
+
+			destPositionLists[requesterID].clear();
+		}
+
+		service.Stop();
+
+		printf("%12s %12.2f %12.2f %12.2f %12.2f\n", bList ? "std::list" : "Path",
+			(double)allocationCount / MOVE_COUNT, (double)searchAllocationCount / MOVE_COUNT,
+			(double)(allocationCount - searchAllocationCount) / MOVE_COUNT, (double)pointCount / MOVE_COUNT);
+	}
+
+	printf("\n");
+}
+
+// 경로 다듬기(canIgnore)의 직선 검사 비용
+// 이전 방식(Line으로 모든 칸을 만든 뒤 검사)과 LineOfSight의 한 칸씩 검사, 비트 맵 구간 검사를 직선 길이 별로 비교한다
+// 기울기는 짧은 축 / 긴 축이 1 이하(전체)인 직선과 1/8 이하(가로, 세로에 가까운)인 직선을 나눠서 잰다
+// 세 방식의 결과가 모두 같은지, 검사 한 번 당 힙 할당 횟수도 같이 확인한다
+static void benchLineOfSight(void)
+{
+	enum
+	{
+		MAP_SIZE = 2000,
+		CHECK_COUNT = 200000,
+	};
+
+	const int LENGTHS[] = { 8, 64, 512 };
+	const double OBSTACLE_RATIOS[] = { 0.001, 0.05 };
+	const int SLOPE_DIVISORS[] = { 1, 8 };
+
+	printf("[line-of-sight] %dx%d, %d checks per row\n", MAP_SIZE, MAP_SIZE, CHECK_COUNT);
+	printf("%10s %8s %8s %10s %14s %14s %14s %12s %10s\n", "obstacles", "slope", "length", "clear", "Line (ns)", "scalar (ns)", "bitgrid (ns)", "Line alloc", "mismatch");
+
+	for (double obstacleRatio : OBSTACLE_RATIOS)
+	{
+		TestMap testMap(MAP_SIZE, MAP_SIZE, obstacleRatio, 12);
+		PathFindMap map(MAP_SIZE, MAP_SIZE);
+		testMap.ApplyTo(map);
+
+		const BitGrid& grid = map.GetGrid();
+
+		for (int slopeDivisor : SLOPE_DIVISORS)
+		for (int length : LENGTHS)
+		{
+			std::mt19937 random(length);
+			std::uniform_int_distribution<int> position(0, MAP_SIZE - 1);
+			std::uniform_int_distribution<int> offset(-length / slopeDivisor, length / slopeDivisor);
+
+			std::vector<Query> checks;
+			checks.reserve(CHECK_COUNT);
+
+			while ((int)checks.size() < CHECK_COUNT)
+			{
+				int startX = position(random);
+				int startY = position(random);
+				int endX = startX + offset(random);
+				int endY = startY + (random() % 2 == 0 ? length : -length);
+
+				if (random() % 2 == 0)
+				{
+					std::swap(endX, endY);
+					endX = startX + (endX - startY);
+					endY = startY + (endY - startX);
+				}
+
+				if (endX < 0 || endX >= MAP_SIZE || endY < 0 || endY >= MAP_SIZE)
+				{
+					continue;
+				}
+
+				checks.push_back(Query{ startX, startY, endX, endY });
+			}
+
+			std::vector<char> lineResults(CHECK_COUNT);
+			std::vector<char> scalarResults(CHECK_COUNT);
+			std::vector<char> bitGridResults(CHECK_COUNT);
+
+			uint64_t allocationBefore = g_allocationCount.load();
+			auto lineBegin = std::chrono::high_resolution_clock::now();
+
+			for (int i = 0; i < CHECK_COUNT; ++i)
+			{
+				const Query& check = checks[i];
+				Line line(check.StartX, check.StartY, check.EndX, check.EndY);
+
+				bool bClear = true;
+
+				for (auto it = line.Begin(); it != line.End(); ++it)
+				{
+					if (grid.IsWalkable((*it).X, (*it).Y) == false)
+					{
+						bClear = false;
+						break;
+					}
+				}
+
+				lineResults[i] = bClear;
+			}
+
+			auto lineEnd = std::chrono::high_resolution_clock::now();
+			uint64_t allocationAfter = g_allocationCount.load();
+
+			for (int i = 0; i < CHECK_COUNT; ++i)
+			{
+				const Query& check = checks[i];
+				scalarResults[i] = LineOfSight::IsClear(check.StartX, check.StartY, check.EndX, check.EndY,
+					[&grid](int x, int y) { return grid.IsWalkable(x, y); });
+			}
+
+			auto scalarEnd = std::chrono::high_resolution_clock::now();
+
+			for (int i = 0; i < CHECK_COUNT; ++i)
+			{
+				const Query& check = checks[i];
+				bitGridResults[i] = LineOfSight::IsClear(grid, check.StartX, check.StartY, check.EndX, check.EndY);
+			}
+
+			auto bitGridEnd = std::chrono::high_resolution_clock::now();
+
+			int clearCount = 0;
+			int mismatchCount = 0;
+
+			for (int i = 0; i < CHECK_COUNT; ++i)
+			{
+				clearCount += lineResults[i];
+
+				if (lineResults[i] != scalarResults[i] || lineResults[i] != bitGridResults[i])
+				{
+					mismatchCount++;
+				}
+			}
+
+			double lineNanoseconds = std::chrono::duration<double, std::nano>(lineEnd - lineBegin).count() / CHECK_COUNT;
+			double scalarNanoseconds = std::chrono::duration<double, std::nano>(scalarEnd - lineEnd).count() / CHECK_COUNT;
+			double bitGridNanoseconds = std::chrono::duration<double, std::nano>(bitGridEnd - scalarEnd).count() / CHECK_COUNT;
+
+			printf("%10.3f %6s%-2d %8d %9.1f%% %14.1f %14.1f %14.1f %12.1f %10d\n", obstacleRatio, "1/", slopeDivisor, length, 100.0 * clearCount / CHECK_COUNT,
+				lineNanoseconds, scalarNanoseconds, bitGridNanoseconds, (double)(allocationAfter - allocationBefore) / CHECK_COUNT, mismatchCount);
+		}
+	}
+
+	printf("\n");
+}
+
+// 경로의 유클리드 길이 (칸 단위)
+static double getPathLength(const Path& points)
+{
+	double length = 0.0;
+
+	for (int i = 1; i < points.Size(); ++i)
+	{
+		double dx = points[i].X - points[i - 1].X;
+		double dy = points[i].Y - points[i - 1].Y;
+		length += sqrt(dx * dx + dy * dy);
+	}
+
+	return length;
+}
+
+// JPS + reduceNodes()와 Lazy Theta*의 쿼리 당 소요 시간, 확장 노드 수, 경로 길이(유클리드) 비교
+// Lazy Theta* 경로의 모든 구간이 직선으로 이어지는지(LineOfSight), 두 방식의 도달 가능 여부가 같은지도 확인한다
+static void benchLazyTheta(void)
+{
+	const int MAP_SIZES[] = { 200, 1000 };
+	const double OBSTACLE_RATIOS[] = { 0.1, 0.2, 0.3 };
+	const int QUERY_COUNT = 300;
+
+	printf("[theta] JPS + reduceNodes vs Lazy Theta*, %d queries per map (chebyshev distance 30 ~ 120)\n", QUERY_COUNT);
+	printf("%10s %10s %10s %10s %12s %12s %10s %10s %8s %8s\n",
+		"map", "obstacles", "JPS us", "Theta us", "JPS expand", "Theta expand", "JPS len", "Theta len", "invalid", "failed");
+
+	for (int size : MAP_SIZES)
+	{
+		for (double obstacleRatio : OBSTACLE_RATIOS)
+		{
+			TestMap map(size, size, obstacleRatio, 77);
+
+			PathFindMap pathFindMap(size, size);
+			map.ApplyTo(pathFindMap);
+
+			JPSPathFinder jps(pathFindMap);
+			JPSPathFinder theta(pathFindMap);
+			theta.SetSearchMode(JPSPathFinder::LazyThetaStar);
+
+			std::vector<Query> queries = makeQueries(map, QUERY_COUNT, 30, 120, 8);
+
+			double jpsTime = measurePerQueryMicroseconds(jps, queries);
+			double thetaTime = measurePerQueryMicroseconds(theta, queries);
+
+			long long jpsExpandCount = 0;
+			long long thetaExpandCount = 0;
+			double jpsLength = 0.0;
+			double thetaLength = 0.0;
+			int invalidCount = 0;
+			int failCount = 0;
+
+			for (const Query& query : queries)
+			{
+				jps.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+				theta.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+
+				if (jps.GetPathCost() == -1 || theta.GetPathCost() == -1)
+				{
+					failCount++;
+					continue;
+				}
+
+				jpsExpandCount += jps.GetExpandedNodeCount();
+				thetaExpandCount += theta.GetExpandedNodeCount();
+				jpsLength += getPathLength(jps.GetPoints());
+				thetaLength += getPathLength(theta.GetPoints());
+
+				const Path& points = theta.GetPoints();
+
+				for (int i = 1; i < points.Size(); ++i)
+				{
+					if (LineOfSight::IsClear(pathFindMap.GetGrid(), points[i].X, points[i].Y, points[i - 1].X, points[i - 1].Y) == false)
+					{
+						invalidCount++;
+						break;
+					}
+				}
+			}
+
+			printf("%5dx%-4d %10.2f %10.2f %10.2f %12.1f %12.1f %10.2f %10.2f %8d %8d\n",
+				size, size, obstacleRatio, jpsTime, thetaTime,
+				(double)jpsExpandCount / QUERY_COUNT, (double)thetaExpandCount / QUERY_COUNT,
+				jpsLength / QUERY_COUNT, thetaLength / QUERY_COUNT, invalidCount, failCount);
+		}
+	}
+
+	printf("\n");
+}
+
+// 연결 요소로 닿을 수 없는 쿼리를 거절할 때의 효과
+// 시작 칸과 도착 칸이 서로 다른 연결 요소인 쿼리(막힌 영역 안을 클릭한 경우)를 연결 요소를 끄고 켠 JPS로 각각 수행한다
+// 칸을 무작위로 막고 뚫으면서 주기적으로 RefreshComponents()를 호출하고, 매번 처음부터 계산한 연결 요소와 비교한다
+// (실제로 이어진 두 칸은 항상 같은 연결 요소여야 하고, Refresh 직후에는 완전히 같아야 한다)
+static void benchComponents(void)
+{
+	const int MAP_SIZES[] = { 200, 1000 };
+	const double OBSTACLE_RATIO = 0.3;
+	const int QUERY_COUNT = 200;
+	const int EDIT_COUNT = 2000;
+	const int REFRESH_INTERVAL = 100;
+	const int CHECK_COUNT = 2000;
+
+	printf("[components] unreachable queries (start and goal in different components), obstacles %.2f\n", OBSTACLE_RATIO);
+	printf("%10s %12s %12s %10s %10s %10s %12s %10s %8s\n",
+		"map", "search us", "reject us", "rejected", "build ms", "update us", "refresh ms", "KB", "wrong");
+
+	for (int size : MAP_SIZES)
+	{
+		TestMap map(size, size, OBSTACLE_RATIO, 99);
+
+		// 가장 큰 연결 요소에서 출발해 다른 연결 요소로 가는 쿼리
+		std::vector<int> componentSizes;
+
+		for (int component : map.Component)
+		{
+			if (component >= (int)componentSizes.size())
+			{
+				componentSizes.resize(component + 1, 0);
+			}
+
+			if (component >= 0)
+			{
+				componentSizes[component]++;
+			}
+		}
+
+		int largest = (int)(std::max_element(componentSizes.begin(), componentSizes.end()) - componentSizes.begin());
+
+		std::mt19937 random(size);
+		std::uniform_int_distribution<int> randomPosition(0, size - 1);
+		std::vector<Query> queries;
+
+		while ((int)queries.size() < QUERY_COUNT)
+		{
+			int startX = randomPosition(random);
+			int startY = randomPosition(random);
+			int endX = randomPosition(random);
+			int endY = randomPosition(random);
+
+			int startComponent = map.Component[startY * size + startX];
+			int endComponent = map.Component[endY * size + endX];
+
+			if (startComponent == largest && endComponent >= 0 && endComponent != largest)
+			{
+				queries.push_back(Query{ startX, startY, endX, endY });
+			}
+		}
+
+		PathFindMap pathFindMap(size, size);
+		map.ApplyTo(pathFindMap);
+
+		JPSPathFinder pathFinder(pathFindMap);
+
+		double searchTime = measurePerQueryMicroseconds(pathFinder, queries);
+
+		auto buildBegin = std::chrono::steady_clock::now();
+		pathFindMap.EnableComponents();
+		auto buildEnd = std::chrono::steady_clock::now();
+
+		double rejectTime = measurePerQueryMicroseconds(pathFinder, queries);
+
+		int rejectedCount = 0;
+
+		for (const Query& query : queries)
+		{
+			pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			rejectedCount += pathFinder.IsRejected() ? 1 : 0;
+		}
+
+		// 무작위로 막고 뚫으면서 처음부터 계산한 연결 요소와 비교한다
+		int wrongCount = 0;
+		double updateMicroseconds = 0.0;
+		double refreshMilliseconds = 0.0;
+		int refreshCount = 0;
+
+		for (int edit = 1; edit <= EDIT_COUNT; ++edit)
+		{
+			int x = randomPosition(random);
+			int y = randomPosition(random);
+
+			auto updateBegin = std::chrono::steady_clock::now();
+
+			if (pathFindMap.IsBlocked(x, y))
+			{
+				pathFindMap.UnBlock(x, y);
+			}
+			else
+			{
+				pathFindMap.Block(x, y);
+			}
+
+			auto updateEnd = std::chrono::steady_clock::now();
+			updateMicroseconds += std::chrono::duration<double, std::micro>(updateEnd - updateBegin).count();
+
+			bool bRefreshed = edit % REFRESH_INTERVAL == 0;
+
+			if (bRefreshed)
+			{
+				auto refreshBegin = std::chrono::steady_clock::now();
+				pathFindMap.RefreshComponents();
+				auto refreshEnd = std::chrono::steady_clock::now();
+
+				refreshMilliseconds += std::chrono::duration<double, std::milli>(refreshEnd - refreshBegin).count();
+				refreshCount++;
+			}
+			else if (edit % (REFRESH_INTERVAL / 4) != 0)
+			{
+				continue;
+			}
+
+			TestMap truth(size, size, 0.0, 0);
+
+			for (int cellY = 0; cellY < size; ++cellY)
+			{
+				for (int cellX = 0; cellX < size; ++cellX)
+				{
+					truth.Walkable[cellY * size + cellX] = pathFindMap.IsBlocked(cellX, cellY) == false;
+				}
+			}
+
+			truth.Relabel();
+
+			const ConnectedComponents* components = pathFindMap.GetComponents();
+
+			for (int i = 0; i < CHECK_COUNT; ++i)
+			{
+				int startX = randomPosition(random);
+				int startY = randomPosition(random);
+				int endX = randomPosition(random);
+				int endY = randomPosition(random);
+
+				if (truth.IsWalkable(startX, startY) == false || truth.IsWalkable(endX, endY) == false)
+				{
+					continue;
+				}
+
+				bool bConnected = truth.Component[startY * size + startX] == truth.Component[endY * size + endX];
+				bool bSame = components->IsInSameComponent(startX, startY, endX, endY);
+
+				if ((bConnected && bSame == false) || (bRefreshed && bConnected != bSame))
+				{
+					wrongCount++;
+				}
+			}
+		}
+
+		printf("%5dx%-4d %12.2f %12.2f %6d/%-3d %10.2f %10.3f %12.3f %10zu %8d\n",
+			size, size, searchTime, rejectTime, rejectedCount, QUERY_COUNT,
+			std::chrono::duration<double, std::milli>(buildEnd - buildBegin).count(),
+			updateMicroseconds / EDIT_COUNT, refreshMilliseconds / refreshCount,
+			pathFindMap.GetComponents()->GetReservedBytes() / 1024, wrongCount);
+	}
+
+	printf("\n");
+}
+
+// 같은 목적지로 가는 에이전트 N명의 경로를 구하는 총 CPU 시간
+// 에이전트마다 JPS를 돌리는 경우와, 흐름장을 (캐시에서) 하나만 만들고 모두가 GetPath()로 읽는 경우를 비교한다
+// 범위 제한 흐름장은 목적지 주변 (2 * RADIUS + 1) 칸 안의 에이전트만 사용한다
+// 흐름장의 거리가 JPS 경로 비용과 같은지도 확인한다 (둘 다 최단 경로)
+static void benchFlowField(void)
+{
+	const int MAP_SIZES[] = { 500, 1000 };
+	const int AGENT_COUNTS[] = { 10, 100, 500 };
+	const double OBSTACLE_RATIO = 0.2;
+	const int RADIUS = 100;
+
+	printf("[flow-field] N agents heading to one goal, total ms (obstacles %.2f, bounded radius %d)\n", OBSTACLE_RATIO, RADIUS);
+	printf("%10s %8s %8s %10s %10s %10s %10s %8s %10s\n",
+		"map", "region", "agents", "JPS ms", "build ms", "read ms", "field ms", "speedup", "mismatch");
+
+	for (int size : MAP_SIZES)
+	{
+		TestMap map(size, size, OBSTACLE_RATIO, 31);
+
+		PathFindMap pathFindMap(size, size);
+		map.ApplyTo(pathFindMap);
+
+		JPSPathFinder pathFinder(pathFindMap);
+
+		for (int radius : { 0, RADIUS })
+		{
+			for (int agentCount : AGENT_COUNTS)
+			{
+				// 목적지 하나와, 그 목적지로 갈 수 있는 에이전트들 (범위 제한이면 범위 안에서)
+				std::vector<Query> queries = makeQueries(map, 1, 0, 0, agentCount);
+				const int goalX = queries[0].EndX;
+				const int goalY = queries[0].EndY;
+				const int maxDistance = radius > 0 ? radius : size;
+
+				std::mt19937 random(agentCount);
+				std::uniform_int_distribution<int> randomOffset(-maxDistance, maxDistance);
+				queries.clear();
+
+				while ((int)queries.size() < agentCount)
+				{
+					int startX = goalX + randomOffset(random);
+					int startY = goalY + randomOffset(random);
+
+					if (startX < 0 || startX >= size || startY < 0 || startY >= size || map.IsWalkable(startX, startY) == false)
+					{
+						continue;
+					}
+
+					if (map.Component[startY * size + startX] != map.Component[goalY * size + goalX])
+					{
+						continue;
+					}
+
+					queries.push_back(Query{ startX, startY, goalX, goalY });
+				}
+
+				auto jpsBegin = std::chrono::steady_clock::now();
+
+				std::vector<int> jpsCosts;
+
+				for (const Query& query : queries)
+				{
+					pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+					jpsCosts.push_back(pathFinder.GetPathCost());
+				}
+
+				auto jpsEnd = std::chrono::steady_clock::now();
+
+				// 매번 새 캐시 (흐름장 생성 비용 포함)
+				FlowFieldCache cache(pathFindMap);
+				Path points;
+				int mismatchCount = 0;
+
+				auto buildBegin = std::chrono::steady_clock::now();
+				const FlowField* field = cache.Acquire(goalX, goalY, radius);
+				auto buildEnd = std::chrono::steady_clock::now();
+
+				for (const Query& query : queries)
+				{
+					field->GetPath(query.StartX, query.StartY, points);
+				}
+
+				auto readEnd = std::chrono::steady_clock::now();
+
+				for (int i = 0; i < agentCount; ++i)
+				{
+					// 범위 제한 흐름장은 범위 밖으로 돌아가는 경로를 모르므로 더 길 수 있다
+					int distance = field->GetDistance(queries[i].StartX, queries[i].StartY);
+
+					if (radius == 0 ? distance != jpsCosts[i] : (distance != -1 && distance < jpsCosts[i]))
+					{
+						mismatchCount++;
+					}
+				}
+
+				cache.Release(field);
+
+				double jpsTime = std::chrono::duration<double, std::milli>(jpsEnd - jpsBegin).count();
+				double buildTime = std::chrono::duration<double, std::milli>(buildEnd - buildBegin).count();
+				double readTime = std::chrono::duration<double, std::milli>(readEnd - buildEnd).count();
+
+				printf("%5dx%-4d %8s %8d %10.2f %10.2f %10.3f %10.2f %7.1fx %10d\n",
+					size, size, radius > 0 ? "bounded" : "full", agentCount, jpsTime, buildTime, readTime,
+					buildTime + readTime, jpsTime / (buildTime + readTime), mismatchCount);
+			}
+		}
+	}
+
+	printf("\n");
+}
+
+// 경로의 모든 구간이 직선으로 이어지는가 (뒤쪽 점 -> 앞쪽 점, reduceNodes()와 같은 방향)
+static bool isPathClear(const BitGrid& grid, const Path& points)
+{
+	for (int i = 1; i < points.Size(); ++i)
+	{
+		if (LineOfSight::IsClear(grid, points[i].X, points[i].Y, points[i - 1].X, points[i - 1].Y) == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// 경로 위에서 시작점 쪽부터 ratio 만큼 간 칸 (구간의 브레젠험 칸 기준)
+static Point getPointOnPath(const Path& points, double ratio)
+{
+	std::vector<Point> cells;
+
+	for (int i = 1; i < points.Size(); ++i)
+	{
+		LineOfSight::IsClear(points[i].X, points[i].Y, points[i - 1].X, points[i - 1].Y, [&cells](int x, int y)
+			{
+				cells.push_back(Point{ x, y });
+				return true;
+			});
+	}
+
+	return cells.empty() ? points.Front() : cells[static_cast<size_t>(cells.size() * ratio)];
+}
+
+// 맵이 바뀐 뒤 경로 고치기
+// 1. D* Lite : 첫 웨이포인트까지 이동한 에이전트의 경로 가운데를 5x5로 막고 Replan(), 다시 뚫고 Replan()
+//    처음부터 다시 찾는 D* Lite, JPS와 시간, 확장 노드 수를 비교하고, 비용이 JPS와 같은지 확인한다
+// 2. PathSegmentIndex : 에이전트들의 경로를 넣어두고 무작위 칸을 막았을 때 그 칸을 지나는 경로를 찾는 시간
+//    모든 경로의 구간을 하나씩 검사하는 방식과 비교하고, 찾은 주인이 같은지 확인한다
+static void benchReplan(void)
+{
+	const int MAP_SIZES[] = { 200, 1000 };
+	const double OBSTACLE_RATIO = 0.2;
+	const int TRIAL_COUNT = 30;
+	const int WALL_RADIUS = 2;
+
+	printf("[replan] block 5x5 on the remaining path, then unblock, %d trials per map (obstacles %.2f)\n", TRIAL_COUNT, OBSTACLE_RATIO);
+	printf("%10s %10s %10s %10s %12s %12s %12s %10s %8s\n",
+		"map", "JPS us", "D* new us", "D* fix us", "D* new exp", "D* fix exp", "D* reopen us", "mismatch", "invalid");
+
+	for (int size : MAP_SIZES)
+	{
+		TestMap map(size, size, OBSTACLE_RATIO, 41);
+
+		PathFindMap pathFindMap(size, size);
+		map.ApplyTo(pathFindMap);
+
+		JPSPathFinder jps(pathFindMap);
+		DStarLitePathFinder planner(pathFindMap);
+		DStarLitePathFinder scratch(pathFindMap);
+
+		std::vector<Query> queries = makeQueries(map, TRIAL_COUNT, size / 4, size / 2, 12);
+
+		double jpsTime = 0.0;
+		double scratchTime = 0.0;
+		double repairTime = 0.0;
+		double reopenTime = 0.0;
+		long long scratchExpandCount = 0;
+		long long repairExpandCount = 0;
+		int mismatchCount = 0;
+		int invalidCount = 0;
+
+		for (const Query& query : queries)
+		{
+			planner.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+
+			// 첫 웨이포인트까지 이동한 뒤, 남은 경로의 가운데를 막는다
+			Path remaining = planner.GetPoints();
+			remaining.PopFront();
+
+			const Point current = remaining.Front();
+			const Point center = getPointOnPath(remaining, 0.5);
+			std::vector<Point> wall;
+
+			planner.MoveStart(current.X, current.Y);
+
+			for (int y = center.Y - WALL_RADIUS; y <= center.Y + WALL_RADIUS; ++y)
+			{
+				for (int x = center.X - WALL_RADIUS; x <= center.X + WALL_RADIUS; ++x)
+				{
+					if (pathFindMap.IsBlocked(x, y) || (x == current.X && y == current.Y) || (x == query.EndX && y == query.EndY))
+					{
+						continue;
+					}
+
+					pathFindMap.Block(x, y);
+					wall.push_back(Point{ x, y });
+				}
+			}
+
+			auto jpsBegin = std::chrono::steady_clock::now();
+			jps.PathFind(current.X, current.Y, query.EndX, query.EndY);
+			auto scratchBegin = std::chrono::steady_clock::now();
+			scratch.PathFind(current.X, current.Y, query.EndX, query.EndY);
+			auto repairBegin = std::chrono::steady_clock::now();
+
+			for (const Point& cell : wall)
+			{
+				planner.OnCellChanged(cell.X, cell.Y);
+			}
+
+			planner.Replan();
+			auto repairEnd = std::chrono::steady_clock::now();
+
+			jpsTime += std::chrono::duration<double, std::micro>(scratchBegin - jpsBegin).count();
+			scratchTime += std::chrono::duration<double, std::micro>(repairBegin - scratchBegin).count();
+			repairTime += std::chrono::duration<double, std::micro>(repairEnd - repairBegin).count();
+			scratchExpandCount += scratch.GetExpandedNodeCount();
+			repairExpandCount += planner.GetExpandedNodeCount();
+
+			if (planner.GetPathCost() != jps.GetPathCost() || scratch.GetPathCost() != jps.GetPathCost())
+			{
+				mismatchCount++;
+			}
+
+			if (planner.GetPathCost() != -1 && (isPathClear(pathFindMap.GetGrid(), planner.GetPoints()) == false
+				|| planner.GetPoints().Front().X != current.X || planner.GetPoints().Front().Y != current.Y))
+			{
+				invalidCount++;
+			}
+
+			// 다시 뚫으면 막기 전의 비용으로 돌아와야 한다
+			for (const Point& cell : wall)
+			{
+				pathFindMap.UnBlock(cell.X, cell.Y);
+			}
+
+			auto reopenBegin = std::chrono::steady_clock::now();
+
+			for (const Point& cell : wall)
+			{
+				planner.OnCellChanged(cell.X, cell.Y);
+			}
+
+			planner.Replan();
+			auto reopenEnd = std::chrono::steady_clock::now();
+
+			reopenTime += std::chrono::duration<double, std::micro>(reopenEnd - reopenBegin).count();
+
+			jps.PathFind(current.X, current.Y, query.EndX, query.EndY);
+
+			if (planner.GetPathCost() != jps.GetPathCost())
+			{
+				mismatchCount++;
+			}
+
+			if (planner.GetPathCost() != -1 && isPathClear(pathFindMap.GetGrid(), planner.GetPoints()) == false)
+			{
+				invalidCount++;
+			}
+		}
+
+		printf("%5dx%-4d %10.1f %10.1f %10.1f %12.1f %12.1f %12.1f %10d %8d\n",
+			size, size, jpsTime / TRIAL_COUNT, scratchTime / TRIAL_COUNT, repairTime / TRIAL_COUNT,
+			(double)scratchExpandCount / TRIAL_COUNT, (double)repairExpandCount / TRIAL_COUNT, reopenTime / TRIAL_COUNT,
+			mismatchCount, invalidCount);
+	}
+
+	const int SEGMENT_MAP_SIZE = 1000;
+	const int AGENT_COUNTS[] = { 1000, 10000 };
+	const int BLOCK_COUNT = 1000;
+
+	printf("\n[replan] owners of paths crossing a blocked cell, %d cells (%dx%d)\n", BLOCK_COUNT, SEGMENT_MAP_SIZE, SEGMENT_MAP_SIZE);
+	printf("%8s %10s %12s %12s %10s %10s %10s\n", "agents", "insert ms", "index us", "scan us", "speedup", "found", "mismatch");
+
+	TestMap map(SEGMENT_MAP_SIZE, SEGMENT_MAP_SIZE, OBSTACLE_RATIO, 43);
+
+	PathFindMap pathFindMap(SEGMENT_MAP_SIZE, SEGMENT_MAP_SIZE);
+	map.ApplyTo(pathFindMap);
+
+	JPSPathFinder jps(pathFindMap);
+
+	for (int agentCount : AGENT_COUNTS)
+	{
+		std::vector<Query> queries = makeQueries(map, agentCount, 10, 60, agentCount);
+		std::vector<Path> paths;
+
+		for (const Query& query : queries)
+		{
+			jps.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			paths.push_back(jps.GetPoints());
+		}
+
+		PathSegmentIndex index(SEGMENT_MAP_SIZE, SEGMENT_MAP_SIZE);
+
+		auto insertBegin = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < agentCount; ++i)
+		{
+			index.Insert(i, paths[i]);
+		}
+
+		auto insertEnd = std::chrono::steady_clock::now();
+
+		// 경로 위의 칸 절반, 아무 칸 절반
+		std::mt19937 random(5);
+		std::vector<Point> cells;
+
+		for (int i = 0; i < BLOCK_COUNT; ++i)
+		{
+			if (i % 2 == 0)
+			{
+				cells.push_back(getPointOnPath(paths[random() % agentCount], std::uniform_real_distribution<double>(0.0, 0.99)(random)));
+			}
+			else
+			{
+				cells.push_back(Point{ (int)(random() % SEGMENT_MAP_SIZE), (int)(random() % SEGMENT_MAP_SIZE) });
+			}
+		}
+
+		std::vector<std::vector<uint64_t>> indexOwners(BLOCK_COUNT);
+		std::vector<std::vector<uint64_t>> scanOwners(BLOCK_COUNT);
+
+		auto indexBegin = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < BLOCK_COUNT; ++i)
+		{
+			index.Query(cells[i].X, cells[i].Y, indexOwners[i]);
+		}
+
+		auto scanBegin = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < BLOCK_COUNT; ++i)
+		{
+			const int x = cells[i].X;
+			const int y = cells[i].Y;
+
+			for (int agent = 0; agent < agentCount; ++agent)
+			{
+				const Path& points = paths[agent];
+
+				for (int k = 1; k < points.Size(); ++k)
+				{
+					if (LineOfSight::IsClear(points[k].X, points[k].Y, points[k - 1].X, points[k - 1].Y,
+						[x, y](int cellX, int cellY) { return cellX != x || cellY != y; }) == false)
+					{
+						scanOwners[i].push_back(agent);
+						break;
+					}
+				}
+			}
+		}
+
+		auto scanEnd = std::chrono::steady_clock::now();
+
+		long long foundCount = 0;
+		int mismatchCount = 0;
+
+		for (int i = 0; i < BLOCK_COUNT; ++i)
+		{
+			std::sort(indexOwners[i].begin(), indexOwners[i].end());
+			foundCount += indexOwners[i].size();
+
+			if (indexOwners[i] != scanOwners[i])
+			{
+				mismatchCount++;
+			}
+		}
+
+		double insertTime = std::chrono::duration<double, std::milli>(insertEnd - insertBegin).count();
+		double indexTime = std::chrono::duration<double, std::micro>(scanBegin - indexBegin).count() / BLOCK_COUNT;
+		double scanTime = std::chrono::duration<double, std::micro>(scanEnd - scanBegin).count() / BLOCK_COUNT;
+
+		printf("%8d %10.2f %12.3f %12.1f %9.0fx %10lld %10d\n",
+			agentCount, insertTime, indexTime, scanTime, scanTime / indexTime, foundCount, mismatchCount);
+	}
+
+	printf("\n");
+}
+
+// 미로 맵 (통로 폭 corridorWidth, 벽 두께 1)
+// 깊이 우선으로 통로를 판 뒤, 벽의 loopRatio 만큼을 더 뚫어서 돌아가는 길을 만든다
+static TestMap makeMazeMap(int size, int corridorWidth, double loopRatio, unsigned int seed)
+{
+	TestMap map(size, size, 1.0, seed);
+
+	const int pitch = corridorWidth + 1;
+	const int mazeSize = (size - 1) / pitch;
+
+	std::mt19937 random(seed);
+	std::vector<bool> visited(mazeSize * mazeSize, false);
+	std::vector<int> stack;
+
+	// 미로 칸 (mx, my)의 통로, 또는 미로 칸 사이의 벽을 뚫는다
+	auto carve = [&](int left, int top, int width, int height)
+	{
+		for (int y = top; y < top + height; ++y)
+		{
+			for (int x = left; x < left + width; ++x)
+			{
+				map.Walkable[y * size + x] = true;
+			}
+		}
+	};
+
+	auto carveBetween = [&](int a, int b)
+	{
+		int ax = a % mazeSize;
+		int ay = a / mazeSize;
+		int bx = b % mazeSize;
+		int by = b / mazeSize;
+
+		int left = std::min(ax, bx) * pitch + 1;
+		int top = std::min(ay, by) * pitch + 1;
+
+		carve(left, top, ax != bx ? pitch + corridorWidth : corridorWidth, ay != by ? pitch + corridorWidth : corridorWidth);
+	};
+
+	const int DX[] = { 1, -1, 0, 0 };
+	const int DY[] = { 0, 0, 1, -1 };
+
+	visited[0] = true;
+	stack.push_back(0);
+	carve(1, 1, corridorWidth, corridorWidth);
+
+	while (stack.empty() == false)
+	{
+		int cell = stack.back();
+		int candidates[4];
+		int candidateCount = 0;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			int nx = cell % mazeSize + DX[i];
+			int ny = cell / mazeSize + DY[i];
+
+			if (nx >= 0 && nx < mazeSize && ny >= 0 && ny < mazeSize && visited[ny * mazeSize + nx] == false)
+			{
+				candidates[candidateCount++] = ny * mazeSize + nx;
+			}
+		}
+
+		if (candidateCount == 0)
+		{
+			stack.pop_back();
+			continue;
+		}
+
+		int next = candidates[random() % candidateCount];
+		visited[next] = true;
+		carveBetween(cell, next);
+		stack.push_back(next);
+	}
+
+	// 돌아가는 길
+	std::uniform_real_distribution<double> ratio(0.0, 1.0);
+
+	for (int cell = 0; cell < mazeSize * mazeSize; ++cell)
+	{
+		int x = cell % mazeSize;
+		int y = cell / mazeSize;
+
+		if (x + 1 < mazeSize && ratio(random) < loopRatio)
+		{
+			carveBetween(cell, cell + 1);
+		}
+
+		if (y + 1 < mazeSize && ratio(random) < loopRatio)
+		{
+			carveBetween(cell, cell + mazeSize);
+		}
+	}
+
+	map.Relabel();
+
+	return map;
+}
+
+// 랜드마크(ALT) 휴리스틱을 켰을 때 JPS의 쿼리 당 시간, 확장 노드 수 (미로 맵과 무작위 장애물 맵)
+// 거리표 만드는 시간(스레드 수 별)과 크기, 경로 비용이 옥타일 거리만 쓸 때와 같은지도 확인한다
+static void benchLandmarks(void)
+{
+	struct MapCase
+	{
+		const char* Name;
+		int Size;
+		int CorridorWidth;		// 0이면 무작위 장애물 맵
+	};
+
+	const MapCase MAP_CASES[] =
+	{
+		{ "maze", 200, 1 },
+		{ "maze", 500, 2 },
+		{ "maze", 1000, 4 },
+		{ "random", 1000, 0 },
+	};
+	const int LANDMARK_COUNTS[] = { 4, 8, 16 };
+	const int QUERY_COUNT = 300;
+	const int THREAD_COUNT = std::max(1, (int)std::thread::hardware_concurrency());
+
+	printf("[landmarks] JPS octile vs JPS + ALT, %d queries per map (chebyshev distance 20 ~ size / 2)\n", QUERY_COUNT);
+	printf("%14s %4s %10s %10s %12s %10s %10s %10s %8s %10s\n",
+		"map", "K", "build ms", "build 1T", "table KB", "JPS us", "ALT us", "expand", "ALT exp", "mismatch");
+
+	for (const MapCase& mapCase : MAP_CASES)
+	{
+		TestMap map = mapCase.CorridorWidth > 0
+			? makeMazeMap(mapCase.Size, mapCase.CorridorWidth, 0.05, 3)
+			: TestMap(mapCase.Size, mapCase.Size, 0.2, 3);
+
+		PathFindMap pathFindMap(mapCase.Size, mapCase.Size);
+		map.ApplyTo(pathFindMap);
+
+		JPSPathFinder pathFinder(pathFindMap);
+
+		std::vector<Query> queries = makeQueries(map, QUERY_COUNT, 20, mapCase.Size / 2, 9);
+
+		double octileTime = measurePerQueryMicroseconds(pathFinder, queries);
+		std::vector<int> octileCosts;
+		long long octileExpandCount = 0;
+
+		for (const Query& query : queries)
+		{
+			pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			octileCosts.push_back(pathFinder.GetPathCost());
+			octileExpandCount += pathFinder.GetExpandedNodeCount();
+		}
+
+		for (int landmarkCount : LANDMARK_COUNTS)
+		{
+			// 한 스레드로 만드는 시간 (비교용)
+			auto singleBegin = std::chrono::steady_clock::now();
+			pathFindMap.EnableLandmarks(landmarkCount, SIZE_MAX, 1);
+			auto singleEnd = std::chrono::steady_clock::now();
+
+			auto buildBegin = std::chrono::steady_clock::now();
+			pathFindMap.EnableLandmarks(landmarkCount, SIZE_MAX, THREAD_COUNT);
+			auto buildEnd = std::chrono::steady_clock::now();
+
+			double landmarkTime = measurePerQueryMicroseconds(pathFinder, queries);
+			long long landmarkExpandCount = 0;
+			int mismatchCount = 0;
+
+			for (int i = 0; i < QUERY_COUNT; ++i)
+			{
+				pathFinder.PathFind(queries[i].StartX, queries[i].StartY, queries[i].EndX, queries[i].EndY);
+				landmarkExpandCount += pathFinder.GetExpandedNodeCount();
+
+				if (pathFinder.GetPathCost() != octileCosts[i])
+				{
+					mismatchCount++;
+				}
+			}
+
+			char name[32];
+			snprintf(name, sizeof(name), "%s %d", mapCase.Name, mapCase.Size);
+
+			printf("%14s %4d %10.1f %10.1f %12zu %10.1f %10.1f %10.1f %8.1f %10d\n",
+				name, landmarkCount,
+				std::chrono::duration<double, std::milli>(buildEnd - buildBegin).count(),
+				std::chrono::duration<double, std::milli>(singleEnd - singleBegin).count(),
+				pathFindMap.GetLandmarks()->GetReservedBytes() / 1024,
+				octileTime, landmarkTime, (double)octileExpandCount / QUERY_COUNT, (double)landmarkExpandCount / QUERY_COUNT, mismatchCount);
+
+			pathFindMap.DisableLandmarks();
+		}
+	}
+
+	// 메모리 한도에 맞춰 랜드마크 수를 줄이는지
+	PathFindMap budgetMap(1000, 1000);
+	int budgetCount = budgetMap.EnableLandmarks(16, 8 * 1024 * 1024, THREAD_COUNT);
+	printf("budget 8 MB on 1000x1000, 16 requested -> %d landmarks (%zu KB)\n", budgetCount, budgetMap.GetReservedBytes() / 1024);
+
+	printf("\n");
+}
+
+// 목표 경계 상자(Goal Bounding)를 켰을 때 JPS, JPS+의 쿼리 당 시간과 확장 노드 수 (무작위 장애물 맵, 미로 맵, 서버의 map.txt)
+// 테이블 만드는 시간(모든 코어)과 크기, 경로 비용이 켜기 전과 같은지도 확인한다
+static void benchGoalBounds(void)
+{
+	struct MapCase
+	{
+		const char* Name;
+		int Size;
+		int CorridorWidth;		// 0이면 무작위 장애물 맵, -1이면 서버의 map.txt (200 x 200)
+	};
+
+	const MapCase MAP_CASES[] =
+	{
+		{ "random", 100, 0 },
+		{ "random", 200, 0 },
+		{ "maze", 200, 2 },
+		{ "map.txt", 200, -1 },
+	};
+	const char* SERVER_MAP_FILE_NAMES[] = { "map.txt", "../UnityJPSPortfolio/map.txt", "UnityJPSPortfolio/map.txt" };
+	const int QUERY_COUNT = 1000;
+	const int THREAD_COUNT = std::max(1, (int)std::thread::hardware_concurrency());
+
+	printf("[goal-bounds] JPS vs JPS + goal bounding, %d queries per map (chebyshev distance 10 ~ size), %d threads\n", QUERY_COUNT, THREAD_COUNT);
+	printf("%12s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+		"map", "build ms", "table KB", "JPS us", "GB us", "JPS+ us", "JPS+GB us", "expand", "GB exp", "mismatch");
+
+	for (const MapCase& mapCase : MAP_CASES)
+	{
+		TestMap map = mapCase.CorridorWidth > 0
+			? makeMazeMap(mapCase.Size, mapCase.CorridorWidth, 0.05, 21)
+			: TestMap(mapCase.Size, mapCase.Size, mapCase.CorridorWidth == 0 ? 0.2 : 0.0, 21);
+
+		PathFindMap pathFindMap(mapCase.Size, mapCase.Size);
+
+		if (mapCase.CorridorWidth < 0)
+		{
+			bool bLoaded = false;
+
+			for (const char* fileName : SERVER_MAP_FILE_NAMES)
+			{
+				if (MapFile::ReadText(fileName, pathFindMap))
+				{
+					bLoaded = true;
+					break;
+				}
+			}
+
+			if (bLoaded == false)
+			{
+				printf("%12s not found (run in the server or repository directory)\n", mapCase.Name);
+				continue;
+			}
+
+			for (int y = 0; y < map.Height; ++y)
+			{
+				for (int x = 0; x < map.Width; ++x)
+				{
+					map.Walkable[y * map.Width + x] = pathFindMap.IsBlocked(x, y) == false;
+				}
+			}
+
+			map.Relabel();
+		}
+		else
+		{
+			map.ApplyTo(pathFindMap);
+		}
+
+		JPSPathFinder pathFinder(pathFindMap);
+
+		std::vector<Query> queries = makeQueries(map, QUERY_COUNT, 10, mapCase.Size - 1, 23);
+
+		// 켜기 전 (JPS, JPS+)
+		double jpsTime = measurePerQueryMicroseconds(pathFinder, queries);
+		std::vector<int> costs;
+		long long expandCount = 0;
+
+		for (const Query& query : queries)
+		{
+			pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			costs.push_back(pathFinder.GetPathCost());
+			expandCount += pathFinder.GetExpandedNodeCount();
+		}
+
+		pathFindMap.EnableJumpTable();
+		double jumpTableTime = measurePerQueryMicroseconds(pathFinder, queries);
+		pathFindMap.DisableJumpTable();
+
+		auto buildBegin = std::chrono::steady_clock::now();
+		pathFindMap.EnableGoalBounds(THREAD_COUNT);
+		auto buildEnd = std::chrono::steady_clock::now();
+
+		// 켠 뒤 (JPS + GB, JPS+ + GB)
+		double goalBoundsTime = measurePerQueryMicroseconds(pathFinder, queries);
+		long long goalBoundsExpandCount = 0;
+		int mismatchCount = 0;
+
+		for (int i = 0; i < QUERY_COUNT; ++i)
+		{
+			pathFinder.PathFind(queries[i].StartX, queries[i].StartY, queries[i].EndX, queries[i].EndY);
+			goalBoundsExpandCount += pathFinder.GetExpandedNodeCount();
+			mismatchCount += pathFinder.GetPathCost() != costs[i] ? 1 : 0;
+		}
+
+		pathFindMap.EnableJumpTable();
+		double jumpTableGoalBoundsTime = measurePerQueryMicroseconds(pathFinder, queries);
+
+		for (int i = 0; i < QUERY_COUNT; ++i)
+		{
+			pathFinder.PathFind(queries[i].StartX, queries[i].StartY, queries[i].EndX, queries[i].EndY);
+			mismatchCount += pathFinder.GetPathCost() != costs[i] ? 1 : 0;
+		}
+
+		char name[32];
+		snprintf(name, sizeof(name), "%s %d", mapCase.Name, mapCase.Size);
+
+		printf("%12s %10.0f %10zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10d\n",
+			name, std::chrono::duration<double, std::milli>(buildEnd - buildBegin).count(), pathFindMap.GetGoalBounds()->GetReservedBytes() / 1024,
+			jpsTime, goalBoundsTime, jumpTableTime, jumpTableGoalBoundsTime,
+			(double)expandCount / QUERY_COUNT, (double)goalBoundsExpandCount / QUERY_COUNT, mismatchCount);
+	}
+
+	printf("\n");
+}
+
+// 서버 시작 시 맵 로딩 시간 : map.txt를 fscanf로 읽고 테이블을 만드는 기존 방식 vs 미리 변환한 map.bin을 매핑
+// 매핑한 맵의 칸, 테이블, JPS 경로 비용이 텍스트로 읽은 맵과 같은지, 로딩 후 맵을 고쳐도 파일은 그대로인지 확인한다
+static void benchMapFile(void)
+{
+	struct MapCase
+	{
+		const char* Name;
+		int Size;
+		int CorridorWidth;		// 0이면 무작위 장애물 맵
+		int LandmarkCount;
+	};
+
+	const MapCase MAP_CASES[] =
+	{
+		{ "random", 200, 0, 0 },
+		{ "random", 1000, 0, 0 },
+		{ "random", 2000, 0, 0 },
+		{ "maze", 1000, 4, 8 },
+	};
+	const char* TEXT_FILE_NAME = "bench_map.txt";
+	const char* BINARY_FILE_NAME = "bench_map.bin";
+	const int QUERY_COUNT = 200;
+	const int THREAD_COUNT = std::max(1, (int)std::thread::hardware_concurrency());
+
+	printf("[map-file] server start map loading, text (fscanf + build tables) vs binary (mmap + Load)\n");
+	printf("%14s %4s %10s %10s %10s %10s %10s %10s %12s %8s %8s\n",
+		"map", "K", "txt KB", "fscanf ms", "parse ms", "build ms", "bin KB", "convert ms", "open+load ms", "wrong", "cow");
+
+	for (const MapCase& mapCase : MAP_CASES)
+	{
+		TestMap map = mapCase.CorridorWidth > 0
+			? makeMazeMap(mapCase.Size, mapCase.CorridorWidth, 0.05, 5)
+			: TestMap(mapCase.Size, mapCase.Size, 0.2, 5);
+
+		// 서버의 map.txt와 같은 형식 ("x y" 줄마다 막힌 칸 하나)
+		FILE* textFile = fopen(TEXT_FILE_NAME, "w");
+
+		if (textFile == nullptr)
+		{
+			printf("cannot write %s\n", TEXT_FILE_NAME);
+			return;
+		}
+
+		for (int y = 0; y < map.Height; ++y)
+		{
+			for (int x = 0; x < map.Width; ++x)
+			{
+				if (map.IsWalkable(x, y) == false)
+				{
+					fprintf(textFile, "%d %d\n", x, y);
+				}
+			}
+		}
+
+		long textBytes = ftell(textFile);
+		fclose(textFile);
+
+		// 기존 서버 방식 : 줄마다 fscanf
+		PathFindMap textMap(mapCase.Size, mapCase.Size);
+
+		auto scanBegin = std::chrono::steady_clock::now();
+		textFile = fopen(TEXT_FILE_NAME, "r");
+
+		int x;
+		int y;
+
+		while (fscanf(textFile, "%d %d", &x, &y) == 2)
+		{
+			textMap.Block(x, y);
+		}
+
+		fclose(textFile);
+		auto scanEnd = std::chrono::steady_clock::now();
+
+		// 변환기가 쓰는 한 번에 읽어서 자르는 방식
+		PathFindMap parsedMap(mapCase.Size, mapCase.Size);
+
+		auto parseBegin = std::chrono::steady_clock::now();
+		MapFile::ReadText(TEXT_FILE_NAME, parsedMap);
+		auto parseEnd = std::chrono::steady_clock::now();
+
+		// 서버가 시작할 때마다 만들던 테이블들
+		auto buildBegin = std::chrono::steady_clock::now();
+		textMap.EnableComponents();
+		textMap.EnableJumpTable();
+		textMap.EnableLandmarks(mapCase.LandmarkCount, SIZE_MAX, THREAD_COUNT);
+		auto buildEnd = std::chrono::steady_clock::now();
+
+		auto convertBegin = std::chrono::steady_clock::now();
+		bool bConverted = MapFile::ConvertText(TEXT_FILE_NAME, mapCase.Size, mapCase.Size, BINARY_FILE_NAME, true, mapCase.LandmarkCount, false, THREAD_COUNT);
+		auto convertEnd = std::chrono::steady_clock::now();
+
+		MapFile mapFile;
+		PathFindMap binaryMap(mapCase.Size, mapCase.Size);
+
+		auto loadBegin = std::chrono::steady_clock::now();
+		bool bLoaded = bConverted && mapFile.Open(BINARY_FILE_NAME) && binaryMap.Load(mapFile, THREAD_COUNT);
+		auto loadEnd = std::chrono::steady_clock::now();
+
+		if (bLoaded == false)
+		{
+			printf("%14s convert or load failed\n", mapCase.Name);
+			continue;
+		}
+
+		// 칸, 테이블 켜짐 여부, JPS+ 경로 비용 비교
+		int wrongCount = 0;
+
+		for (int cellY = 0; cellY < mapCase.Size; ++cellY)
+		{
+			for (int cellX = 0; cellX < mapCase.Size; ++cellX)
+			{
+				bool bBlocked = textMap.IsBlocked(cellX, cellY);
+				wrongCount += bBlocked != binaryMap.IsBlocked(cellX, cellY) ? 1 : 0;
+				wrongCount += bBlocked != parsedMap.IsBlocked(cellX, cellY) ? 1 : 0;
+			}
+		}
+
+		wrongCount += binaryMap.IsJumpTableEnabled() && binaryMap.IsComponentsEnabled() ? 0 : 1;
+		wrongCount += binaryMap.IsLandmarksEnabled() == (mapCase.LandmarkCount > 0) ? 0 : 1;
+
+		JPSPathFinder textPathFinder(textMap);
+		JPSPathFinder binaryPathFinder(binaryMap);
+
+		for (const Query& query : makeQueries(map, QUERY_COUNT, 20, mapCase.Size / 2, 13))
+		{
+			textPathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			binaryPathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+
+			wrongCount += textPathFinder.GetPathCost() != binaryPathFinder.GetPathCost() ? 1 : 0;
+		}
+
+		// 로딩한 맵을 고쳐도 파일과 새로 연 매핑에는 보이지 않아야 한다 (쓰기 시 복사)
+		Query editQuery = makeQueries(map, 1, 0, mapCase.Size, 17).front();
+		binaryMap.Block(editQuery.StartX, editQuery.StartY);
+
+		MapFile otherFile;
+		PathFindMap otherMap(mapCase.Size, mapCase.Size);
+		bool bCopyOnWrite = otherFile.Open(BINARY_FILE_NAME) && otherMap.Load(otherFile, THREAD_COUNT) && otherMap.IsBlocked(editQuery.StartX, editQuery.StartY) == false;
+
+		char name[32];
+		snprintf(name, sizeof(name), "%s %d", mapCase.Name, mapCase.Size);
+
+		printf("%14s %4d %10ld %10.1f %10.1f %10.1f %10zu %10.1f %12.3f %8d %8s\n",
+			name, mapCase.LandmarkCount, textBytes / 1024,
+			std::chrono::duration<double, std::milli>(scanEnd - scanBegin).count(),
+			std::chrono::duration<double, std::milli>(parseEnd - parseBegin).count(),
+			std::chrono::duration<double, std::milli>(buildEnd - buildBegin).count(),
+			(size_t)mapFile.GetHeader().FileSize / 1024,
+			std::chrono::duration<double, std::milli>(convertEnd - convertBegin).count(),
+			std::chrono::duration<double, std::milli>(loadEnd - loadBegin).count(),
+			wrongCount, bCopyOnWrite ? "ok" : "FAIL");
+	}
+
+	remove(TEXT_FILE_NAME);
+	remove(BINARY_FILE_NAME);
+
+	printf("\n");
+}
+
+// Moving AI 격자 벤치마크(.map/.scen)를 A*, JPS, JPS+로 돌려서 CSV로 출력한다 (버킷 별 한 줄, 마지막에 전체 한 줄)
+// 인자 : movingai <.scen 파일> [.map 파일], .map 파일을 주지 않으면 .scen 파일이 있는 폴더에서 시나리오의 맵 이름으로 찾는다
+//
+// Moving AI의 최적 거리는 대각선 √2이고 모서리를 자를 수 없지만, 이 길찾기는 대각선 7/5 = 1.4이고 모서리를 자를 수 있다
+// 따라서 찾은 경로의 √2 기준 길이는 최적 거리보다 짧을 수 있고(corner_cut), 길어도 1.4와 √2의 차이(1.0102배)를 넘지 않아야 한다 (넘으면 suboptimal)
+static const char* g_scenarioFileName = nullptr;
+static const char* g_mapFileName = nullptr;
+
+struct Scenario
+{
+	int Bucket;
+	std::string MapName;
+	int Width;
+	int Height;
+	Query Points;
+	double OptimalLength;
+};
+
+// '.', 'G', 'S'만 지나갈 수 있다 (Moving AI 규칙)
+static bool loadMovingAIMap(const char* fileName, int& outWidth, int& outHeight, std::vector<bool>& outWalkable)
+{
+	FILE* file = fopen(fileName, "r");
+
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	char type[32];
+
+	if (fscanf(file, " type %31s height %d width %d map", type, &outHeight, &outWidth) != 3 || outWidth <= 0 || outHeight <= 0)
+	{
+		fclose(file);
+		return false;
+	}
+
+	outWalkable.assign(outWidth * outHeight, false);
+
+	int cellCount = 0;
+	int character;
+
+	while (cellCount < outWidth * outHeight && (character = fgetc(file)) != EOF)
+	{
+		if (character == '\n' || character == '\r')
+		{
+			continue;
+		}
+
+		outWalkable[cellCount] = character == '.' || character == 'G' || character == 'S';
+		cellCount++;
+	}
+
+	fclose(file);
+
+	return cellCount == outWidth * outHeight;
+}
+
+static std::vector<Scenario> loadMovingAIScenarios(const char* fileName)
+{
+	std::vector<Scenario> scenarios;
+	FILE* file = fopen(fileName, "r");
+
+	if (file == nullptr)
+	{
+		return scenarios;
+	}
+
+	char version[32];
+
+	if (fscanf(file, " version %31s", version) == 1)
+	{
+		Scenario scenario;
+		char mapName[512];
+
+		while (fscanf(file, "%d %511s %d %d %d %d %d %d %lf", &scenario.Bucket, mapName, &scenario.Width, &scenario.Height,
+			&scenario.Points.StartX, &scenario.Points.StartY, &scenario.Points.EndX, &scenario.Points.EndY, &scenario.OptimalLength) == 9)
+		{
+			scenario.MapName = mapName;
+			scenarios.push_back(scenario);
+		}
+	}
+
+	fclose(file);
+
+	return scenarios;
+}
+
+// 시나리오의 맵 이름을 .scen 파일의 폴더 기준으로 (없다면 파일 이름만으로) 찾는다
+static std::string findMovingAIMap(const std::string& scenarioFileName, const std::string& mapName)
+{
+	size_t slash = scenarioFileName.find_last_of("/\\");
+	std::string directory = slash != std::string::npos ? scenarioFileName.substr(0, slash + 1) : std::string();
+
+	size_t mapSlash = mapName.find_last_of("/\\");
+	std::string baseName = mapSlash != std::string::npos ? mapName.substr(mapSlash + 1) : mapName;
+
+	const std::string CANDIDATES[] = { directory + mapName, directory + baseName, mapName };
+
+	for (const std::string& candidate : CANDIDATES)
+	{
+		FILE* file = fopen(candidate.c_str(), "r");
+
+		if (file != nullptr)
+		{
+			fclose(file);
+			return candidate;
+		}
+	}
+
+	return std::string();
+}
+
+// 경로 점들 사이를 대각선 √2로 잰 길이 (줄인 경로의 한 구간은 옥타일 거리로 잰다)
+static double getOctileLength(const Path& points)
+{
+	double length = 0.0;
+
+	for (int i = 1; i < points.Size(); ++i)
+	{
+		int xGap = abs(points[i].X - points[i - 1].X);
+		int yGap = abs(points[i].Y - points[i - 1].Y);
+		int diagonal = std::min(xGap, yGap);
+
+		length += (xGap + yGap - 2 * diagonal) + diagonal * 1.4142135623730951;
+	}
+
+	return length;
+}
+
+// 쿼리 시간 목록에서 백분위 (nearest-rank)
+static double getPercentile(std::vector<double> times, double ratio)
+{
+	if (times.empty())
+	{
+		return 0.0;
+	}
+
+	std::sort(times.begin(), times.end());
+
+	size_t rank = (size_t)std::ceil(ratio * times.size());
+	return times[rank > 0 ? rank - 1 : 0];
+}
+
+struct MovingAIStats
+{
+	int QueryCount = 0;
+	int FailedCount = 0;			// 최적 경로가 있는데 찾지 못함
+	int SuboptimalCount = 0;		// 최적 거리 x 1.0102보다 긺
+	int CornerCutCount = 0;			// 모서리를 잘라서 최적 거리보다 짧음
+	int CostMismatchCount = 0;		// A*와 경로 비용이 다름
+	long long ExpandedNodeCount = 0;
+	long long HeapOperationCount = 0;
+	long long AllocatedNodeCount = 0;
+	std::vector<double> Times;
+};
+
+template <typename PathFinder>
+static void runMovingAIScenarios(const char* finderName, const char* mapName, PathFinder& pathFinder, size_t stateBytes,
+	const std::vector<Scenario>& scenarios, std::vector<int>& ioAStarCosts, bool bAStar)
+{
+	const double OPTIMAL_TOLERANCE = 1.4142135623730951 / 1.4 + 1e-9;
+
+	int bucketCount = 0;
+
+	for (const Scenario& scenario : scenarios)
+	{
+		bucketCount = std::max(bucketCount, scenario.Bucket + 1);
+	}
+
+	std::vector<MovingAIStats> bucketStats(bucketCount);
+	MovingAIStats totalStats;
+
+	// 결과 확인 (시간은 재지 않는다)
+	for (int i = 0; i < (int)scenarios.size(); ++i)
+	{
+		const Scenario& scenario = scenarios[i];
+		const Query& query = scenario.Points;
+
+		pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+
+		int cost = pathFinder.GetPathCost();
+		double length = getOctileLength(pathFinder.GetPoints());
+
+		if (bAStar)
+		{
+			ioAStarCosts[i] = cost;
+		}
+
+		for (MovingAIStats* stats : { &bucketStats[scenario.Bucket], &totalStats })
+		{
+			stats->QueryCount++;
+			stats->FailedCount += cost < 0 ? 1 : 0;
+			stats->SuboptimalCount += cost >= 0 && length > scenario.OptimalLength * OPTIMAL_TOLERANCE + 1e-6 ? 1 : 0;
+			stats->CornerCutCount += cost >= 0 && length < scenario.OptimalLength - 1e-6 ? 1 : 0;
+			stats->CostMismatchCount += cost != ioAStarCosts[i] ? 1 : 0;
+			stats->ExpandedNodeCount += pathFinder.GetExpandedNodeCount();
+			stats->HeapOperationCount += pathFinder.GetHeapOperationCount();
+			stats->AllocatedNodeCount += pathFinder.GetAllocatedNodeCount();
+		}
+	}
+
+	// 쿼리 당 시간
+	for (const Scenario& scenario : scenarios)
+	{
+		const Query& query = scenario.Points;
+
+		auto begin = std::chrono::steady_clock::now();
+		pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+		auto end = std::chrono::steady_clock::now();
+
+		double time = std::chrono::duration<double, std::micro>(end - begin).count();
+		bucketStats[scenario.Bucket].Times.push_back(time);
+		totalStats.Times.push_back(time);
+	}
+
+	for (int bucket = 0; bucket <= bucketCount; ++bucket)
+	{
+		const MovingAIStats& stats = bucket < bucketCount ? bucketStats[bucket] : totalStats;
+
+		if (stats.QueryCount == 0)
+		{
+			continue;
+		}
+
+		double mean = 0.0;
+
+		for (double time : stats.Times)
+		{
+			mean += time;
+		}
+
+		char bucketName[16];
+		snprintf(bucketName, sizeof(bucketName), bucket < bucketCount ? "%d" : "all", bucket);
+
+		printf("%s,%s,%s,%d,%d,%d,%d,%d,%.2f,%.2f,%.2f,%.1f,%.1f,%.0f,%zu\n",
+			finderName, mapName, bucketName, stats.QueryCount,
+			stats.FailedCount, stats.SuboptimalCount, stats.CornerCutCount, stats.CostMismatchCount,
+			getPercentile(stats.Times, 0.50), getPercentile(stats.Times, 0.99), mean / stats.QueryCount,
+			(double)stats.ExpandedNodeCount / stats.QueryCount, (double)stats.HeapOperationCount / stats.QueryCount,
+			(double)stats.AllocatedNodeCount * NodeArena::BYTES_PER_NODE / stats.QueryCount, stateBytes / 1024);
+	}
+}
+
+static void benchMovingAI(void)
+{
+	if (g_scenarioFileName == nullptr)
+	{
+		printf("[movingai] skipped (usage: PathFinderBenchmark movingai <file.scen> [file.map])\n\n");
+		return;
+	}
+
+	std::vector<Scenario> scenarios = loadMovingAIScenarios(g_scenarioFileName);
+
+	if (scenarios.empty())
+	{
+		printf("[movingai] cannot read scenarios from %s\n\n", g_scenarioFileName);
+		return;
+	}
+
+	printf("finder,map,bucket,queries,failed,suboptimal,corner_cut,cost_mismatch,p50_us,p99_us,mean_us,expanded,heap_ops,node_bytes,state_kb\n");
+
+	// 한 .scen 파일에 여러 맵이 섞여 있을 수 있으므로 같은 맵끼리 묶어서 돌린다
+	std::sort(scenarios.begin(), scenarios.end(), [](const Scenario& a, const Scenario& b)
+		{
+			return a.MapName != b.MapName ? a.MapName < b.MapName : a.Bucket < b.Bucket;
+		});
+
+	size_t first = 0;
+
+	while (first < scenarios.size())
+	{
+		size_t last = first;
+
+		while (last < scenarios.size() && scenarios[last].MapName == scenarios[first].MapName)
+		{
+			last++;
+		}
+
+		std::vector<Scenario> mapScenarios(scenarios.begin() + first, scenarios.begin() + last);
+		first = last;
+
+		std::string mapFileName = g_mapFileName != nullptr ? std::string(g_mapFileName) : findMovingAIMap(g_scenarioFileName, mapScenarios[0].MapName);
+
+		int width;
+		int height;
+		std::vector<bool> walkable;
+
+		if (mapFileName.empty() || loadMovingAIMap(mapFileName.c_str(), width, height, walkable) == false)
+		{
+			fprintf(stderr, "[movingai] cannot read map %s\n", mapScenarios[0].MapName.c_str());
+			continue;
+		}
+
+		// 맵 크기와 맞지 않거나 막힌 칸에서 시작하는 시나리오는 뺀다
+		std::vector<Scenario> validScenarios;
+
+		for (const Scenario& scenario : mapScenarios)
+		{
+			const Query& query = scenario.Points;
+
+			if (scenario.Width == width && scenario.Height == height
+				&& query.StartX >= 0 && query.StartX < width && query.StartY >= 0 && query.StartY < height
+				&& query.EndX >= 0 && query.EndX < width && query.EndY >= 0 && query.EndY < height
+				&& walkable[query.StartY * width + query.StartX] && walkable[query.EndY * width + query.EndX])
+			{
+				validScenarios.push_back(scenario);
+			}
+		}
+
+		if (validScenarios.size() != mapScenarios.size())
+		{
+			fprintf(stderr, "[movingai] %s: skipped %d scenarios outside the map or on blocked cells\n",
+				mapScenarios[0].MapName.c_str(), (int)(mapScenarios.size() - validScenarios.size()));
+		}
+
+		TestMap map(width, height, 0.0, 0);
+		map.Walkable = walkable;
+
+		size_t slash = mapFileName.find_last_of("/\\");
+		std::string mapName = slash != std::string::npos ? mapFileName.substr(slash + 1) : mapFileName;
+
+		std::vector<int> aStarCosts(validScenarios.size(), -1);
+
+		AStarPathFinder aStarPathFinder(width, height);
+		map.ApplyTo(aStarPathFinder);
+		runMovingAIScenarios("astar", mapName.c_str(), aStarPathFinder, aStarPathFinder.GetReservedBytes(), validScenarios, aStarCosts, true);
+
+		PathFindMap pathFindMap(width, height);
+		map.ApplyTo(pathFindMap);
+
+		JPSPathFinder jpsPathFinder(pathFindMap);
+		runMovingAIScenarios("jps", mapName.c_str(), jpsPathFinder, jpsPathFinder.GetReservedBytes(), validScenarios, aStarCosts, false);
+
+		pathFindMap.EnableJumpTable();
+		runMovingAIScenarios("jps+", mapName.c_str(), jpsPathFinder, jpsPathFinder.GetReservedBytes() + pathFindMap.GetJumpTable()->GetReservedBytes(),
+			validScenarios, aStarCosts, false);
+	}
+
+	printf("\n");
+}
+
+/************************************************************************************/
+
+struct Benchmark
+{
+	const char* Name;
+	void (*Run)(void);
+};
+
+// 나눠서 찾기 : 긴 탐색 하나가 호출 한 번(틱)을 얼마나 오래 붙잡는가
+// 1. JPSPathFinder를 조각 한도 별로 BeginPathFind() + ContinuePathFind()로 찾아, 조각 하나의 시간과 한 번에 찾을 때의 시간을 비교한다
+// 2. 길찾기 스레드 없이 시작한 PathFindService를 업데이트 스레드처럼 OnTick(틱 당 시간)으로만 돌려 틱 하나의 최대 시간을 잰다
+static void benchSlice(void)
+{
+	const int MAP_SIZE = 500;
+	const int QUERY_COUNT = 200;
+	const int SLICE_EXPAND_COUNTS[] = { 0, 2'000, 500, 100 };
+	const int TICK_MICROSECONDS[] = { 0, 4'000, 1'000 };
+	const int SERVICE_SLICE_EXPAND_COUNT = 500;
+	const int SERVICE_MAX_ACTIVE_SEARCH_COUNT = 16;
+
+	TestMap testMap = makeMazeMap(MAP_SIZE, 2, 0.05, 31);
+
+	PathFindMap map(MAP_SIZE, MAP_SIZE);
+	testMap.ApplyTo(map);
+
+	std::vector<Query> queries = makeQueries(testMap, QUERY_COUNT, MAP_SIZE / 4, MAP_SIZE - 1, 32);
+
+	JPSPathFinder pathFinder(map);
+	std::vector<int> costs;
+	std::vector<Path> expected;
+
+	for (const Query& query : queries)
+	{
+		pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+		costs.push_back(pathFinder.GetPathCost());
+		expected.push_back(pathFinder.GetPoints());
+	}
+
+	printf("[slice] maze %d, %d queries (chebyshev distance %d ~ %d), 0 = one slice\n", MAP_SIZE, QUERY_COUNT, MAP_SIZE / 4, MAP_SIZE - 1);
+	printf("%12s %10s %14s %14s %12s %10s\n", "slice expand", "slices/q", "max slice us", "p99 slice us", "total us/q", "mismatch");
+
+	for (int sliceExpandCount : SLICE_EXPAND_COUNTS)
+	{
+		std::vector<double> sliceTimes;
+		double totalMicroseconds = 0.0;
+		int mismatchCount = 0;
+
+		for (int i = 0; i < QUERY_COUNT; ++i)
+		{
+			const Query& query = queries[i];
+
+			auto searchBegin = std::chrono::steady_clock::now();
+			ESearchStatus status = pathFinder.BeginPathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+
+			while (status == ESearchStatus::Suspended)
+			{
+				auto sliceBegin = std::chrono::steady_clock::now();
+				status = pathFinder.ContinuePathFind(sliceExpandCount);
+				sliceTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sliceBegin).count());
+			}
+
+			totalMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - searchBegin).count();
+			mismatchCount += pathFinder.GetPathCost() != costs[i] ? 1 : 0;
+		}
+
+		printf("%12d %10.1f %14.1f %14.1f %12.1f %10d\n",
+			sliceExpandCount, (double)sliceTimes.size() / QUERY_COUNT,
+			*std::max_element(sliceTimes.begin(), sliceTimes.end()), getPercentile(sliceTimes, 0.99),
+			totalMicroseconds / QUERY_COUNT, mismatchCount);
+	}
+
+	printf("\n[slice] PathFindService without threads, OnTick(tick us) on the caller, %d requesters, %d expands per slice, %d active searches\n",
+		QUERY_COUNT, SERVICE_SLICE_EXPAND_COUNT, SERVICE_MAX_ACTIVE_SEARCH_COUNT);
+	printf("%12s %10s %14s %14s %12s %14s %10s\n", "tick us", "ticks", "max tick us", "p99 tick us", "delivered", "max suspended", "mismatch");
+
+	for (int tickMicroseconds : TICK_MICROSECONDS)
+	{
+		PathFindService service(map);
+		service.SetSliceOption(SERVICE_SLICE_EXPAND_COUNT, 0, SERVICE_MAX_ACTIVE_SEARCH_COUNT);
+		service.Start(0, 0);
+
+		for (int i = 0; i < QUERY_COUNT; ++i)
+		{
+			service.Submit(i, queries[i].StartX, queries[i].StartY, queries[i].EndX, queries[i].EndY);
+		}
+
+		std::vector<PathFindService::Result> results;
+		std::vector<double> tickTimes;
+		uint32_t maxSuspendedCount = 0;
+
+		while ((int)results.size() < QUERY_COUNT)
+		{
+			auto tickBegin = std::chrono::steady_clock::now();
+			service.OnTick(tickMicroseconds);
+			tickTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tickBegin).count());
+
+			service.TakeResults(results);
+
+			maxSuspendedCount = std::max(maxSuspendedCount, service.GetStatistics().SuspendedCount);
+		}
+
+		int mismatchCount = 0;
+
+		for (const PathFindService::Result& result : results)
+		{
+			mismatchCount += isSamePoints(result.Points, expected[result.RequesterID]) ? 0 : 1;
+		}
+
+		printf("%12d %10zu %14.1f %14.1f %12zu %14u %10d\n",
+			tickMicroseconds, tickTimes.size(), *std::max_element(tickTimes.begin(), tickTimes.end()), getPercentile(tickTimes, 0.99),
+			results.size(), maxSuspendedCount, mismatchCount);
+	}
+
+	printf("\n");
+}
+
+// 부분 경로 : 확장 한도를 둔 PathFindPartial()이 첫 경로(이동 시작)까지 걸리는 시간과 부분 경로의 품질
+// 멀리 있는 목적지와, 다른 연결 요소(막힌 주머니) 안의 목적지를 섞어서 찾는다
+// 부분 경로의 끝에서 나머지를 다시 찾아 이어 붙인 비용을 한 번에 찾은 최적 비용과 비교한다
+static void benchPartialPath(void)
+{
+	struct MapCase
+	{
+		const char* Name;
+		int Size;
+		int CorridorWidth;		// 0이면 무작위 장애물 맵
+	};
+
+	const MapCase MAP_CASES[] =
+	{
+		{ "maze", 500, 2 },
+		{ "random", 500, 0 },
+	};
+	const int QUERY_COUNT = 400;
+	const int EXPAND_LIMITS[] = { 0, 5'000, 1'000, 200 };
+
+	printf("[partial] PathFindPartial(expand limit), %d queries per map (1/4 goals in another component if any), 0 = no limit\n", QUERY_COUNT);
+	printf("%10s %8s %10s %10s %10s %12s %14s %10s %10s\n",
+		"map", "limit", "p50 us", "p99 us", "partial %", "progress %", "stitched/opt", "invalid", "mismatch");
+
+	for (const MapCase& mapCase : MAP_CASES)
+	{
+		TestMap testMap = mapCase.CorridorWidth > 0
+			? makeMazeMap(mapCase.Size, mapCase.CorridorWidth, 0.05, 41)
+			: TestMap(mapCase.Size, mapCase.Size, 0.3, 41);
+
+		PathFindMap map(mapCase.Size, mapCase.Size);
+		testMap.ApplyTo(map);
+		map.EnableComponents();
+
+		std::vector<Query> queries = makeQueries(testMap, QUERY_COUNT * 3 / 4, mapCase.Size / 4, mapCase.Size - 1, 42);
+
+		// 닿을 수 없는 목적지 (시작점과 다른 연결 요소), 미로처럼 연결 요소가 하나뿐이면 닿을 수 있는 쿼리로 채운다
+		std::mt19937 random(43);
+		std::uniform_int_distribution<int> randomCell(0, mapCase.Size - 1);
+
+		for (int tryCount = 0; (int)queries.size() < QUERY_COUNT && tryCount < 1'000'000; ++tryCount)
+		{
+			Query query{ randomCell(random), randomCell(random), randomCell(random), randomCell(random) };
+
+			if (testMap.IsWalkable(query.StartX, query.StartY) && testMap.IsWalkable(query.EndX, query.EndY)
+				&& testMap.Component[query.StartY * mapCase.Size + query.StartX] != testMap.Component[query.EndY * mapCase.Size + query.EndX])
+			{
+				queries.push_back(query);
+			}
+		}
+
+		if ((int)queries.size() < QUERY_COUNT)
+		{
+			std::vector<Query> reachableQueries = makeQueries(testMap, QUERY_COUNT - (int)queries.size(), mapCase.Size / 4, mapCase.Size - 1, 44);
+			queries.insert(queries.end(), reachableQueries.begin(), reachableQueries.end());
+		}
+
+		JPSPathFinder pathFinder(map);
+		JPSPathFinder remainderFinder(map);
+		std::vector<int> costs;
+
+		for (const Query& query : queries)
+		{
+			pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+			costs.push_back(pathFinder.GetPathCost());
+		}
+
+		for (int expandLimit : EXPAND_LIMITS)
+		{
+			std::vector<double> times;
+			int partialCount = 0;
+			double progressSum = 0.0;
+			double stitchedRatioSum = 0.0;
+			int stitchedCount = 0;
+			int invalidCount = 0;
+			int mismatchCount = 0;
+
+			for (int i = 0; i < QUERY_COUNT; ++i)
+			{
+				const Query& query = queries[i];
+
+				auto begin = std::chrono::steady_clock::now();
+				pathFinder.PathFindPartial(query.StartX, query.StartY, query.EndX, query.EndY, expandLimit);
+				times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+
+				if (pathFinder.IsPartial() == false)
+				{
+					mismatchCount += pathFinder.GetPathCost() != costs[i] ? 1 : 0;
+					continue;
+				}
+
+				// 부분 경로는 시작점에서 출발해 막힌 칸을 지나지 않아야 한다
+				const Path& points = pathFinder.GetPoints();
+				bool bValid = points.Front().X == query.StartX && points.Front().Y == query.StartY && isPathClear(map.GetGrid(), points);
+
+				invalidCount += bValid ? 0 : 1;
+				partialCount++;
+
+				const Point& end = points.Back();
+				int startH = OctileCost::GetDistance(abs(query.EndX - query.StartX), abs(query.EndY - query.StartY));
+				int endH = OctileCost::GetDistance(abs(query.EndX - end.X), abs(query.EndY - end.Y));
+				progressSum += 100.0 * (startH - endH) / startH;
+
+				// 닿을 수 있는 목적지라면 나머지를 이어서 찾아 최적 비용과 비교한다
+				if (costs[i] > 0)
+				{
+					remainderFinder.PathFind(end.X, end.Y, query.EndX, query.EndY);
+
+					if (remainderFinder.GetPathCost() >= 0)
+					{
+						stitchedRatioSum += (double)(pathFinder.GetPathCost() + remainderFinder.GetPathCost()) / costs[i];
+						stitchedCount++;
+					}
+				}
+			}
+
+			char name[32];
+			snprintf(name, sizeof(name), "%s %d", mapCase.Name, mapCase.Size);
+
+			printf("%10s %8d %10.1f %10.1f %10.1f %12.1f %14.3f %10d %10d\n",
+				name, expandLimit, getPercentile(times, 0.50), getPercentile(times, 0.99),
+				100.0 * partialCount / QUERY_COUNT, partialCount > 0 ? progressSum / partialCount : 0.0,
+				stitchedCount > 0 ? stitchedRatioSum / stitchedCount : 0.0, invalidCount, mismatchCount);
+		}
+	}
+
+	printf("\n");
+}
+
+// 쿼리 통계 (SearchStatistics) : 탐색 방식 별 쿼리 당 평균 통계와 시간, 가장 느린 쿼리들의 통계
+// 서버가 저장한 느린 쿼리 파일과 서버 맵을 주면 (query-stats PathFindSlowQueries.txt map.txt) 200x200 서버 맵에서 그 쿼리들을 다시 찾는다
+// PathFindService가 모은 분포의 쿼리 수와 느린 쿼리 목록의 순서도 확인한다
+// 통계를 세는 비용은 PATHFIND_STATISTICS_OFF로 빌드한 벤치마크의 시간과 비교한다
+static void benchQueryStatistics(void)
+{
+	struct MapCase
+	{
+		const char* Name;
+		int Size;
+		int CorridorWidth;		// 0이면 무작위 장애물 맵
+	};
+
+	struct ModeCase
+	{
+		const char* Name;
+		bool bJumpTable;
+		JPSPathFinder::ESearchMode SearchMode;
+	};
+
+	const MapCase MAP_CASES[] =
+	{
+		{ "maze", 500, 2 },
+		{ "random", 500, 0 },
+	};
+	const ModeCase MODE_CASES[] =
+	{
+		{ "JPS", false, JPSPathFinder::JumpPoint },
+		{ "JPS+", true, JPSPathFinder::JumpPoint },
+		{ "Theta*", false, JPSPathFinder::LazyThetaStar },
+	};
+	const int QUERY_COUNT = 1000;
+	const int SLOW_QUERY_COUNT = 3;
+
+#ifdef PATHFIND_STATISTICS_ON
+	printf("[query-stats] SearchStatistics per query (PATHFIND_STATISTICS_ON), averages and the slowest %d queries\n", SLOW_QUERY_COUNT);
+#else
+	printf("[query-stats] PATHFIND_STATISTICS_OFF : only created / expanded nodes are counted\n");
+#endif
+
+	printf("%12s %8s %10s %10s %10s %10s %10s %10s %10s\n",
+		"map", "mode", "p50 us", "p99 us", "created", "expanded", "scanned", "dec-key", "los cells");
+
+	auto runCase = [&](const char* mapName, PathFindMap& map, const std::vector<Query>& queries, int slowQueryCount)
+		{
+			for (const ModeCase& modeCase : MODE_CASES)
+			{
+				if (modeCase.bJumpTable)
+				{
+					map.EnableJumpTable();
+				}
+				else
+				{
+					map.DisableJumpTable();
+				}
+
+				JPSPathFinder pathFinder(map);
+				pathFinder.SetSearchMode(modeCase.SearchMode);
+
+				std::vector<double> times;
+				std::vector<std::pair<int64_t, int>> slowQueries;	// (시간, 쿼리 번호)
+				std::vector<SearchStatistics> statistics;
+				double sums[5] = {};
+
+				for (int i = 0; i < (int)queries.size(); ++i)
+				{
+					const Query& query = queries[i];
+
+					auto begin = std::chrono::steady_clock::now();
+					pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+					times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+
+					SearchStatistics queryStatistics = pathFinder.GetSearchStatistics();
+					statistics.push_back(queryStatistics);
+					slowQueries.push_back(std::make_pair(queryStatistics.ElapsedNanoseconds, i));
+
+					sums[0] += queryStatistics.CreatedNodeCount;
+					sums[1] += queryStatistics.ExpandedNodeCount;
+					sums[2] += queryStatistics.ScannedCellCount;
+					sums[3] += queryStatistics.DecreaseKeyCount;
+					sums[4] += queryStatistics.LineOfSightCellCount;
+				}
+
+				const double count = queries.empty() ? 1.0 : (double)queries.size();
+
+				printf("%12s %8s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+					mapName, modeCase.Name, getPercentile(times, 0.50), getPercentile(times, 0.99),
+					sums[0] / count, sums[1] / count, sums[2] / count, sums[3] / count, sums[4] / count);
+
+				std::sort(slowQueries.begin(), slowQueries.end(), std::greater<std::pair<int64_t, int>>());
+
+				for (int i = 0; i < slowQueryCount && i < (int)slowQueries.size(); ++i)
+				{
+					const Query& query = queries[slowQueries[i].second];
+					const SearchStatistics& queryStatistics = statistics[slowQueries[i].second];
+
+					printf("%12s %8s   (%d, %d) -> (%d, %d) : %.1f us, created %d, expanded %d, scanned %d, dec-key %d, los cells %d\n",
+						"", "slow", query.StartX, query.StartY, query.EndX, query.EndY, queryStatistics.ElapsedNanoseconds / 1000.0,
+						queryStatistics.CreatedNodeCount, queryStatistics.ExpandedNodeCount, queryStatistics.ScannedCellCount,
+						queryStatistics.DecreaseKeyCount, queryStatistics.LineOfSightCellCount);
+				}
+			}
+
+			map.DisableJumpTable();
+
+			// 서비스가 모은 분포와 느린 쿼리 목록
+			PathFindService service(map);
+			Path points;
+
+			for (const Query& query : queries)
+			{
+				service.PathFind(query.StartX, query.StartY, query.EndX, query.EndY, points);
+			}
+
+			PathFindService::QueryProfile profile = service.TakeQueryProfile();
+			std::vector<PathFindService::QueryRecord> serviceSlowQueries;
+			service.GetSlowQueries(serviceSlowQueries);
+
+			uint64_t elapsedSum = 0;
+			uint64_t expandedSum = 0;
+
+			for (int i = 0; i < PathFindService::QueryProfile::BUCKET_COUNT; ++i)
+			{
+				elapsedSum += profile.ElapsedHistogram[i];
+				expandedSum += profile.ExpandedHistogram[i];
+			}
+
+			bool bSorted = true;
+
+			for (int i = 1; i < (int)serviceSlowQueries.size(); ++i)
+			{
+				bSorted = bSorted && serviceSlowQueries[i - 1].Statistics.ElapsedNanoseconds >= serviceSlowQueries[i].Statistics.ElapsedNanoseconds;
+			}
+
+			printf("%12s %8s   %llu queries profiled (histogram sums %llu / %llu), %d slow queries kept, %s\n",
+				"", "service", (unsigned long long)profile.QueryCount, (unsigned long long)elapsedSum, (unsigned long long)expandedSum,
+				(int)serviceSlowQueries.size(), bSorted ? "sorted" : "NOT SORTED");
+		};
+
+	// 서버가 저장한 느린 쿼리를 서버 맵에서 다시 찾는다
+	if (g_traceFileName != nullptr && g_mapFileName != nullptr)
+	{
+		const int SERVER_MAP_SIZE = 200;
+
+		PathFindMap map(SERVER_MAP_SIZE, SERVER_MAP_SIZE);
+		std::vector<Query> queries = loadClickTrace(g_traceFileName);
+
+		if (MapFile::ReadText(g_mapFileName, map) == false || queries.empty())
+		{
+			printf("[query-stats] cannot read %s or %s\n\n", g_traceFileName, g_mapFileName);
+			return;
+		}
+
+		map.EnableComponents();
+		runCase("replay", map, queries, (int)queries.size());
+
+		printf("\n");
+		return;
+	}
+
+	for (const MapCase& mapCase : MAP_CASES)
+	{
+		TestMap testMap = mapCase.CorridorWidth > 0
+			? makeMazeMap(mapCase.Size, mapCase.CorridorWidth, 0.05, 51)
+			: TestMap(mapCase.Size, mapCase.Size, 0.3, 51);
+
+		PathFindMap map(mapCase.Size, mapCase.Size);
+		testMap.ApplyTo(map);
+		map.EnableComponents();
+
+		std::vector<Query> queries = makeQueries(testMap, QUERY_COUNT, 1, mapCase.Size - 1, 52);
+
+		char name[32];
+		snprintf(name, sizeof(name), "%s %d", mapCase.Name, mapCase.Size);
+
+		runCase(name, map, queries, SLOW_QUERY_COUNT);
+	}
+
+	printf("\n");
+}
+
+// 하드웨어 캐시 미스 카운터 (node-layout 벤치마크용)
+// 리눅스의 perf_event로만 읽고, 다른 플랫폼이거나 카운터를 열 수 없다면 (가상 머신 등) IsAvailable() == false
+class CacheMissCounter
+{
+public:
+	CacheMissCounter()
+	{
+#ifdef __linux__
+		perf_event_attr attribute;
+		memset(&attribute, 0, sizeof(attribute));
+		attribute.type = PERF_TYPE_HARDWARE;
+		attribute.size = sizeof(attribute);
+		attribute.config = PERF_COUNT_HW_CACHE_MISSES;
+		attribute.disabled = 1;
+		attribute.exclude_kernel = 1;
+		attribute.exclude_hv = 1;
+
+		mFile = (int)syscall(__NR_perf_event_open, &attribute, 0, -1, -1, 0);
+#endif
+	}
+
+	~CacheMissCounter()
+	{
+#ifdef __linux__
+		if (mFile >= 0)
+		{
+			close(mFile);
+		}
+#endif
+	}
+
+	CacheMissCounter(const CacheMissCounter& other) = delete;
+	CacheMissCounter& operator=(const CacheMissCounter& other) = delete;
+
+	inline bool IsAvailable() const { return mFile >= 0; }
+
+	void Start()
+	{
+#ifdef __linux__
+		if (mFile >= 0)
+		{
+			ioctl(mFile, PERF_EVENT_IOC_RESET, 0);
+			ioctl(mFile, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	// Start() 이후의 캐시 미스 수 (카운터가 없다면 0)
+	uint64_t Stop()
+	{
+		uint64_t count = 0;
+
+#ifdef __linux__
+		if (mFile >= 0)
+		{
+			ioctl(mFile, PERF_EVENT_IOC_DISABLE, 0);
+
+			if (read(mFile, &count, sizeof(count)) != sizeof(count))
+			{
+				count = 0;
+			}
+		}
+#endif
+
+		return count;
+	}
+
+private:
+	int mFile = -1;
+};
+
+// 노드 저장 방식의 비용 : 확장 한 번 당 시간과 캐시 미스, 탐색 상태의 크기
+// 노드는 NodeArena의 SoA 배열(좌표 16비트, G, 부모 번호, H)에, OPEN LIST는 (F, H, 노드 번호) 키에 둔다
+// "state KB"는 쿼리들을 모두 찾은 뒤의 GridSearchState 크기 (셀 별 상태 + 노드 배열 + OPEN LIST), "node B"는 쿼리 당 노드와 키가 차지한 크기
+// 캐시 미스는 하드웨어 카운터를 읽을 수 있을 때만 (리눅스 perf_event) 나오고, 아니라면 "-" (윈도우에서는 VTune 등으로 확인)
+// 2000x2000 맵은 탐색 상태가 캐시에 들어가지 않으므로 확장 한 번 당 시간이 캐시 미스를 대신 보여준다
+static void benchNodeLayout(void)
+{
+	struct MapCase
+	{
+		const char* Name;
+		int Size;
+		int CorridorWidth;		// 0이면 무작위 장애물 맵
+		int QueryCount;
+	};
+
+	const MapCase MAP_CASES[] =
+	{
+		{ "random", 500, 0, 300 },
+		{ "maze", 500, 2, 100 },
+		{ "random", 2000, 0, 40 },
+	};
+
+	const int BYTES_PER_NODE = NodeArena::BYTES_PER_NODE + (int)sizeof(OpenListKey) + (int)sizeof(int);
+
+	CacheMissCounter cacheMissCounter;
+
+	printf("[node-layout] %d B per node (arena %d + open list key %d + heap position %d)\n",
+		BYTES_PER_NODE, (int)NodeArena::BYTES_PER_NODE, (int)sizeof(OpenListKey), (int)sizeof(int));
+	printf("%12s %8s %10s %10s %10s %12s %10s %10s\n", "map", "finder", "expanded", "ns/expand", "us/query", "miss/expand", "state KB", "node B");
+
+	for (const MapCase& mapCase : MAP_CASES)
+	{
+		TestMap testMap = mapCase.CorridorWidth > 0
+			? makeMazeMap(mapCase.Size, mapCase.CorridorWidth, 0.05, 61)
+			: TestMap(mapCase.Size, mapCase.Size, 0.3, 61);
+
+		PathFindMap map(mapCase.Size, mapCase.Size);
+		testMap.ApplyTo(map);
+
+		std::vector<Query> queries = makeQueries(testMap, mapCase.QueryCount, mapCase.Size / 4, mapCase.Size - 1, 62);
+
+		char name[32];
+		snprintf(name, sizeof(name), "%s %d", mapCase.Name, mapCase.Size);
+
+		auto runCase = [&](const char* finderName, auto& pathFinder)
+			{
+				uint64_t expandedNodeCount = 0;
+				uint64_t allocatedNodeCount = 0;
+
+				// 한 번 찾아서 탐색 상태를 최대 크기까지 키운다 (시간은 두 번째에 잰다)
+				for (const Query& query : queries)
+				{
+					pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+					expandedNodeCount += pathFinder.GetExpandedNodeCount();
+					allocatedNodeCount += pathFinder.GetAllocatedNodeCount();
+				}
+
+				cacheMissCounter.Start();
+				auto begin = std::chrono::steady_clock::now();
+
+				for (const Query& query : queries)
+				{
+					pathFinder.PathFind(query.StartX, query.StartY, query.EndX, query.EndY);
+				}
+
+				auto end = std::chrono::steady_clock::now();
+				uint64_t cacheMissCount = cacheMissCounter.Stop();
+
+				const double nanoseconds = std::chrono::duration<double, std::nano>(end - begin).count();
+				const double expanded = expandedNodeCount > 0 ? (double)expandedNodeCount : 1.0;
+
+				char cacheMiss[16];
+				snprintf(cacheMiss, sizeof(cacheMiss), cacheMissCounter.IsAvailable() ? "%.2f" : "-", cacheMissCount / expanded);
+
+				printf("%12s %8s %10.0f %10.1f %10.1f %12s %10zu %10.0f\n",
+					name, finderName, expandedNodeCount / (double)queries.size(), nanoseconds / expanded,
+					nanoseconds / 1000.0 / queries.size(), cacheMiss, pathFinder.GetReservedBytes() / 1024,
+					(double)allocatedNodeCount * BYTES_PER_NODE / queries.size());
+			};
+
+		{
+			AStarPathFinder pathFinder(mapCase.Size, mapCase.Size);
+			testMap.ApplyTo(pathFinder);
+			runCase("A*", pathFinder);
+		}
+
+		{
+			JPSPathFinder pathFinder(map);
+			runCase("JPS", pathFinder);
+
+			pathFinder.SetSearchMode(JPSPathFinder::LazyThetaStar);
+			runCase("Theta*", pathFinder);
+		}
+	}
+
+	printf("\n");
+}
+
+static const Benchmark BENCHMARKS[] =
+{
+	{ "verify", benchVerify },
+	{ "map-size", benchMapSize },
+	{ "open-list", benchOpenList },
+	{ "jump-table", benchJumpTable },
+	{ "service", benchService },
+	{ "async", benchAsync },
+	{ "cache", benchCache },
+	{ "hpa", benchHierarchical },
+	{ "batch", benchBatch },
+	{ "alloc", benchAllocation },
+	{ "line-of-sight", benchLineOfSight },
+	{ "theta", benchLazyTheta },
+	{ "components", benchComponents },
+	{ "flow-field", benchFlowField },
+	{ "replan", benchReplan },
+	{ "landmarks", benchLandmarks },
+	{ "goal-bounds", benchGoalBounds },
+	{ "map-file", benchMapFile },
+	{ "movingai", benchMovingAI },
+	{ "slice", benchSlice },
+	{ "partial", benchPartialPath },
+	{ "query-stats", benchQueryStatistics },
+	{ "node-layout", benchNodeLayout },
+};
+
+int main(int argc, char* argv[])
+{
+	// cache 벤치마크는 두 번째 인자로 클릭 기록 파일을, movingai 벤치마크는 .scen 파일과 (세 번째 인자로) .map 파일을 받는다
+	// query-stats 벤치마크는 서버가 저장한 느린 쿼리 파일과 (세 번째 인자로) 서버의 map.txt를 받는다
+	if (argc >= 3)
+	{
+		g_traceFileName = argv[2];
+		g_scenarioFileName = argv[2];
+	}
+
+	if (argc >= 4)
+	{
+		g_mapFileName = argv[3];
+	}
+
+	for (const Benchmark& benchmark : BENCHMARKS)
+	{
+		if (argc >= 2 && strcmp(argv[1], benchmark.Name) != 0)
+		{
+			continue;
+		}
+
+		benchmark.Run();
+	}
+
+	return 0;
+}
@@ -1,211 +1,78 @@
 #pragma once
 
-#include "PriorityQueue.h"
-#include <list>
-#include "Line.h"
 #include "Point.h"
+#include "Path.h"
+#include "PathFindMap.h"
+#include "GridSearch.h"
 
 class AStarPathFinder
 {
 public:
 	AStarPathFinder(int mapWidth, int mapHeight)
-		: mWidth(mapWidth)
-		, mHeight(mapHeight)
-		, mOpenList(mapWidth* mapHeight)
+		: mMap(mapWidth, mapHeight)
+		, mState(mMap.GetGrid())
 	{
-		mMap = new bool* [mapHeight];
-		mG = new int* [mapHeight];
-
-		for (int i = 0; i < mapHeight; ++i)
-		{
-			mMap[i] = new bool[mapWidth];
-			mG[i] = new int[mapWidth];
-
-			for (int j = 0; j < mapWidth; ++j)
-			{
-				mMap[i][j] = true;
-				mG[i][j] = -1;
-			}
-		}
 	}
 
-	~AStarPathFinder()
-	{
-		for (int i = 0; i < mHeight; ++i)
-		{
-			delete[] mMap[i];
-			delete[] mG[i];
-		}
+	AStarPathFinder(const AStarPathFinder& other) = delete;
+	AStarPathFinder& operator=(const AStarPathFinder& other) = delete;
 
-		delete mMap;
-		delete mG;
-	}
+	inline const Path& GetPoints() const { return mPoints; }
+	inline void Block(int x, int y) { mMap.Block(x, y); }
+	inline void UnBlock(int x, int y) { mMap.UnBlock(x, y); }
+	inline bool IsBlocked(int x, int y) const { return mMap.IsBlocked(x, y); }
 
-	inline std::list<Point> GetPoints() { return mPoints; }
-	inline void Block(int x, int y) { mMap[y][x] = false; }
-	inline void UnBlock(int x, int y) { mMap[y][x] = true; }
-	inline bool IsBlocked(int x, int y)
-	{
-		// out of range
-		if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
-		{
-			return true;
-		}
+	// 마지막으로 찾은 경로의 비용 (경로를 줄이기 전 G값, 경로가 없었다면 -1)
+	inline int GetPathCost() const { return mPathCost; }
 
-		return !mMap[y][x];
-	}
+	// 마지막 탐색에서 OPEN LIST에서 꺼내 확장한 노드 수
+	inline int GetExpandedNodeCount() const { return mState.GetExpandedNodeCount(); }
+
+	// 마지막 탐색에서 OPEN LIST에 넣고, 꺼내고, 키를 줄인 횟수와 만든 노드 수
+	inline int GetHeapOperationCount() const { return mState.GetHeapOperationCount(); }
+	inline int GetAllocatedNodeCount() const { return mState.GetAllocatedNodeCount(); }
 
-	inline const std::list<Point>::iterator Begin() { return mPoints.begin(); }
-	inline const std::list<Point>::iterator End() { return mPoints.end(); }
+	// 탐색 상태(OPEN LIST, 셀 별 노드 번호, 노드 배열)의 총 크기 (byte), 맵은 포함하지 않는다
+	inline size_t GetReservedBytes() const { return mState.GetReservedBytes(); }
 
-	const std::list<Point>::iterator PathFind(int startX, int startY, int endX, int endY)
+	inline const Point* Begin() const { return mPoints.Begin(); }
+	inline const Point* End() const { return mPoints.End(); }
+
+	const Point* PathFind(int startX, int startY, int endX, int endY)
 	{
 		//PROFILE(L"AStar");
+		Clear();
 
-		if (startX < 0 || endX < 0 || startX >= mWidth || startY >= mHeight)
-		{
-			return End();
-		}
-
-		if (mMap[startY][startX] == false || mMap[endY][endX] == false)
+		if (IsBlocked(startX, startY) || IsBlocked(endX, endY))
 		{
 			return End();
 		}
 
-		Clear();
-
-		Node* startNode = new Node(startX, startY, 0, nullptr, endX, endY);
-		mOpenList.Push(startNode);
+		GridSearch<NeighborSuccessors, OctileHeuristic<>> search(mState, NeighborSuccessors(mMap.GetGrid()), OctileHeuristic<>(endX, endY));
+		NodeIndex destination = search.Search(startX, startY, endX, endY);
 
-		while (mOpenList.Empty() == false)
+		if (destination != NULL_NODE)
 		{
-			Node* currentNode = mOpenList.Top();
-			mOpenList.Pop();
-
-			// Find
-			if (currentNode->X == endX && currentNode->Y == endY)
-			{
-				reduceNodes(currentNode);
-
-				Node* visit = currentNode;
-				while (visit != nullptr)
-				{
-					mPoints.push_front(Point{ visit->X, visit->Y });
-					visit = visit->Parent;
-				}
-
-				break;
-			}
-
-			// 8방향 검사
-			// 8방향에 대한 상대 좌표 값
-			const int X_RELATIVE[8] = { -1, -1,  0,  1,  1,  1,  0, -1 };
-			const int Y_RELATIVE[8] = { 0, -1, -1, -1,  0,  1,  1,  1 };
-			const int G_RELATIVE[8] = { 5,  7,  5,  7,  5,  7,  5,  7 };
-
-			for (int i = 0; i < 8; ++i)
-			{
-				int x = currentNode->X + X_RELATIVE[i];
-				int y = currentNode->Y + Y_RELATIVE[i];
-				int g = currentNode->G + G_RELATIVE[i];
-
-				if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
-				{
-					continue;
-				}
-
-				if (mMap[y][x] == false)
-				{
-					continue;
-				}
-
-				if (mG[y][x] != -1 && g >= mG[y][x])
-				{
-					continue;
-				}
-
-				if (mG[y][x] != -1 && g < mG[y][x])
-				{
-					int outIndex;
-					Node* node = mOpenList.GetNodeOrNull(x, y, outIndex);
-					assert(node != nullptr);
-
-					node->G = g;
-					node->F = node->G + node->H;
-					mG[y][x] = node->G;
-					node->Parent = currentNode;
-
-					mOpenList.RepairHeap(outIndex);
-				}
-				else
-				{
-					Node* newNode = new Node(x, y, g, currentNode, endX, endY);
-					mG[y][x] = newNode->G;
-
-					mOpenList.Push(newNode);
-				}
-			}
+			mPathCost = mState.GetNodeArena().GetG(destination);
+			mState.ReduceNodes(destination);
 		}
 
+		mState.CopyPoints(destination, mPoints);
+
 		return Begin();
 	}
 
 	void Clear()
 	{
-		mPoints.clear();
-		mOpenList.Clear();
-
-		for (int i = 0; i < mHeight; ++i)
-		{
-			for (int j = 0; j < mWidth; ++j)
-			{
-				mG[i][j] = -1;
-			}
-		}
+		mPoints.Clear();
+		mPathCost = -1;
+		mState.Clear();
 	}
 
 private:
-	// 불필요한 중간 노드들의 연결을 끊는다
-	void reduceNodes(Node* destination) const
-	{
-		Node* startNode = destination;
-		Node* endNode = destination->Parent;
-
-		while (endNode != nullptr)
-		{
-			if (canIgnore(startNode, endNode))
-			{
-				startNode->Parent = endNode;
-				endNode = endNode->Parent;
-			}
-			else
-			{
-				startNode = startNode->Parent;
-			}
-		}
-	}
+	Path mPoints;
+	int mPathCost = -1;
 
-	// start ~ end 사이에 벽에 걸리는 것이 없는가
-	bool canIgnore(const Node* start, const Node* end) const
-	{
-		Line line(start->X, start->Y, end->X, end->Y);
-
-		for (auto it = line.Begin(); it != line.End(); ++it)
-		{
-			if (mMap[(*it).Y][(*it).X] == false)
-			{
-				return false;
-			}
-		}
-
-		return true;
-	}
-private:
-	std::list<Point> mPoints;
-	PriorityQueue mOpenList;
-
-	const int mWidth;
-	const int mHeight;
-	bool** mMap;
-	int** mG;
-};
\ No newline at end of file
+	PathFindMap mMap;
+	GridSearchState mState;
+};
@@ -0,0 +1,250 @@
+// 비트 단위로 압축한 이동 가능 여부 맵
+// 가로 한 줄을 64비트 워드 배열로 저장하고 (1 = 이동 가능), 세로 탐색을 위해 전치한 사본을 같이 유지합니다.
+// 맵 바깥은 모두 막힌 칸으로 취급하도록, 위 아래(전치본은 좌우)에 0으로 채운 줄을 하나씩 더 둡니다.
+// JPS의 직선 탐색은 ScanForward() / ScanBackward()로 한 번에 64칸씩 검사합니다.
+
+/************************************** 사용법 **************************************/
+// BitGrid grid(width, height);
+// grid.SetWalkable(x, y, false);
+//
+// // (x, y)부터 오른쪽으로, 막힌 칸이나 강제 이웃이 생기는 칸을 찾는다
+// int stopX = BitGrid::ScanForward(grid.GetRow(y), grid.GetRow(y - 1), grid.GetRow(y + 1), grid.GetWordsPerRow(), x);
+/************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+class BitGrid
+{
+public:
+	BitGrid(int width, int height)
+		: mWidth(width)
+		, mHeight(height)
+		, mWordsPerRow((width + 63) / 64)
+		, mWordsPerColumn((height + 63) / 64)
+	{
+		mRows = new uint64_t[(height + 2) * mWordsPerRow]();
+		mColumns = new uint64_t[(width + 2) * mWordsPerColumn]();
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				SetWalkable(x, y, true);
+			}
+		}
+	}
+
+	~BitGrid()
+	{
+		if (mbOwnsWords)
+		{
+			delete[] mRows;
+			delete[] mColumns;
+		}
+	}
+
+	BitGrid(const BitGrid& other) = delete;
+	BitGrid& operator=(const BitGrid& other) = delete;
+
+	inline int GetWidth() const { return mWidth; }
+	inline int GetHeight() const { return mHeight; }
+	inline int GetWordsPerRow() const { return mWordsPerRow; }
+	inline int GetWordsPerColumn() const { return mWordsPerColumn; }
+
+	// 가로, 세로 비트 배열의 총 크기 (byte)
+	inline size_t GetReservedBytes() const
+	{
+		return (static_cast<size_t>(mHeight + 2) * mWordsPerRow + static_cast<size_t>(mWidth + 2) * mWordsPerColumn) * sizeof(uint64_t);
+	}
+
+	// 범위 검사를 하지 않으므로 맵 안의 좌표만 넣어야 한다
+	inline bool IsWalkable(int x, int y) const
+	{
+		return (GetRow(y)[x >> 6] >> (x & 63)) & 1;
+	}
+
+	// 밖에서 채운 워드 배열(맵 파일의 매핑 등)을 복사 없이 그대로 사용한다 (해제하지 않으므로 이 객체보다 오래 살아 있어야 한다)
+	// 배치는 GetRow(-1), GetColumn(-1)부터의 배열과 같아야 하고, 고쳐도 되는 메모리여야 한다 (SetWalkable())
+	void Attach(uint64_t* rows, uint64_t* columns)
+	{
+		if (mbOwnsWords)
+		{
+			delete[] mRows;
+			delete[] mColumns;
+		}
+
+		mRows = rows;
+		mColumns = columns;
+		mbOwnsWords = false;
+	}
+
+	inline void SetWalkable(int x, int y, bool bWalkable)
+	{
+		uint64_t* rowWord = mRows + (y + 1) * mWordsPerRow + (x >> 6);
+		uint64_t* columnWord = mColumns + (x + 1) * mWordsPerColumn + (y >> 6);
+
+		if (bWalkable)
+		{
+			*rowWord |= 1ull << (x & 63);
+			*columnWord |= 1ull << (y & 63);
+		}
+		else
+		{
+			*rowWord &= ~(1ull << (x & 63));
+			*columnWord &= ~(1ull << (y & 63));
+		}
+	}
+
+	// y번째 가로줄 (y = -1, y = height 는 모두 막힌 줄)
+	inline const uint64_t* GetRow(int y) const { return mRows + (y + 1) * mWordsPerRow; }
+
+	// x번째 세로줄 (x = -1, x = width 는 모두 막힌 줄)
+	inline const uint64_t* GetColumn(int x) const { return mColumns + (x + 1) * mWordsPerColumn; }
+
+	// line의 from 위치부터 인덱스가 커지는 방향으로 진행하면서, 처음으로 아래 조건을 만족하는 위치를 반환한다
+	// 1. line이 막혀 있다
+	// 2. 옆 줄(sideA 또는 sideB)의 현재 칸은 막혀 있고, 다음 칸은 뚫려 있다 (강제 이웃)
+	// 줄 끝까지 없다면 줄 길이 이상의 값을 반환한다 (줄 바깥은 막힌 칸)
+	static int ScanForward(const uint64_t* line, const uint64_t* sideA, const uint64_t* sideB, int wordCount, int from)
+	{
+		int wordIndex = from >> 6;
+		uint64_t ignoreMask = ~0ull << (from & 63);
+
+		for (; wordIndex < wordCount; ++wordIndex)
+		{
+			uint64_t nextA = wordIndex + 1 < wordCount ? sideA[wordIndex + 1] : 0;
+			uint64_t nextB = wordIndex + 1 < wordCount ? sideB[wordIndex + 1] : 0;
+
+			uint64_t aheadA = (sideA[wordIndex] >> 1) | (nextA << 63);
+			uint64_t aheadB = (sideB[wordIndex] >> 1) | (nextB << 63);
+
+			uint64_t stop = ~line[wordIndex] | (~sideA[wordIndex] & aheadA) | (~sideB[wordIndex] & aheadB);
+			stop &= ignoreMask;
+
+			if (stop != 0)
+			{
+				return (wordIndex << 6) + findFirstSetBit(stop);
+			}
+
+			ignoreMask = ~0ull;
+		}
+
+		return wordCount << 6;
+	}
+
+	// ScanForward()와 같지만 인덱스가 작아지는 방향으로 진행한다
+	// 줄 처음까지 없다면 -1을 반환한다 (0번 워드에서 끝나므로 워드 수는 필요 없다)
+	static int ScanBackward(const uint64_t* line, const uint64_t* sideA, const uint64_t* sideB, int from)
+	{
+		int wordIndex = from >> 6;
+		uint64_t ignoreMask = ~0ull >> (63 - (from & 63));
+
+		for (; wordIndex >= 0; --wordIndex)
+		{
+			uint64_t prevA = wordIndex > 0 ? sideA[wordIndex - 1] : 0;
+			uint64_t prevB = wordIndex > 0 ? sideB[wordIndex - 1] : 0;
+
+			uint64_t aheadA = (sideA[wordIndex] << 1) | (prevA >> 63);
+			uint64_t aheadB = (sideB[wordIndex] << 1) | (prevB >> 63);
+
+			uint64_t stop = ~line[wordIndex] | (~sideA[wordIndex] & aheadA) | (~sideB[wordIndex] & aheadB);
+			stop &= ignoreMask;
+
+			if (stop != 0)
+			{
+				return (wordIndex << 6) + findLastSetBit(stop);
+			}
+
+			ignoreMask = ~0ull;
+		}
+
+		return -1;
+	}
+
+	// line의 from ~ to (양 끝 포함, from <= to) 칸이 모두 뚫려 있는가 (워드 단위로 검사)
+	static bool IsRangeWalkable(const uint64_t* line, int from, int to)
+	{
+		const int fromWord = from >> 6;
+		const int toWord = to >> 6;
+		const uint64_t fromMask = ~0ull << (from & 63);
+		const uint64_t toMask = ~0ull >> (63 - (to & 63));
+
+		if (fromWord == toWord)
+		{
+			const uint64_t mask = fromMask & toMask;
+			return (line[fromWord] & mask) == mask;
+		}
+
+		if ((line[fromWord] & fromMask) != fromMask)
+		{
+			return false;
+		}
+
+		for (int wordIndex = fromWord + 1; wordIndex < toWord; ++wordIndex)
+		{
+			if (line[wordIndex] != ~0ull)
+			{
+				return false;
+			}
+		}
+
+		return (line[toWord] & toMask) == toMask;
+	}
+
+private:
+	// word != 0
+	inline static int findFirstSetBit(uint64_t word)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return static_cast<int>(index);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+		{
+			return static_cast<int>(index);
+		}
+		_BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+		return static_cast<int>(index) + 32;
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	// word != 0
+	inline static int findLastSetBit(uint64_t word)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanReverse64(&index, word);
+		return static_cast<int>(index);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanReverse(&index, static_cast<unsigned long>(word >> 32)))
+		{
+			return static_cast<int>(index) + 32;
+		}
+		_BitScanReverse(&index, static_cast<unsigned long>(word));
+		return static_cast<int>(index);
+#else
+		return 63 - __builtin_clzll(word);
+#endif
+	}
+
+private:
+	const int mWidth;
+	const int mHeight;
+	const int mWordsPerRow;
+	const int mWordsPerColumn;
+	uint64_t* mRows;		// (height + 2) 줄, 첫 줄과 마지막 줄은 맵 바깥
+	uint64_t* mColumns;		// (width + 2) 줄, 첫 줄과 마지막 줄은 맵 바깥
+	bool mbOwnsWords = true;	// Attach()한 배열이라면 false
+};
@@ -0,0 +1,492 @@
+// 이동 가능한 칸들의 연결 요소 (8방향, 모서리 통과 허용)
+// 칸마다 연결 요소 번호를 기록해두고, 시작 칸과 도착 칸의 번호가 다르면 탐색 없이 바로 "경로 없음"으로 처리합니다.
+// 번호는 union-find로 관리합니다.
+// - 칸이 뚫리면 주변 칸들의 연결 요소를 바로 합칩니다.
+// - 칸이 막히면 연결 요소가 나뉠 수도 있지만 바로 다시 번호를 매기지 않고, 그 연결 요소를 "나뉘었을 수 있음"으로 표시만 해둡니다.
+//   표시된 연결 요소 안의 두 칸은 실제로 끊겨 있어도 같은 번호로 보이므로 (탐색으로 확인), 결과가 틀리지는 않고 거절을 못할 뿐입니다.
+//   Refresh()를 호출하면 표시된 연결 요소만 다시 번호를 매깁니다.
+
+/************************************** 사용법 **************************************/
+// ConnectedComponents components(grid);
+// components.Build();
+//
+// if (components.IsInSameComponent(startX, startY, endX, endY) == false)
+// {
+//     // 경로 없음
+// }
+//
+// // 칸이 바뀔 때마다 (grid를 바꾼 뒤)
+// components.OnCellChanged(x, y);
+//
+// // 탐색하는 스레드가 없을 때 (나뉜 연결 요소 정리)
+// components.Refresh();
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "BitGrid.h"
+#include "GridDirection.h"
+
+class ConnectedComponents
+{
+public:
+	ConnectedComponents(const BitGrid& grid)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+	{
+		mLabels = new uint32_t[mWidth * mHeight];
+	}
+
+	// 이미 매겨둔 번호(맵 파일의 매핑 등)를 사용한다 (Build() 불필요)
+	// 칸 번호 배열은 복사 없이 그대로 쓰고 (해제하지 않는다, 고쳐도 되는 메모리여야 한다), union-find 배열은 복사한다
+	// 나뉘었을 수 있음으로 표시된 연결 요소가 없던 상태여야 한다
+	ConnectedComponents(const BitGrid& grid, uint32_t* labels, const uint32_t* parents, const uint32_t* cellCounts, int labelCount)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+		, mLabels(labels)
+		, mParents(parents, parents + labelCount)
+		, mCellCounts(cellCounts, cellCounts + labelCount)
+		, mDirtyFlags(labelCount, 0)
+		, mbOwnsLabels(false)
+	{
+	}
+
+	~ConnectedComponents()
+	{
+		if (mbOwnsLabels)
+		{
+			delete[] mLabels;
+		}
+	}
+
+	ConnectedComponents(const ConnectedComponents& other) = delete;
+	ConnectedComponents& operator=(const ConnectedComponents& other) = delete;
+
+	// 모든 칸의 번호를 새로 매긴다
+	void Build()
+	{
+		mParents.clear();
+		mCellCounts.clear();
+		mDirtyFlags.clear();
+		mDirtyCount = 0;
+
+		for (int i = 0; i < mWidth * mHeight; ++i)
+		{
+			mLabels[i] = NO_COMPONENT;
+		}
+
+		for (int y = 0; y < mHeight; ++y)
+		{
+			for (int x = 0; x < mWidth; ++x)
+			{
+				if (mGrid.IsWalkable(x, y) && mLabels[y * mWidth + x] == NO_COMPONENT)
+				{
+					floodFill(x, y, newLabel());
+				}
+			}
+		}
+	}
+
+	// (startX, startY)와 (endX, endY)가 같은 연결 요소인가 (두 칸 모두 이동 가능해야 한다)
+	// false라면 확실히 경로가 없다. true라도 나뉘었을 수 있음으로 표시된 연결 요소라면 경로가 없을 수 있다
+	inline bool IsInSameComponent(int startX, int startY, int endX, int endY) const
+	{
+		return findRoot(mLabels[startY * mWidth + startX]) == findRoot(mLabels[endY * mWidth + endX]);
+	}
+
+	// 나뉘었을 수 있음으로 표시된 연결 요소가 있는가
+	inline bool IsDirty() const { return mDirtyCount > 0; }
+
+	// 맵 파일 저장용 (칸 번호는 width * height 개, union-find 배열은 GetLabelCount() 개)
+	inline int GetLabelCount() const { return static_cast<int>(mParents.size()); }
+	inline const uint32_t* GetLabels() const { return mLabels; }
+	inline const uint32_t* GetParents() const { return mParents.data(); }
+	inline const uint32_t* GetCellCounts() const { return mCellCounts.data(); }
+
+	// 칸 번호 + union-find 배열의 총 크기 (byte)
+	inline size_t GetReservedBytes() const
+	{
+		return sizeof(uint32_t) * mWidth * mHeight
+			+ mParents.capacity() * sizeof(uint32_t) + mCellCounts.capacity() * sizeof(uint32_t) + mDirtyFlags.capacity();
+	}
+
+	// (x, y)의 이동 가능 여부가 바뀐 뒤 호출한다
+	void OnCellChanged(int x, int y)
+	{
+		uint32_t& label = mLabels[y * mWidth + x];
+
+		if (mGrid.IsWalkable(x, y))
+		{
+			// 뚫림 : 주변 연결 요소들을 하나로 합친다
+			label = NO_COMPONENT;
+
+			for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+			{
+				int neighborX = x + GridDirection::X[direction];
+				int neighborY = y + GridDirection::Y[direction];
+
+				if (isWalkable(neighborX, neighborY) == false)
+				{
+					continue;
+				}
+
+				uint32_t neighborRoot = compressRoot(mLabels[neighborY * mWidth + neighborX]);
+
+				label = label == NO_COMPONENT ? neighborRoot : unite(label, neighborRoot);
+			}
+
+			if (label == NO_COMPONENT)
+			{
+				label = newLabel();
+			}
+			else
+			{
+				mCellCounts[label]++;
+			}
+
+			return;
+		}
+
+		// 막힘 : 주변의 이동 가능한 칸들이 서로 이어져 있다면 나뉘지 않는다
+		if (label == NO_COMPONENT)
+		{
+			return;
+		}
+
+		uint32_t root = compressRoot(label);
+		label = NO_COMPONENT;
+		mCellCounts[root]--;
+
+		if (mDirtyFlags[root] == false && canSplit(x, y) && isConnectedNearby(x, y) == false)
+		{
+			mDirtyFlags[root] = true;
+			mDirtyCount++;
+		}
+	}
+
+	// 나뉘었을 수 있음으로 표시된 연결 요소들만 다시 번호를 매긴다
+	void Refresh()
+	{
+		if (mDirtyCount == 0)
+		{
+			return;
+		}
+
+		// 버려진 번호가 쌓였다면 전부 새로 매긴다
+		if (mParents.size() > static_cast<size_t>(mWidth) * mHeight / 2 + MIN_LABEL_COUNT_TO_REBUILD)
+		{
+			Build();
+			return;
+		}
+
+		for (int y = 0; y < mHeight; ++y)
+		{
+			for (int x = 0; x < mWidth; ++x)
+			{
+				uint32_t label = mLabels[y * mWidth + x];
+
+				// 이미 새 번호를 받은 칸의 루트는 표시되어 있지 않다
+				if (label != NO_COMPONENT && mDirtyFlags[findRoot(label)])
+				{
+					floodFill(x, y, newLabel());
+				}
+			}
+		}
+
+		for (size_t i = 0; i < mDirtyFlags.size(); ++i)
+		{
+			mDirtyFlags[i] = false;
+		}
+
+		mDirtyCount = 0;
+	}
+
+private:
+	inline bool isWalkable(int x, int y) const
+	{
+		return x >= 0 && x < mWidth && y >= 0 && y < mHeight && mGrid.IsWalkable(x, y);
+	}
+
+	uint32_t newLabel()
+	{
+		uint32_t label = static_cast<uint32_t>(mParents.size());
+
+		mParents.push_back(label);
+		mCellCounts.push_back(1);
+		mDirtyFlags.push_back(false);
+
+		return label;
+	}
+
+	// (x, y)와 이어진 칸 중 아직 label을 받지 않은 칸들에 label을 매긴다
+	// 서로 이웃한 이동 가능 칸은 항상 같은 연결 요소이므로, 이어진 칸들은 모두 같은 (이전) 연결 요소에 속한다
+	void floodFill(int x, int y, uint32_t label)
+	{
+		uint32_t cellCount = 0;
+
+		mLabels[y * mWidth + x] = label;
+		mFillStack.push_back(y * mWidth + x);
+
+		while (mFillStack.empty() == false)
+		{
+			int cell = mFillStack.back();
+			mFillStack.pop_back();
+			cellCount++;
+
+			int cellX = cell % mWidth;
+			int cellY = cell / mWidth;
+
+			for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+			{
+				int neighborX = cellX + GridDirection::X[direction];
+				int neighborY = cellY + GridDirection::Y[direction];
+
+				if (isWalkable(neighborX, neighborY) == false)
+				{
+					continue;
+				}
+
+				uint32_t& neighborLabel = mLabels[neighborY * mWidth + neighborX];
+
+				if (neighborLabel == label)
+				{
+					continue;
+				}
+
+				neighborLabel = label;
+				mFillStack.push_back(neighborY * mWidth + neighborX);
+			}
+		}
+
+		mCellCounts[label] = cellCount;
+	}
+
+	// 막힌 (x, y) 주변 8칸 중 이동 가능한 칸들이 (x, y)를 거치지 않고 서로 이어져 있지 않다면 true
+	// 주변 8칸을 방향 번호 순서(시계 방향)로 돌면서 이웃한 칸끼리, 그리고 상하좌우 칸은 대각선으로 이웃한 다음 상하좌우 칸과 이어진다
+	bool canSplit(int x, int y) const
+	{
+		bool bWalkables[GridDirection::COUNT];
+
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+		{
+			bWalkables[direction] = isWalkable(x + GridDirection::X[direction], y + GridDirection::Y[direction]);
+		}
+
+		int groups[GridDirection::COUNT];
+
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+		{
+			groups[direction] = direction;
+		}
+
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+		{
+			if (bWalkables[direction] == false)
+			{
+				continue;
+			}
+
+			int next = (direction + 1) % GridDirection::COUNT;
+
+			if (bWalkables[next])
+			{
+				mergeGroup(groups, direction, next);
+			}
+
+			// 상하좌우 칸 (짝수 번째)
+			int nextSide = (direction + 2) % GridDirection::COUNT;
+
+			if (GridDirection::IsDiagonal(direction) == false && bWalkables[nextSide])
+			{
+				mergeGroup(groups, direction, nextSide);
+			}
+		}
+
+		int firstGroup = -1;
+
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+		{
+			if (bWalkables[direction] == false)
+			{
+				continue;
+			}
+
+			if (firstGroup == -1)
+			{
+				firstGroup = groups[direction];
+			}
+			else if (groups[direction] != firstGroup)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// 막힌 (x, y) 주변의 이동 가능한 8칸이 (x, y) 중심의 작은 창 안에서 돌아서라도 모두 이어지는가
+	// 벽 끝을 막은 경우처럼 주변 칸끼리는 끊겨 보여도 가까이에서 이어지는 경우가 많으므로, 표시하기 전에 한 번 더 확인한다
+	bool isConnectedNearby(int x, int y)
+	{
+		bool bVisited[WINDOW_SIZE][WINDOW_SIZE] = {};
+		int ringCount = 0;
+		int reachedRingCount = 0;
+
+		mFillStack.clear();
+
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+		{
+			if (isWalkable(x + GridDirection::X[direction], y + GridDirection::Y[direction]))
+			{
+				if (ringCount == 0)
+				{
+					bVisited[WINDOW_RADIUS + GridDirection::Y[direction]][WINDOW_RADIUS + GridDirection::X[direction]] = true;
+					mFillStack.push_back((WINDOW_RADIUS + GridDirection::Y[direction]) * WINDOW_SIZE + WINDOW_RADIUS + GridDirection::X[direction]);
+				}
+
+				ringCount++;
+			}
+		}
+
+		while (mFillStack.empty() == false)
+		{
+			int cell = mFillStack.back();
+			mFillStack.pop_back();
+
+			int localX = cell % WINDOW_SIZE;
+			int localY = cell / WINDOW_SIZE;
+
+			if (localX >= WINDOW_RADIUS - 1 && localX <= WINDOW_RADIUS + 1 && localY >= WINDOW_RADIUS - 1 && localY <= WINDOW_RADIUS + 1)
+			{
+				reachedRingCount++;
+
+				if (reachedRingCount == ringCount)
+				{
+					mFillStack.clear();
+					return true;
+				}
+			}
+
+			for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+			{
+				int nextX = localX + GridDirection::X[direction];
+				int nextY = localY + GridDirection::Y[direction];
+
+				if (nextX < 0 || nextX >= WINDOW_SIZE || nextY < 0 || nextY >= WINDOW_SIZE || bVisited[nextY][nextX])
+				{
+					continue;
+				}
+
+				if (isWalkable(x + nextX - WINDOW_RADIUS, y + nextY - WINDOW_RADIUS) == false)
+				{
+					continue;
+				}
+
+				bVisited[nextY][nextX] = true;
+				mFillStack.push_back(nextY * WINDOW_SIZE + nextX);
+			}
+		}
+
+		return false;
+	}
+
+	// groups의 a가 속한 모임과 b가 속한 모임을 합친다 (모임 번호는 가장 작은 칸 번호)
+	inline static void mergeGroup(int* groups, int a, int b)
+	{
+		int from = groups[a] > groups[b] ? groups[a] : groups[b];
+		int to = groups[a] > groups[b] ? groups[b] : groups[a];
+
+		for (int i = 0; i < GridDirection::COUNT; ++i)
+		{
+			if (groups[i] == from)
+			{
+				groups[i] = to;
+			}
+		}
+	}
+
+	// 탐색 스레드에서도 호출하므로 경로를 줄이지 않는다
+	inline uint32_t findRoot(uint32_t label) const
+	{
+		while (mParents[label] != label)
+		{
+			label = mParents[label];
+		}
+
+		return label;
+	}
+
+	// 맵 수정 중에만 호출 (경로 절반 줄이기)
+	inline uint32_t compressRoot(uint32_t label)
+	{
+		while (mParents[label] != label)
+		{
+			mParents[label] = mParents[mParents[label]];
+			label = mParents[label];
+		}
+
+		return label;
+	}
+
+	// 두 루트를 합치고 새 루트를 반환한다 (칸이 많은 쪽으로)
+	uint32_t unite(uint32_t rootA, uint32_t rootB)
+	{
+		if (rootA == rootB)
+		{
+			return rootA;
+		}
+
+		if (mCellCounts[rootA] < mCellCounts[rootB])
+		{
+			uint32_t temp = rootA;
+			rootA = rootB;
+			rootB = temp;
+		}
+
+		mParents[rootB] = rootA;
+		mCellCounts[rootA] += mCellCounts[rootB];
+
+		if (mDirtyFlags[rootB])
+		{
+			if (mDirtyFlags[rootA])
+			{
+				mDirtyCount--;
+			}
+
+			mDirtyFlags[rootA] = true;
+		}
+
+		return rootA;
+	}
+
+	enum : uint32_t
+	{
+		NO_COMPONENT = 0xFFFFFFFF,
+	};
+
+	enum
+	{
+		WINDOW_RADIUS = 4,						// isConnectedNearby()의 창 (9 x 9)
+		WINDOW_SIZE = WINDOW_RADIUS * 2 + 1,
+		MIN_LABEL_COUNT_TO_REBUILD = 1024,
+	};
+
+private:
+	const BitGrid& mGrid;
+	const int mWidth;
+	const int mHeight;
+
+	uint32_t* mLabels;						// 칸 -> 번호 (막힌 칸은 NO_COMPONENT)
+	std::vector<uint32_t> mParents;			// 번호 -> union-find 부모 번호
+	std::vector<uint32_t> mCellCounts;		// 루트 번호 -> 칸 수
+	std::vector<uint8_t> mDirtyFlags;		// 루트 번호 -> 나뉘었을 수 있음
+	int mDirtyCount = 0;					// 표시된 루트 수
+	bool mbOwnsLabels = true;				// 밖에서 받은 칸 번호라면 false
+
+	std::vector<int> mFillStack;
+};
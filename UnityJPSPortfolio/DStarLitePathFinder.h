@@ -0,0 +1,518 @@
+// 맵이 바뀌어도 처음부터 다시 찾지 않고 바뀐 부분만 고쳐서 경로를 유지하는 증분 길찾기 (D* Lite)
+// 목적지에서 거꾸로 탐색하면서 칸마다 목적지까지의 거리(G)와 이웃으로 계산한 거리(RHS)를 저장해두고,
+// 칸이 막히거나 열리면 그 주변 칸의 RHS만 다시 계산해서 G와 달라진 칸들만 다시 확장합니다.
+// 에이전트가 이동하면 시작 칸만 옮기고 (키 보정값 km 증가) 탐색 상태는 그대로 씁니다.
+// 이동 규칙과 비용은 JPSPathFinder와 같고 (8방향, 직선 5, 대각선 7, 모서리 통과 허용), 경로는 HPAPathFinder와 같은 방식으로 줄입니다.
+// 에이전트 하나가 칸마다 17 byte 정도의 상태를 가지므로, 긴 경로를 오래 따라가는 소수의 에이전트에 씁니다.
+// (많은 에이전트는 PathSegmentIndex로 바뀐 칸을 지나는 경로만 골라서 다시 찾는 편이 낫다)
+
+/************************************** 사용법 **************************************/
+// DStarLitePathFinder planner(map); // 에이전트마다
+// planner.PathFind(startX, startY, goalX, goalY);
+// planner.GetPoints();
+//
+// // 에이전트가 이동했을 때
+// planner.MoveStart(x, y);
+//
+// // 맵의 칸을 바꾼 뒤 (map.Block(x, y) 등) 바뀐 칸마다
+// planner.OnCellChanged(x, y);
+//
+// // 바뀐 부분만 다시 탐색해서 경로를 고친다
+// planner.Replan();
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+#include <cstdint>
+
+#include "GridDirection.h"
+#include "LineOfSight.h"
+#include "Point.h"
+#include "Path.h"
+#include "PathFindMap.h"
+
+class DStarLitePathFinder
+{
+public:
+	// 맵은 이 객체보다 오래 살아 있어야 한다
+	explicit DStarLitePathFinder(const PathFindMap& map)
+		: mMap(map)
+		, mGrid(map.GetGrid())
+		, mWidth(map.GetWidth())
+		, mHeight(map.GetHeight())
+		, mStride(map.GetWidth() + 2)
+		, mCellCount((map.GetWidth() + 2) * (map.GetHeight() + 2))
+	{
+		mG = new int[mCellCount];
+		mRhs = new int[mCellCount];
+		mOpenKeys = new Key[mCellCount];
+		mbInOpen = new bool[mCellCount];
+		mbBlocked = new bool[mCellCount];
+
+		for (int i = 0; i < GridDirection::COUNT; ++i)
+		{
+			mCellRelatives[i] = GridDirection::Y[i] * mStride + GridDirection::X[i];
+		}
+	}
+
+	~DStarLitePathFinder()
+	{
+		delete[] mG;
+		delete[] mRhs;
+		delete[] mOpenKeys;
+		delete[] mbInOpen;
+		delete[] mbBlocked;
+	}
+
+	DStarLitePathFinder(const DStarLitePathFinder& other) = delete;
+	DStarLitePathFinder& operator=(const DStarLitePathFinder& other) = delete;
+
+	// 탐색 상태를 비우고 (startX, startY) -> (goalX, goalY) 경로를 처음부터 찾는다
+	bool PathFind(int startX, int startY, int goalX, int goalY)
+	{
+		mPoints.Clear();
+		mPathCost = -1;
+		mExpandedNodeCount = 0;
+		mbPlanned = false;
+
+		if (mMap.IsBlocked(startX, startY) || mMap.IsBlocked(goalX, goalY))
+		{
+			return false;
+		}
+
+		std::fill(mG, mG + mCellCount, static_cast<int>(INF));
+		std::fill(mRhs, mRhs + mCellCount, static_cast<int>(INF));
+		std::fill(mbInOpen, mbInOpen + mCellCount, false);
+		std::fill(mbBlocked, mbBlocked + mCellCount, true);
+
+		for (int y = 0; y < mHeight; ++y)
+		{
+			for (int x = 0; x < mWidth; ++x)
+			{
+				mbBlocked[getCell(x, y)] = !mGrid.IsWalkable(x, y);
+			}
+		}
+
+		mOpenList.clear();
+		mKeyModifier = 0;
+		mStartCell = getCell(startX, startY);
+		mGoalCell = getCell(goalX, goalY);
+		mbPlanned = true;
+
+		mRhs[mGoalCell] = 0;
+		pushOpen(mGoalCell, calculateKey(mGoalCell));
+
+		return Replan();
+	}
+
+	// 에이전트가 (x, y)로 이동했다 (다음 Replan()부터 이 칸에서 출발)
+	void MoveStart(int x, int y)
+	{
+		int cell = getCell(x, y);
+
+		// 시작 칸이 움직인 만큼 이후 키가 작아지므로, 이미 OPEN LIST에 있는 키들 대신 새 키에 더해서 맞춘다
+		mKeyModifier += getHeuristic(mStartCell, cell);
+		mStartCell = cell;
+	}
+
+	// 맵의 (x, y) 칸이 바뀌었다 (PathFindMap을 수정한 뒤 호출, 다음 Replan()에서 반영)
+	void OnCellChanged(int x, int y)
+	{
+		if (mbPlanned == false || x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+		{
+			return;
+		}
+
+		int cell = getCell(x, y);
+		bool bBlocked = !mGrid.IsWalkable(x, y);
+
+		if (mbBlocked[cell] == bBlocked)
+		{
+			return;
+		}
+
+		mbBlocked[cell] = bBlocked;
+
+		// 이 칸에 닿는 간선의 비용이 모두 바뀌므로 이 칸과 이웃들의 RHS를 다시 계산한다
+		updateRhs(cell);
+
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+		{
+			updateRhs(cell + mCellRelatives[direction]);
+		}
+	}
+
+	// 바뀐 부분만 다시 탐색하고 경로를 새로 만든다 (경로가 없다면 false)
+	bool Replan()
+	{
+		mPoints.Clear();
+		mPathCost = -1;
+		mExpandedNodeCount = 0;
+
+		if (mbPlanned == false)
+		{
+			return false;
+		}
+
+		computeShortestPath();
+
+		if (mG[mStartCell] >= INF)
+		{
+			return false;
+		}
+
+		if (buildPoints() == false)
+		{
+			return false;
+		}
+
+		mPathCost = mG[mStartCell];
+		return true;
+	}
+
+	// 마지막으로 찾은 경로 (시작점 포함, 다음 PathFind(), Replan() 전까지 유효)
+	inline const Path& GetPoints() const { return mPoints; }
+
+	// 마지막으로 찾은 경로의 비용 (경로를 줄이기 전, 직선 5, 대각선 7), 경로가 없었다면 -1
+	inline int GetPathCost() const { return mPathCost; }
+
+	// 마지막 PathFind() 또는 Replan()에서 OPEN LIST에서 꺼내 확장한 노드 수
+	inline int GetExpandedNodeCount() const { return mExpandedNodeCount; }
+
+	// 탐색 상태(칸 별 G, RHS, 키, 막힘 여부와 OPEN LIST)의 총 크기 (byte), 맵은 포함하지 않는다
+	inline size_t GetReservedBytes() const
+	{
+		return static_cast<size_t>(mCellCount) * (sizeof(int) * 2 + sizeof(Key) + sizeof(bool) * 2)
+			+ mOpenList.capacity() * sizeof(OpenEntry) + mCells.capacity() * sizeof(Point);
+	}
+
+private:
+	struct Key
+	{
+		int First;		// min(G, RHS) + 휴리스틱 + km
+		int Second;		// min(G, RHS)
+
+		inline bool operator<(const Key& other) const
+		{
+			return First < other.First || (First == other.First && Second < other.Second);
+		}
+
+		inline bool operator==(const Key& other) const
+		{
+			return First == other.First && Second == other.Second;
+		}
+	};
+
+	// 키를 바꿀 때마다 새로 넣고, 꺼낼 때 mOpenKeys와 다른 항목은 버린다
+	struct OpenEntry
+	{
+		Key OpenKey;
+		int Cell;
+
+		// std::push_heap()은 최대 힙이므로 키가 작을수록 우선
+		inline bool operator<(const OpenEntry& other) const
+		{
+			return other.OpenKey < OpenKey;
+		}
+	};
+
+	// 가장 작은 키의 노드가 남아 있을 때까지 확장한다 (시작 칸이 일관되면 끝)
+	void computeShortestPath()
+	{
+		OpenEntry top;
+
+		while (peekOpen(top))
+		{
+			if ((top.OpenKey < calculateKey(mStartCell)) == false && mRhs[mStartCell] == mG[mStartCell])
+			{
+				break;
+			}
+
+			std::pop_heap(mOpenList.begin(), mOpenList.end());
+			mOpenList.pop_back();
+			mExpandedNodeCount++;
+
+			int cell = top.Cell;
+			Key newKey = calculateKey(cell);
+
+			// 키가 작게 들어가 있던 노드 (시작 칸이 움직였다) - 새 키로 다시 넣는다
+			if (top.OpenKey < newKey)
+			{
+				pushOpen(cell, newKey);
+				continue;
+			}
+
+			mbInOpen[cell] = false;
+
+			if (mG[cell] > mRhs[cell])
+			{
+				// 거리가 줄었다 - 확정하고 이웃의 RHS를 줄인다
+				mG[cell] = mRhs[cell];
+
+				for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+				{
+					int neighbor = cell + mCellRelatives[direction];
+					int cost = getCost(neighbor, cell, direction);
+
+					if (neighbor != mGoalCell && cost < INF && mG[cell] + cost < mRhs[neighbor])
+					{
+						mRhs[neighbor] = mG[cell] + cost;
+						updateVertex(neighbor);
+					}
+				}
+			}
+			else
+			{
+				// 거리가 늘었다 - G를 무한으로 올리고 이 칸을 거쳐 가던 이웃들의 RHS를 다시 계산한다
+				int oldG = mG[cell];
+				mG[cell] = INF;
+
+				for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+				{
+					int neighbor = cell + mCellRelatives[direction];
+					int cost = getCost(neighbor, cell, direction);
+
+					if (cost < INF && mRhs[neighbor] == oldG + cost)
+					{
+						updateRhs(neighbor);
+					}
+				}
+
+				updateRhs(cell);
+			}
+		}
+	}
+
+	// 이웃들로 RHS를 다시 계산하고 OPEN LIST에 반영한다
+	void updateRhs(int cell)
+	{
+		if (cell != mGoalCell)
+		{
+			int rhs = INF;
+
+			if (mbBlocked[cell] == false)
+			{
+				for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+				{
+					int neighbor = cell + mCellRelatives[direction];
+
+					if (mbBlocked[neighbor] == false && mG[neighbor] < INF)
+					{
+						rhs = std::min(rhs, mG[neighbor] + OctileCost::Get(direction));
+					}
+				}
+			}
+
+			mRhs[cell] = rhs;
+		}
+
+		updateVertex(cell);
+	}
+
+	// G와 RHS가 다르면 (일관되지 않으면) OPEN LIST에 넣고, 같으면 뺀다
+	void updateVertex(int cell)
+	{
+		if (mG[cell] != mRhs[cell])
+		{
+			Key key = calculateKey(cell);
+
+			if (mbInOpen[cell] == false || (mOpenKeys[cell] == key) == false)
+			{
+				pushOpen(cell, key);
+			}
+		}
+		else
+		{
+			mbInOpen[cell] = false;
+		}
+	}
+
+	void pushOpen(int cell, const Key& key)
+	{
+		mbInOpen[cell] = true;
+		mOpenKeys[cell] = key;
+
+		mOpenList.push_back(OpenEntry{ key, cell });
+		std::push_heap(mOpenList.begin(), mOpenList.end());
+	}
+
+	// 버려진 항목들을 치우고 가장 작은 키의 항목을 얻는다 (비어 있다면 false)
+	bool peekOpen(OpenEntry& outTop)
+	{
+		while (mOpenList.empty() == false)
+		{
+			const OpenEntry& top = mOpenList.front();
+
+			if (mbInOpen[top.Cell] && mOpenKeys[top.Cell] == top.OpenKey)
+			{
+				outTop = top;
+				return true;
+			}
+
+			std::pop_heap(mOpenList.begin(), mOpenList.end());
+			mOpenList.pop_back();
+		}
+
+		return false;
+	}
+
+	inline Key calculateKey(int cell) const
+	{
+		int distance = std::min(mG[cell], mRhs[cell]);
+
+		if (distance >= INF)
+		{
+			return Key{ INF, INF };
+		}
+
+		return Key{ distance + getHeuristic(mStartCell, cell) + mKeyModifier, distance };
+	}
+
+	// from -> to 간선 비용 (direction은 to에서 from으로 가는 방향, 어느 쪽이든 막혀 있다면 INF)
+	inline int getCost(int from, int to, int direction) const
+	{
+		return mbBlocked[from] || mbBlocked[to] ? static_cast<int>(INF) : OctileCost::Get(direction);
+	}
+
+	// 옥타일 거리 (JPSPathFinder와 같음)
+	inline int getHeuristic(int fromCell, int toCell) const
+	{
+		int deltaX = std::abs(fromCell % mStride - toCell % mStride);
+		int deltaY = std::abs(fromCell / mStride - toCell / mStride);
+
+		return OctileCost::GetDistance(deltaX, deltaY);
+	}
+
+	// 시작 칸에서 (간선 비용 + 이웃의 G)가 가장 작은 이웃을 따라 목적지까지 간 뒤 경로를 줄인다
+	bool buildPoints()
+	{
+		mCells.clear();
+
+		int cell = mStartCell;
+		int lastDirection = -1;
+
+		mCells.push_back(getPoint(cell));
+
+		while (cell != mGoalCell)
+		{
+			int nextDirection = -1;
+			int nextDistance = INF;
+
+			for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+			{
+				int neighbor = cell + mCellRelatives[direction];
+
+				if (mbBlocked[neighbor] || mG[neighbor] >= INF)
+				{
+					continue;
+				}
+
+				int distance = mG[neighbor] + OctileCost::Get(direction);
+
+				// 같은 거리라면 직전과 같은 방향을 골라 꺾이는 점을 줄인다
+				if (distance < nextDistance || (distance == nextDistance && direction == lastDirection))
+				{
+					nextDistance = distance;
+					nextDirection = direction;
+				}
+			}
+
+			// 이웃으로 더 이상 줄어들지 않는다면 G가 아직 맞춰지지 않은 것 (탐색 상태가 어긋남)
+			if (nextDirection == -1 || nextDistance > mG[cell])
+			{
+				return false;
+			}
+
+			// 방향이 바뀌었다면 지금 칸이 꺾이는 점
+			if (lastDirection != -1 && nextDirection != lastDirection)
+			{
+				mCells.push_back(getPoint(cell));
+			}
+
+			cell += mCellRelatives[nextDirection];
+			lastDirection = nextDirection;
+		}
+
+		if (cell != mStartCell)
+		{
+			mCells.push_back(getPoint(cell));
+		}
+
+		reduceCells();
+
+		return true;
+	}
+
+	// 직선으로 이어지는 중간 점들을 뺀다 (HPAPathFinder::reduceWaypoints()와 같은 방식)
+	void reduceCells()
+	{
+		// anchor : 마지막으로 남긴 점
+		int anchor = static_cast<int>(mCells.size()) - 1;
+
+		mPoints.PushBack(mCells[anchor]);
+
+		for (int i = anchor - 1; i >= 0; --i)
+		{
+			if (i > 0 && LineOfSight::IsClear(mGrid, mCells[anchor].X, mCells[anchor].Y, mCells[i - 1].X, mCells[i - 1].Y))
+			{
+				continue;
+			}
+
+			mPoints.PushBack(mCells[i]);
+			anchor = i;
+		}
+
+		// 도착점부터 담았으므로 뒤집는다
+		for (int left = 0, right = mPoints.Size() - 1; left < right; ++left, --right)
+		{
+			std::swap(mPoints[left], mPoints[right]);
+		}
+	}
+
+	inline int getCell(int x, int y) const
+	{
+		return (y + 1) * mStride + (x + 1);
+	}
+
+	inline Point getPoint(int cell) const
+	{
+		return Point{ cell % mStride - 1, cell / mStride - 1 };
+	}
+
+	enum
+	{
+		INF = 0x3FFFFFFF,			// 더해도 넘치지 않도록 INT_MAX의 절반
+	};
+
+private:
+	Path mPoints;
+	std::vector<Point> mCells;		// 줄이기 전의 꺾이는 점들
+	int mPathCost = -1;
+	int mExpandedNodeCount = 0;
+
+	const PathFindMap& mMap;
+	const BitGrid& mGrid;
+	const int mWidth;
+	const int mHeight;
+
+	// 맵보다 한 칸씩 넓게 (테두리는 막힌 칸)
+	const int mStride;
+	const int mCellCount;
+	int mCellRelatives[GridDirection::COUNT];
+
+	int* mG;
+	int* mRhs;
+	Key* mOpenKeys;				// OPEN LIST에 마지막으로 넣은 키
+	bool* mbInOpen;
+	bool* mbBlocked;			// 탐색 상태가 알고 있는 막힘 여부 (OnCellChanged()로 맵과 맞춘다)
+	std::vector<OpenEntry> mOpenList;
+
+	bool mbPlanned = false;
+	int mStartCell = 0;
+	int mGoalCell = 0;
+	int mKeyModifier = 0;		// km : 시작 칸이 움직인 거리의 합
+};
@@ -0,0 +1,235 @@
+// 목적지 하나에 대한 흐름장 (다익스트라 맵)
+// 목적지에서 거꾸로 다익스트라를 한 번 돌려서, 칸마다 목적지까지의 거리와 목적지 쪽으로 가는 다음 칸의 방향을 저장합니다.
+// 같은 목적지로 가는 에이전트는 몇 명이든 탐색 없이 자기 칸의 방향만 읽으면 됩니다 (O(1)).
+// 이동 규칙과 비용은 JPSPathFinder와 같고 (8방향, 직선 5, 대각선 7, 모서리 통과 허용), 거리는 JPS가 찾은 경로의 비용과 같습니다.
+// 맵 전체 또는 목적지 주변의 사각형 범위에 대해서만 만들 수 있습니다 (범위 밖은 막힌 칸으로 취급).
+// 만든 뒤에는 읽기만 하므로 여러 스레드에서 동시에 읽어도 됩니다 (맵이 바뀌면 새로 만들어야 함, FlowFieldCache 참고).
+
+/************************************** 사용법 **************************************/
+// FlowField field(map, goalX, goalY);                       // 맵 전체
+// FlowField field(map, goalX, goalY, left, top, width, height); // 범위 제한
+//
+// Point next;
+// if (field.GetNextStep(x, y, next))
+// {
+//     // next로 한 칸 이동
+// }
+//
+// Path points;
+// field.GetPath(x, y, points); // 방향이 바뀌는 칸만 담은 경로 (시작점 포함)
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "Point.h"
+#include "Path.h"
+#include "PathFindMap.h"
+#include "GridDijkstra.h"
+
+class FlowField
+{
+public:
+	// 맵 전체
+	FlowField(const PathFindMap& map, int goalX, int goalY)
+		: FlowField(map, goalX, goalY, 0, 0, map.GetWidth(), map.GetHeight())
+	{
+	}
+
+	// (left, top)부터 width x height 범위 (맵 밖으로 나간 부분은 잘라낸다)
+	FlowField(const PathFindMap& map, int goalX, int goalY, int left, int top, int width, int height)
+		: mGoalX(goalX)
+		, mGoalY(goalY)
+		, mMapVersion(map.GetVersion())
+		, mLeft(std::max(left, 0))
+		, mTop(std::max(top, 0))
+		, mWidth(std::max(std::min(left + width, map.GetWidth()) - std::max(left, 0), 0))
+		, mHeight(std::max(std::min(top + height, map.GetHeight()) - std::max(top, 0), 0))
+		, mStride(mWidth + 2)
+	{
+		mDistances = new int[mStride * (mHeight + 2)];
+		mDirections = new uint8_t[mStride * (mHeight + 2)];
+
+		build(map.GetGrid());
+	}
+
+	~FlowField()
+	{
+		delete[] mDistances;
+		delete[] mDirections;
+	}
+
+	FlowField(const FlowField& other) = delete;
+	FlowField& operator=(const FlowField& other) = delete;
+
+	inline int GetGoalX() const { return mGoalX; }
+	inline int GetGoalY() const { return mGoalY; }
+
+	// 만들 당시의 맵 버전 (PathFindMap::GetVersion()과 다르다면 이미 맞지 않는 흐름장)
+	inline uint32_t GetMapVersion() const { return mMapVersion; }
+
+	inline bool Contains(int x, int y) const
+	{
+		return x >= mLeft && x < mLeft + mWidth && y >= mTop && y < mTop + mHeight;
+	}
+
+	// (x, y)에서 목적지까지의 경로 비용 (범위 밖이거나 닿을 수 없다면 -1)
+	inline int GetDistance(int x, int y) const
+	{
+		if (Contains(x, y) == false)
+		{
+			return UNREACHABLE;
+		}
+
+		int distance = mDistances[getCell(x, y)];
+		return distance >= 0 ? distance : UNREACHABLE;
+	}
+
+	// (x, y)에서 목적지 쪽으로 한 칸 이동한 칸 (목적지이거나 닿을 수 없다면 false)
+	inline bool GetNextStep(int x, int y, Point& outNext) const
+	{
+		if (Contains(x, y) == false)
+		{
+			return false;
+		}
+
+		int direction = mDirections[getCell(x, y)];
+
+		if (direction == NO_DIRECTION)
+		{
+			return false;
+		}
+
+		outNext = Point{ x + GridDirection::X[direction], y + GridDirection::Y[direction] };
+		return true;
+	}
+
+	// (startX, startY)에서 방향을 따라 목적지까지 간 경로를 outPoints에 담는다 (방향이 바뀌는 칸만, 시작점 포함)
+	// 닿을 수 없다면 false를 반환하고 outPoints는 비어 있다
+	bool GetPath(int startX, int startY, Path& outPoints) const
+	{
+		outPoints.Clear();
+
+		if (GetDistance(startX, startY) == UNREACHABLE)
+		{
+			return false;
+		}
+
+		int cell = getCell(startX, startY);
+		int x = startX;
+		int y = startY;
+		int lastDirection = NO_DIRECTION;
+
+		outPoints.PushBack(Point{ x, y });
+
+		while (mDirections[cell] != NO_DIRECTION)
+		{
+			int direction = mDirections[cell];
+
+			// 방향이 바뀌었다면 지금 칸이 꺾이는 점
+			if (lastDirection != NO_DIRECTION && direction != lastDirection)
+			{
+				outPoints.PushBack(Point{ x, y });
+			}
+
+			x += GridDirection::X[direction];
+			y += GridDirection::Y[direction];
+			cell += mCellRelatives[direction];
+			lastDirection = direction;
+		}
+
+		if (x != startX || y != startY)
+		{
+			outPoints.PushBack(Point{ x, y });
+		}
+
+		return true;
+	}
+
+	// 거리, 방향 배열의 총 크기 (byte)
+	inline size_t GetReservedBytes() const
+	{
+		return static_cast<size_t>(mStride) * (mHeight + 2) * (sizeof(int) + sizeof(uint8_t));
+	}
+
+private:
+	// 칸마다 거리를 줄인 이웃의 반대 방향(목적지 쪽)을 기록한다
+	struct DirectionVisitor : GridDijkstra::Visitor
+	{
+		uint8_t* Directions;
+
+		inline void OnImprove(int, int nextCell, int direction)
+		{
+			Directions[nextCell] = static_cast<uint8_t>(GridDirection::GetOpposite(direction));
+		}
+	};
+
+	// 목적지에서 거꾸로 다익스트라를 한다 (GridDijkstra, 이동 비용은 양방향이 같다)
+	void build(const BitGrid& grid)
+	{
+		GridDijkstra dijkstra(mStride);
+
+		for (int i = 0; i < GridDirection::COUNT; ++i)
+		{
+			mCellRelatives[i] = dijkstra.GetCellRelative(i);
+		}
+
+		// 테두리와 막힌 칸은 BLOCKED, 나머지는 UNREACHABLE
+		std::fill(mDistances, mDistances + mStride * (mHeight + 2), static_cast<int>(BLOCKED));
+		std::fill(mDirections, mDirections + mStride * (mHeight + 2), static_cast<uint8_t>(NO_DIRECTION));
+
+		for (int y = 0; y < mHeight; ++y)
+		{
+			for (int x = 0; x < mWidth; ++x)
+			{
+				if (grid.IsWalkable(mLeft + x, mTop + y))
+				{
+					mDistances[(y + 1) * mStride + (x + 1)] = UNREACHABLE;
+				}
+			}
+		}
+
+		if (Contains(mGoalX, mGoalY) == false || mDistances[getCell(mGoalX, mGoalY)] == BLOCKED)
+		{
+			return;
+		}
+
+		DirectionVisitor visitor;
+		visitor.Directions = mDirections;
+
+		dijkstra.Push(mDistances, getCell(mGoalX, mGoalY), 0);
+		dijkstra.Run(mDistances, visitor);
+	}
+
+	inline int getCell(int x, int y) const
+	{
+		return (y - mTop + 1) * mStride + (x - mLeft + 1);
+	}
+
+	enum
+	{
+		UNREACHABLE = GridDijkstra::NOT_VISITED,
+		BLOCKED = GridDijkstra::BLOCKED,
+		NO_DIRECTION = GridDirection::COUNT,
+	};
+
+private:
+	const int mGoalX;
+	const int mGoalY;
+	const uint32_t mMapVersion;
+
+	// 범위 (맵 좌표)
+	const int mLeft;
+	const int mTop;
+	const int mWidth;
+	const int mHeight;
+
+	// 범위보다 한 칸씩 넓게 (테두리는 막힌 칸)
+	const int mStride;
+	int mCellRelatives[GridDirection::COUNT];
+	int* mDistances;
+	uint8_t* mDirections;		// 목적지 쪽으로 가는 방향 (목적지, 닿을 수 없는 칸은 NO_DIRECTION)
+};
@@ -0,0 +1,267 @@
+// 흐름장(FlowField) 캐시
+// (목적지, 범위 반지름, 맵 버전)을 키로 흐름장을 하나만 만들어두고, 같은 목적지로 가는 에이전트들이 참조 카운트로 나눠 씁니다.
+// 아무도 쓰지 않게 된 흐름장은 바로 지우지 않고 최대 maxIdleCount 개까지 남겨두었다가 (다시 같은 목적지를 요청하면 재사용),
+// 넘치면 가장 오래 쓰지 않은 것부터 지웁니다. 맵이 바뀌면 (버전 증가) 쓰지 않는 이전 버전의 흐름장은 다음 Acquire()에서 지웁니다.
+// 여러 스레드에서 동시에 사용할 수 있고, 흐름장 생성은 락 밖에서 합니다.
+
+/************************************** 사용법 **************************************/
+// FlowFieldCache cache(map, maxIdleCount);
+//
+// const FlowField* field = cache.Acquire(goalX, goalY);      // 맵 전체
+// const FlowField* field = cache.Acquire(goalX, goalY, 128); // 목적지 주변 (2 * 128 + 1) 칸 정사각형
+//
+// Point next;
+// field->GetNextStep(x, y, next);
+//
+// // 목적지에 도착했거나 목적지가 바뀐 에이전트마다
+// cache.Release(field);
+/************************************************************************************/
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "PathFindMap.h"
+#include "FlowField.h"
+
+class FlowFieldCache
+{
+public:
+	FlowFieldCache(const PathFindMap& map, int maxIdleCount = DEFAULT_MAX_IDLE_COUNT)
+		: mMap(map)
+		, mMaxIdleCount(maxIdleCount)
+	{
+	}
+
+	~FlowFieldCache()
+	{
+		for (auto& pair : mEntries)
+		{
+			delete pair.second.Field;
+		}
+	}
+
+	FlowFieldCache(const FlowFieldCache& other) = delete;
+	FlowFieldCache& operator=(const FlowFieldCache& other) = delete;
+
+	// (goalX, goalY)로 가는 흐름장을 얻는다 (없다면 만든다), 다 쓰면 Release()를 호출해야 한다
+	// radius > 0 이면 목적지 주변 (2 * radius + 1) 칸 정사각형 범위만 만든다
+	const FlowField* Acquire(int goalX, int goalY, int radius = 0)
+	{
+		const Key key = makeKey(goalX, goalY, radius, mMap.GetVersion());
+
+		{
+			std::lock_guard<std::mutex> lock(mLock);
+
+			removeStaleIdleFields(key.MapVersion);
+
+			FlowField* field = acquireOrNull(key);
+
+			if (field != nullptr)
+			{
+				mHitCount++;
+				return field;
+			}
+		}
+
+		// 흐름장은 맵 크기에 비례하므로 락 밖에서 만든다
+		FlowField* newField = radius > 0
+			? new FlowField(mMap, goalX, goalY, goalX - radius, goalY - radius, radius * 2 + 1, radius * 2 + 1)
+			: new FlowField(mMap, goalX, goalY);
+
+		std::lock_guard<std::mutex> lock(mLock);
+
+		// 만드는 동안 다른 스레드가 먼저 넣었다면 그것을 쓴다
+		FlowField* field = acquireOrNull(key);
+
+		if (field != nullptr)
+		{
+			delete newField;
+			mHitCount++;
+			return field;
+		}
+
+		mEntries.insert(std::make_pair(key, Entry{ newField, 1, mIdleKeys.end() }));
+		mFieldToKey.insert(std::make_pair(newField, key));
+		mBuildCount++;
+
+		return newField;
+	}
+
+	void Release(const FlowField* field)
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+
+		auto foundKey = mFieldToKey.find(field);
+
+		if (foundKey == mFieldToKey.end())
+		{
+			return;
+		}
+
+		Entry& entry = mEntries.find(foundKey->second)->second;
+		entry.RefCount--;
+
+		if (entry.RefCount > 0)
+		{
+			return;
+		}
+
+		// 쓰지 않는 흐름장 목록 (앞쪽일수록 최근)
+		mIdleKeys.push_front(foundKey->second);
+		entry.IdlePosition = mIdleKeys.begin();
+
+		while ((int)mIdleKeys.size() > mMaxIdleCount)
+		{
+			removeField(mIdleKeys.back());
+		}
+	}
+
+	void Clear()
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+
+		while (mIdleKeys.empty() == false)
+		{
+			removeField(mIdleKeys.back());
+		}
+	}
+
+	// 만든 흐름장 수, 이미 있던 흐름장을 재사용한 횟수
+	inline uint64_t GetBuildCount() const { return mBuildCount; }
+	inline uint64_t GetHitCount() const { return mHitCount; }
+
+	// 가지고 있는 흐름장의 총 크기 (byte)
+	size_t GetReservedBytes()
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+
+		size_t bytes = 0;
+
+		for (auto& pair : mEntries)
+		{
+			bytes += pair.second.Field->GetReservedBytes();
+		}
+
+		return bytes;
+	}
+
+private:
+	struct Key
+	{
+		uint64_t Goal;          // 목적지 X, 목적지 Y, 반지름 (각 16비트)
+		uint32_t MapVersion;
+
+		inline bool operator==(const Key& other) const
+		{
+			return Goal == other.Goal && MapVersion == other.MapVersion;
+		}
+	};
+
+	struct KeyHash
+	{
+		inline size_t operator()(const Key& key) const
+		{
+			// splitmix64 마무리 단계 (PathCache와 같음)
+			uint64_t hash = key.Goal ^ (static_cast<uint64_t>(key.MapVersion) * 0x9E3779B97F4A7C15ull);
+			hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+			hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+			return static_cast<size_t>(hash ^ (hash >> 31));
+		}
+	};
+
+	struct Entry
+	{
+		FlowField* Field;
+		int RefCount;
+		std::list<Key>::iterator IdlePosition;		// 쓰지 않는 목록에서의 위치 (RefCount > 0 이면 mIdleKeys.end())
+	};
+
+	inline static Key makeKey(int goalX, int goalY, int radius, uint32_t mapVersion)
+	{
+		uint64_t goal = static_cast<uint64_t>(static_cast<uint16_t>(goalX))
+			| static_cast<uint64_t>(static_cast<uint16_t>(goalY)) << 16
+			| static_cast<uint64_t>(static_cast<uint16_t>(radius)) << 32;
+
+		return Key{ goal, mapVersion };
+	}
+
+	// 있다면 참조 카운트를 올리고 반환한다 (mLock을 잡은 상태에서 호출)
+	FlowField* acquireOrNull(const Key& key)
+	{
+		auto found = mEntries.find(key);
+
+		if (found == mEntries.end())
+		{
+			return nullptr;
+		}
+
+		Entry& entry = found->second;
+
+		if (entry.RefCount == 0)
+		{
+			mIdleKeys.erase(entry.IdlePosition);
+			entry.IdlePosition = mIdleKeys.end();
+		}
+
+		entry.RefCount++;
+		return entry.Field;
+	}
+
+	// 쓰지 않는 흐름장 중 지금 맵 버전이 아닌 것들을 지운다 (mLock을 잡은 상태에서 호출)
+	void removeStaleIdleFields(uint32_t mapVersion)
+	{
+		if (mapVersion == mLastMapVersion)
+		{
+			return;
+		}
+
+		mLastMapVersion = mapVersion;
+
+		for (auto it = mIdleKeys.begin(); it != mIdleKeys.end();)
+		{
+			Key key = *it;
+			++it;
+
+			if (key.MapVersion != mapVersion)
+			{
+				removeField(key);
+			}
+		}
+	}
+
+	// 쓰지 않는 흐름장을 지운다 (mLock을 잡은 상태에서 호출)
+	void removeField(const Key& key)
+	{
+		auto found = mEntries.find(key);
+		FlowField* field = found->second.Field;
+
+		mIdleKeys.erase(found->second.IdlePosition);
+		mFieldToKey.erase(field);
+		mEntries.erase(found);
+
+		delete field;
+	}
+
+	enum
+	{
+		DEFAULT_MAX_IDLE_COUNT = 8,
+	};
+
+private:
+	const PathFindMap& mMap;
+	const int mMaxIdleCount;
+
+	std::mutex mLock;
+	std::unordered_map<Key, Entry, KeyHash> mEntries;
+	std::unordered_map<const FlowField*, Key> mFieldToKey;
+	std::list<Key> mIdleKeys;		// RefCount가 0인 흐름장, 앞쪽일수록 최근에 반환
+	uint32_t mLastMapVersion = 0;
+
+	std::atomic<uint64_t> mBuildCount = 0;
+	std::atomic<uint64_t> mHitCount = 0;
+};
@@ -1,32 +1,74 @@
 #include "GameServer.h"
 
 #include <process.h>
+#include <algorithm>
+#include <cstdio>
 #include "NetLibrary/Logger/Logger.h"
 #include "NetLibrary/Profiler/Profiler.h"
 
 void GameServer::Start(const uint16_t port, const uint32_t maxSessionCount, const uint32_t iocpConcurrentThreadCount, const uint32_t iocpWorkerThreadCount)
 {
 #pragma region Map File Read
-	FILE* fptr_map;
-	ASSERT_LIVE(fopen_s(&fptr_map, "map.txt", "r") != EINVAL, L"map.txt open Failed");
-	ASSERT_LIVE(fptr_map != nullptr, L"map.txt open Failed");
+	const int threadCount = static_cast<int>(std::thread::hardware_concurrency());
 
-	while (true)
+	// 랜드마크 수는 메모리 예산 안으로 줄인다 (맵 파일에 미리 만들어 둔 거리표와 비교)
+	int landmarkCount = LandmarkTable::GetMaxLandmarkCount(mPathFindMap.GetWidth(), mPathFindMap.GetHeight(), mPathFindLandmarkMemoryBytes);
+	landmarkCount = static_cast<int>(mPathFindLandmarkCount) < landmarkCount ? static_cast<int>(mPathFindLandmarkCount) : landmarkCount;
+
+	// map.bin이 없거나 변환한 뒤 map.txt를 고쳤다면 map.txt를 한 번 변환해서 만들어 두고, 이후에는 매핑만 한다
+	if (mMapFile.Open("map.bin") == false || mMapFile.IsOutdated("map.txt"))
 	{
-		int x;
-		int y;
+		LOGF(ELogLevel::System, L"map.bin not found or older than map.txt, converting map.txt");
 
-		if (fscanf_s(fptr_map, "%d %d", &x, &y) != 2)
-		{
-			break;
-		}
+		// 매핑한 채로는 파일을 덮어쓸 수 없다
+		mMapFile.Close();
 
-		mlPathFinder.Block(x, y);
+		ASSERT_LIVE(MapFile::ConvertText("map.txt", mPathFindMap.GetWidth(), mPathFindMap.GetHeight(), "map.bin", false, landmarkCount, mbPathFindGoalBounds, threadCount), L"map.txt convert Failed");
+		ASSERT_LIVE(mMapFile.Open("map.bin"), L"map.bin open Failed");
 	}
 
+	ASSERT_LIVE(mPathFindMap.Load(mMapFile, threadCount), L"map.bin size mismatch");
+
 	LOGF(ELogLevel::System, L"Thread %d File Load Complete", GetCurrentThreadId());
 #pragma endregion
 
+    // 막힌 영역 안을 클릭한 경우 같은 닿을 수 없는 요청을 탐색 없이 거절한다 (맵 파일에 없을 때만 새로 만든다)
+    mPathFindMap.EnableComponents();
+
+    // 미로형 맵에서 옥타일 거리보다 정확한 랜드마크 휴리스틱 (맵 파일의 거리표와 설정이 다를 때만 모든 코어로 나눠 새로 만든다)
+    const LandmarkTable* landmarks = mPathFindMap.GetLandmarks();
+
+    if (landmarks == nullptr ? landmarkCount > 0 : landmarks->GetLandmarkCount() != landmarkCount)
+    {
+        mPathFindMap.EnableLandmarks(landmarkCount, mPathFindLandmarkMemoryBytes, threadCount);
+    }
+
+    LOGF(ELogLevel::System, L"Landmarks = %d (%zu bytes)", mPathFindMap.IsLandmarksEnabled() ? mPathFindMap.GetLandmarks()->GetLandmarkCount() : 0,
+        mPathFindMap.IsLandmarksEnabled() ? mPathFindMap.GetLandmarks()->GetReservedBytes() : 0);
+
+    // 목표 경계 상자 (맵 파일에 없는데 켜져 있다면 지금 만든다, 오래 걸리므로 map.bin을 지우고 다시 변환해 두는 것이 좋다)
+    if (mbPathFindGoalBounds == false)
+    {
+        mPathFindMap.DisableGoalBounds();
+    }
+    else if (mPathFindMap.IsGoalBoundsEnabled() == false)
+    {
+        LOGF(ELogLevel::System, L"goal bounds not in map.bin, building (delete map.bin to save them)");
+        mPathFindMap.EnableGoalBounds(threadCount);
+    }
+
+    LOGF(ELogLevel::System, L"Goal Bounds = %d (%zu bytes)", mPathFindMap.IsGoalBoundsEnabled() ? 1 : 0,
+        mPathFindMap.IsGoalBoundsEnabled() ? mPathFindMap.GetGoalBounds()->GetReservedBytes() : 0);
+
+    if (mPathFindCacheCapacity > 0)
+    {
+        mPathFindService.EnablePathCache(mPathFindCacheCapacity);
+    }
+
+    mPathFindService.SetSliceOption(mPathFindExpandCountPerSlice, mPathFindMicrosecondsPerSlice, mPathFindMaxActiveSearchCount);
+    mPathFindService.SetPartialPathOption(mPathFindPartialExpandCount, mPathFindPartialMicroseconds);
+    mPathFindService.Start(mPathFindThreadCount, mPathFindExpandBudgetPerTick);
+
     NetServer::Start(port, maxSessionCount, iocpConcurrentThreadCount, iocpWorkerThreadCount);
 
     HANDLE mUpdateThread = reinterpret_cast<HANDLE>(::_beginthreadex(nullptr, 0, updateThread, this, 0, nullptr));
@@ -52,7 +94,7 @@ void GameServer::OnAccept(const uint64_t sessionID)
     {
         x = static_cast<float>(rand() % 99 + 1);
         y = static_cast<float>(rand() % 99 + 1);
-    } while (mlPathFinder.IsBlocked(static_cast<int>(x), static_cast<int>(y)));
+    } while (mPathFindMap.IsBlocked(static_cast<int>(x), static_cast<int>(y)));
 
     newPlayer->Init(sessionID, ++mPlayerID, x, y);
 
@@ -105,8 +147,7 @@ void GameServer::OnAccept(const uint64_t sessionID)
 
 void GameServer::OnReceive(const uint64_t sessionID, Serializer* packet)
 {
-    std::lock_guard<std::mutex> lock(mGameLock);
-
+	// 게임 락은 각 메세지 처리 함수에서 필요한 구간만 잡는다 (길찾기는 락 밖에서 수행)
 	uint8_t messageType;
 
 	*packet >> messageType;
@@ -154,6 +195,9 @@ void GameServer::OnRelease(const uint64_t sessionID)
 	mPlayerList.erase(sessionID);
 	removeFromSector(sectorX, sectorY, player);
 
+	mPathFindService.Cancel(sessionID);
+	mActivePaths.Remove(sessionID);
+
 	Serializer* SC_DELETE_CHARACTER = Create_SC_DELETE_CHARACTER(player->GetPlayerID());
 	sendSectorAround(SC_DELETE_CHARACTER, player->GetPlayerID(), sectorX, sectorY);
 
@@ -162,66 +206,279 @@ void GameServer::OnRelease(const uint64_t sessionID)
 
 void GameServer::process_CS_MOVE(const uint64_t sessionID, const float x, const float y)
 {
-	Player* player = mPlayerList.find(sessionID)->second;
+	int startX;
+	int startY;
+	int endX;
+	int endY;
 
-	player->UpdateLastRecvTick();
+	{
+		std::lock_guard<std::mutex> lock(mGameLock);
 
-	if (x < 0.0f || x >= 100.0f || y < 0.0f || y >= 100.0f)
+		Player* player = mPlayerList.find(sessionID)->second;
+
+		player->UpdateLastRecvTick();
+
+		if (x < 0.0f || x >= 100.0f || y < 0.0f || y >= 100.0f)
+		{
+			return;
+		}
+
+		endX = static_cast<int>(x);
+		endY = static_cast<int>(y);
+
+		if (mPathFindMap.IsBlocked(endX, endY))
+		{
+			return;
+		}
+
+		player->SetGoal(Point{ endX, endY });
+
+		if (player->IsMoving())
+		{
+			startX = player->GetDestPositions().Back().X;
+			startY = player->GetDestPositions().Back().Y;
+		}
+		else
+		{
+			startX = static_cast<int>(player->GetX());
+			startY = static_cast<int>(player->GetY());
+		}
+	}
+
+	if (startX == endX && startY == endY)
 	{
 		return;
 	}
 
-	const int intX = static_cast<int>(x);
-	const int intY = static_cast<int>(y);
+	// 탐색은 길찾기 스레드(스레드가 없다면 업데이트 스레드의 OnTick())에서 조각으로 나눠 수행하고, 결과는 업데이트 스레드에서 적용한다
+	mPathFindService.Submit(sessionID, startX, startY, endX, endY);
+}
+
+void GameServer::process_CS_HEARTBEAT(const uint64_t sessionID)
+{
+	std::lock_guard<std::mutex> lock(mGameLock);
 
-	if (mlPathFinder.IsBlocked(intX, intY))
+	mPlayerList.find(sessionID)->second->UpdateLastRecvTick();
+}
+
+void GameServer::applyPathFindResults(void)
+{
+	// 길찾기 스레드가 없다면 이 안에서 틱 당 시간만큼 멈춘 길찾기들을 돌아가며 이어서 찾는다
+	mPathFindService.OnTick(mPathFindMicrosecondsPerTick);
+	mPathFindService.TakeResults(mPathFindResults);
+
+	for (PathFindService::Result& result : mPathFindResults)
 	{
-		return;
+		auto found = mPlayerList.find(result.RequesterID);
+
+		// 길찾기 도중 접속이 끊긴 플레이어, 또는 경로가 없는 경우
+		if (found == mPlayerList.end() || result.Points.Empty())
+		{
+			continue;
+		}
+
+		Player* player = found->second;
+
+		// 요청한 뒤 경로가 바뀌었다면 (다시 찾기로 비웠거나 다른 결과를 먼저 붙였다면) 이어 붙일 수 없으므로 버린다
+		Point pathEnd;
+
+		if (player->IsMoving())
+		{
+			pathEnd = player->GetDestPositions().Back();
+		}
+		else
+		{
+			pathEnd = Point{ static_cast<int>(player->GetX()), static_cast<int>(player->GetY()) };
+		}
+
+		if (result.Points.Front().X != pathEnd.X || result.Points.Front().Y != pathEnd.Y)
+		{
+			continue;
+		}
+
+		player->UpdateLastTick();
+
+		// 첫 점은 시작 위치이므로 제외
+		// 부분 경로라면 나머지 경로가 이 경로의 끝에서 시작하는 다음 결과로 와서 뒤에 이어 붙는다
+		for (const Point* it = result.Points.Begin() + 1; it != result.Points.End(); ++it)
+		{
+			player->PushToDestPositions(*it);
+		}
+
+		player->SetStateToMove();
+		updateActivePath(player);
+
+		Serializer* SC_PATH_FIND = Create_SC_PATH_FIND(player->GetPlayerID(), result.Points);
+		sendSectorAround(SC_PATH_FIND, -1, getSectorX(player->GetX()), getSectorY(player->GetY()));
+		Serializer::Free(SC_PATH_FIND);
 	}
 
-	player->UpdateLastTick();
+	mPathFindResults.clear();
+}
 
-	int startX;
-	int startY;
+void GameServer::ChangeCells(const Point* cells, const int count, const bool bBlock)
+{
+	std::lock_guard<std::mutex> lock(mGameLock);
+
+	// 탐색 중에는 맵을 바꿀 수 없으므로 길찾기 스레드를 멈추고, 이전 맵으로 찾아둔 결과는 먼저 적용해서 색인에 넣는다
+	mPathFindService.Pause();
+	applyPathFindResults();
 
-	if (player->IsMoving())
+	for (int i = 0; i < count; ++i)
 	{
-		startX = player->GetDestPositions().back().X;
-		startY = player->GetDestPositions().back().Y;
-		
+		if (bBlock)
+		{
+			mPathFindMap.Block(cells[i].X, cells[i].Y);
+		}
+		else
+		{
+			mPathFindMap.UnBlock(cells[i].X, cells[i].Y);
+		}
 	}
-	else
+
+	// 목표 경계 상자는 다시 만들기에 너무 오래 걸리므로 무효인 채로 둔다 (JPS가 가지치기 없이 찾는다)
+	mPathFindMap.RefreshComponents();
+	mPathFindMap.RefreshLandmarks();
+	mPathFindService.Resume();
+
+	// 열린 칸은 기존 경로를 막지 않으므로 (더 짧은 경로가 생길 수는 있다) 막힌 칸을 지나는 경로만 다시 찾는다
+	if (bBlock)
 	{
-		startX = static_cast<int>(player->GetX());
-		startY = static_cast<int>(player->GetY());
+		replanPathsCrossing(cells, count);
 	}
+}
 
-	if (startX == intX && startY == intY)
+void GameServer::updateActivePath(Player* player)
+{
+	if (player->IsMoving() == false)
 	{
+		mActivePaths.Remove(player->GetSessionID());
 		return;
 	}
 
-	PROFILE_BEGIN(L"PathFind");
-	auto it = mlPathFinder.PathFind(startX, startY, intX, intY);
-	PROFILE_END(L"PathFind");
+	Path route;
+	route.PushBack(Point{ static_cast<int>(player->GetX()), static_cast<int>(player->GetY()) });
+
+	for (const Point& point : player->GetDestPositions())
+	{
+		route.PushBack(point);
+	}
+
+	mActivePaths.Insert(player->GetSessionID(), route);
+}
 
-	++it;
+void GameServer::replanPathsCrossing(const Point* cells, const int count)
+{
+	std::vector<uint64_t> sessionIDs;
 
-	for (; it != mlPathFinder.End(); ++it)
+	for (int i = 0; i < count; ++i)
 	{
-		player->PushToDestPositions(*it);
+		mActivePaths.Query(cells[i].X, cells[i].Y, sessionIDs);
 	}
 
-	player->SetStateToMove();
+	std::sort(sessionIDs.begin(), sessionIDs.end());
+	sessionIDs.erase(std::unique(sessionIDs.begin(), sessionIDs.end()), sessionIDs.end());
 
-	Serializer* SC_PATH_FIND = Create_SC_PATH_FIND(player->GetPlayerID(), mlPathFinder.GetPoints());
-	sendSectorAround(SC_PATH_FIND, -1, getSectorX(player->GetX()), getSectorY(player->GetY()));
-	Serializer::Free(SC_PATH_FIND);
+	for (const uint64_t sessionID : sessionIDs)
+	{
+		Player* player = mPlayerList.find(sessionID)->second;
+
+		// 부분 경로의 끝이 아니라 클릭한 목적지로 다시 찾는다
+		Point destination = player->GetGoal();
+		int startX = static_cast<int>(player->GetX());
+		int startY = static_cast<int>(player->GetY());
+
+		// 남은 경로를 버리고 멈춘 상태에서 새 경로를 기다린다 (applyPathFindResults()는 남은 경로 뒤에 이어 붙이므로)
+		player->ClearDestPositions();
+		player->SetStateToIdle();
+		mActivePaths.Remove(sessionID);
+
+		// 다시 찾지 않는다면 남은 경로 끝에서 출발하는 대기 중인 요청도 버린다 (비워진 경로 뒤에 이어 붙으면 안 된다)
+		if (mPathFindMap.IsBlocked(destination.X, destination.Y) || (startX == destination.X && startY == destination.Y))
+		{
+			mPathFindService.Cancel(sessionID);
+			continue;
+		}
+
+		// 대기 중인 요청(더 최근의 클릭)이 있다면 그 요청에 병합된다 (목적지는 그 클릭의 목적지이므로 그대로다)
+		mPathFindService.Submit(sessionID, startX, startY, destination.X, destination.Y);
+	}
 }
 
-void GameServer::process_CS_HEARTBEAT(const uint64_t sessionID)
+void GameServer::OnMonitor(MonitoringVariables& monitorResult)
 {
-	mPlayerList.find(sessionID)->second->UpdateLastRecvTick();
+	PathFindService::Statistics statistics = mPathFindService.GetStatistics();
+	uint64_t startedCount = statistics.StartedCount - mPathFindStatistics.StartedCount;
+
+	monitorResult.PathFindQueueDepth = statistics.QueueDepth;
+	monitorResult.PathFindTPS = static_cast<uint32_t>(statistics.CompletedCount - mPathFindStatistics.CompletedCount);
+	monitorResult.PathFindCancelTPS = static_cast<uint32_t>(statistics.CancelledCount - mPathFindStatistics.CancelledCount);
+	monitorResult.PathFindExpandTPS = static_cast<uint32_t>(statistics.ExpandedNodeCount - mPathFindStatistics.ExpandedNodeCount);
+	monitorResult.PathFindRejectTPS = static_cast<uint32_t>(statistics.RejectedCount - mPathFindStatistics.RejectedCount);
+	monitorResult.PathFindCacheHitTPS = static_cast<uint32_t>(statistics.CacheHitCount - mPathFindStatistics.CacheHitCount);
+	monitorResult.PathFindCacheMissTPS = static_cast<uint32_t>(statistics.CacheMissCount - mPathFindStatistics.CacheMissCount);
+	monitorResult.PathFindSuspendedCount = statistics.SuspendedCount;
+	monitorResult.PathFindSliceTPS = static_cast<uint32_t>(statistics.SliceCount - mPathFindStatistics.SliceCount);
+	monitorResult.PathFindPartialTPS = static_cast<uint32_t>(statistics.PartialCount - mPathFindStatistics.PartialCount);
+	monitorResult.PathFindAverageWaitMs = 0.0f;
+	monitorResult.PathFindAverageSearchMs = 0.0f;
+
+	if (startedCount > 0)
+	{
+		monitorResult.PathFindAverageWaitMs = (statistics.WaitMicroseconds - mPathFindStatistics.WaitMicroseconds) / 1000.0f / startedCount;
+		monitorResult.PathFindAverageSearchMs = (statistics.SearchMicroseconds - mPathFindStatistics.SearchMicroseconds) / 1000.0f / startedCount;
+	}
+
+	mPathFindStatistics = statistics;
+
+	// 쿼리 통계 분포 (PATHFIND_STATISTICS_ON일 때만 모인다)
+	PathFindService::QueryProfile profile = mPathFindService.TakeQueryProfile();
+
+	static_assert(sizeof(monitorResult.PathFindSearchUsHistogram) / sizeof(uint32_t) == PathFindService::QueryProfile::BUCKET_COUNT, "histogram size mismatch");
+
+	for (int i = 0; i < PathFindService::QueryProfile::BUCKET_COUNT; ++i)
+	{
+		monitorResult.PathFindSearchUsHistogram[i] = static_cast<uint32_t>(profile.ElapsedHistogram[i]);
+		monitorResult.PathFindExpandHistogram[i] = static_cast<uint32_t>(profile.ExpandedHistogram[i]);
+	}
+
+	monitorResult.PathFindAverageScannedCells = 0.0f;
+	monitorResult.PathFindAverageDecreaseKeys = 0.0f;
+	monitorResult.PathFindAverageLineOfSightCells = 0.0f;
+
+	if (profile.QueryCount > 0)
+	{
+		monitorResult.PathFindAverageScannedCells = static_cast<float>(profile.ScannedCellCount) / profile.QueryCount;
+		monitorResult.PathFindAverageDecreaseKeys = static_cast<float>(profile.DecreaseKeyCount) / profile.QueryCount;
+		monitorResult.PathFindAverageLineOfSightCells = static_cast<float>(profile.LineOfSightCellCount) / profile.QueryCount;
+	}
+}
+
+bool GameServer::SaveSlowPathFindQueries(const char* fileName)
+{
+	std::vector<PathFindService::QueryRecord> queries;
+	mPathFindService.GetSlowQueries(queries);
+
+	FILE* file = nullptr;
+
+	if (fopen_s(&file, fileName, "w") != 0 || file == nullptr)
+	{
+		return false;
+	}
+
+	for (const PathFindService::QueryRecord& query : queries)
+	{
+		const SearchStatistics& statistics = query.Statistics;
+
+		fprintf(file, "%d %d %d %d\n", query.StartX, query.StartY, query.EndX, query.EndY);
+
+		LOGF(ELogLevel::System, L"Slow PathFind (%d, %d) -> (%d, %d) : %lld us, created %d, expanded %d, scanned %d, decrease key %d, line of sight %d",
+			query.StartX, query.StartY, query.EndX, query.EndY, statistics.ElapsedNanoseconds / 1000,
+			statistics.CreatedNodeCount, statistics.ExpandedNodeCount, statistics.ScannedCellCount,
+			statistics.DecreaseKeyCount, statistics.LineOfSightCellCount);
+	}
+
+	return fclose(file) == 0;
 }
 
 Serializer* GameServer::Create_SC_CREATE_MY_CHARACTER(const int32_t id, const float x, const float y)
@@ -252,19 +509,19 @@ Serializer* GameServer::Create_SC_MOVE(const int32_t id, const float x, const fl
     return packet;
 }
 
-static Serializer& operator<<(Serializer& serializer, const std::list<Point>& points)
+static Serializer& operator<<(Serializer& serializer, const Path& points)
 {
-    for (auto it = points.begin(); it != points.end(); ++it)
+    for (const Point& point : points)
     {
-        serializer << (*it);
+        serializer << point;
     }
 
-    serializer << (int)points.size();
+    serializer << points.Size();
 
     return serializer;
 }
 
-Serializer* GameServer::Create_SC_PATH_FIND(const int32_t id, const std::list<Point>& points)
+Serializer* GameServer::Create_SC_PATH_FIND(const int32_t id, const Path& points)
 {
     Serializer* packet = Serializer::Alloc();
     *packet << EMessageType::MESSAGE_TYPE_SC_PATH_FIND << id << points;
@@ -283,6 +540,8 @@ unsigned int GameServer::updateThread(void* server)
 
 		std::lock_guard<std::mutex> lock(gameServer->mGameLock);
 
+		gameServer->applyPathFindResults();
+
 		for (const auto& visit : gameServer->mPlayerList)
 		{
 			Player* player = visit.second;
@@ -302,7 +561,7 @@ unsigned int GameServer::updateThread(void* server)
 			float deltaTime = (tick - player->GetLastTick()) / 1000.0f;
 			player->SetLastTick(tick);
 
-			Point destination = player->GetDestPositions().front();
+			Point destination = player->GetDestPositions().Front();
 
 			float magnitude = std::sqrt((player->GetX() - destination.X) * (player->GetX() - destination.X)
 				+ (player->GetY() - destination.Y) * (player->GetY() - destination.Y));
@@ -311,10 +570,12 @@ unsigned int GameServer::updateThread(void* server)
 			{
 				player->PopDestPositions();
 
-				if (player->GetDestPositions().size() == 0)
+				if (player->GetDestPositions().Empty())
 				{
 					player->SetStateToIdle();
 				}
+
+				gameServer->updateActivePath(player);
 			}
 			else
 			{
@@ -4,20 +4,25 @@
 #include "NetLibrary/NetServer/Serializer.h"
 #include "MessageType.h"
 #include "Player.h"
-#include "AStarPathFinder.h"
-#include "JPSPathFinder.h"
+#include "PathFindMap.h"
+#include "PathFindService.h"
+#include "PathSegmentIndex.h"
 
 #include <Windows.h>
 #include <list>
+#include <vector>
 #include <unordered_map>
 #include <mutex>
+#include <thread>
 
 class GameServer : public NetServer
 {
 public:
     GameServer(void)
         : NetServer()
-        , mlPathFinder(200, 200)
+        , mPathFindMap(200, 200)
+        , mPathFindService(mPathFindMap)
+        , mActivePaths(200, 200)
     {}
 
     virtual void Start(
@@ -28,25 +33,91 @@ public:
 
     inline uint32_t InitUpdateCount(void) { return mUpdateCount.exchange(0); }
 
+    // 길찾기 옵션 설정 (Start 전에 호출)
+    // expandBudgetPerTick : 업데이트 틱 당 길찾기에서 확장할 수 있는 노드 수 (0이면 제한 없음)
+    // cacheCapacity : 경로 캐시에 저장할 최대 경로 수 (0이면 캐시 사용 안 함)
+    inline void SetPathFindOption(const uint32_t threadCount, const uint32_t expandBudgetPerTick, const uint32_t cacheCapacity)
+    {
+        mPathFindThreadCount = threadCount;
+        mPathFindExpandBudgetPerTick = expandBudgetPerTick;
+        mPathFindCacheCapacity = cacheCapacity;
+    }
+
+    // 길찾기 조각 설정 (Start 전에 호출)
+    // expandCountPerSlice, microsecondsPerSlice : 길찾기 하나를 한 번에 이어서 찾는 최대 확장 노드 수와 시간 (0이면 제한 없음)
+    // maxActiveSearchCount : 멈춘 것을 포함해 동시에 진행 중인 길찾기 수의 한도
+    // microsecondsPerTick : 길찾기 스레드가 0개일 때 업데이트 스레드가 틱마다 길찾기에 쓰는 시간 (0이면 제한 없음)
+    inline void SetPathFindSliceOption(const uint32_t expandCountPerSlice, const uint32_t microsecondsPerSlice, const uint32_t maxActiveSearchCount, const uint32_t microsecondsPerTick)
+    {
+        mPathFindExpandCountPerSlice = expandCountPerSlice;
+        mPathFindMicrosecondsPerSlice = microsecondsPerSlice;
+        mPathFindMaxActiveSearchCount = maxActiveSearchCount;
+        mPathFindMicrosecondsPerTick = microsecondsPerTick;
+    }
+
+    // 부분 경로 설정 (Start 전에 호출)
+    // 새 이동 요청의 첫 탐색을 expandCount개 확장 또는 microseconds 안에 끝내지 못하면 가장 가까이 간 곳까지 먼저 이동시키고,
+    // 나머지 경로는 그 끝에서부터 다시 찾아 이어 붙인다 (둘 다 0이면 사용 안 함)
+    inline void SetPartialPathOption(const uint32_t expandCount, const uint32_t microseconds)
+    {
+        mPathFindPartialExpandCount = expandCount;
+        mPathFindPartialMicroseconds = microseconds;
+    }
+
+    // 랜드마크 휴리스틱 설정 (Start 전에 호출)
+    // landmarkCount : 랜드마크 수 (0이면 사용 안 함), memoryBudgetBytes : 거리표 크기 한도 (넘으면 랜드마크 수를 줄인다)
+    inline void SetLandmarkOption(const uint32_t landmarkCount, const size_t memoryBudgetBytes)
+    {
+        mPathFindLandmarkCount = landmarkCount;
+        mPathFindLandmarkMemoryBytes = memoryBudgetBytes;
+    }
+
+    // 목표 경계 상자 설정 (Start 전에 호출)
+    // 만드는 데 오래 걸리므로 map.bin으로 변환할 때 같이 만들어 두고, ChangeCells()로 맵이 바뀌면 재시작 전까지 쓰지 않는다
+    inline void SetGoalBoundsOption(const bool bGoalBounds)
+    {
+        mbPathFindGoalBounds = bGoalBounds;
+    }
+
+    // 맵의 칸들을 막거나 연다 (게임 락을 잡으므로 업데이트 스레드 밖에서 호출)
+    // 길찾기 스레드를 잠시 멈추고 맵을 바꾼 뒤, 막힌 칸을 지나는 이동 경로만 지금 위치에서 다시 찾는다
+    void ChangeCells(const Point* cells, const int count, const bool bBlock);
+
+    // 시작 이후 가장 오래 걸린 길찾기 쿼리들을 느린 순서로 저장한다 (한 줄에 "시작X 시작Y 도착X 도착Y", 쿼리 별 통계는 로그로 남긴다)
+    // 벤치마크에 map.txt와 같이 넘기면 (PathFinderBenchmark query-stats 파일 map.txt) 같은 쿼리를 다시 찾아본다
+    bool SaveSlowPathFindQueries(const char* fileName);
+
 private:
 
     // NetServer을(를) 통해 상속됨
     virtual void OnAccept(const uint64_t sessionID) override;
     virtual void OnReceive(const uint64_t sessionID, Serializer* packet) override;
     virtual void OnRelease(const uint64_t sessionID) override;
+    virtual void OnMonitor(MonitoringVariables& monitorResult) override;
 
 private: // 메세지 처리
 
     void process_CS_MOVE(const uint64_t sessionID, const float x, const float y);
     void process_CS_HEARTBEAT(const uint64_t sessionID);
 
+private: // 길찾기
+
+    // 완료된 길찾기 결과들을 플레이어에게 적용한다 (게임 락을 잡은 상태에서 호출)
+    void applyPathFindResults(void);
+
+    // 이동 중인 플레이어의 남은 경로(지금 위치 + 웨이포인트들)를 색인에 넣고, 멈췄다면 뺀다 (게임 락을 잡은 상태에서 호출)
+    void updateActivePath(Player* player);
+
+    // cells 중 하나라도 지나는 이동 경로를 버리고 지금 위치에서 원래 목적지까지 다시 요청한다 (게임 락을 잡은 상태에서 호출)
+    void replanPathsCrossing(const Point* cells, const int count);
+
 private: // 메세지 생성
 
     static Serializer* Create_SC_CREATE_MY_CHARACTER(const int32_t id, const float x, const float y);
     static Serializer* Create_SC_CREATE_OTHER_CHARACTER(const int32_t id, const float x, const float y);
     static Serializer* Create_SC_DELETE_CHARACTER(const int32_t id);
     static Serializer* Create_SC_MOVE(const int32_t id, const float x, const float y);
-    static Serializer* Create_SC_PATH_FIND(const int32_t id, const std::list<Point>& points);
+    static Serializer* Create_SC_PATH_FIND(const int32_t id, const Path& points);
 
 private: // 스레드
 
@@ -108,7 +179,25 @@ private:
     std::unordered_map<uint64_t, Player*>   mPlayerList;
     std::list<Player*>                      mSector[RANGE_MOVE_BOTTOM / SECTOR_SIZE_Y][RANGE_MOVE_RIGHT / SECTOR_SIZE_X];
     inline static OBJECT_POOL<Player>       mPlayerPool;
-    JPSPathFinder                           mlPathFinder;
+
+    MapFile                                 mMapFile;           // mPathFindMap이 매핑된 구간을 그대로 쓰므로 먼저 선언 (나중에 해제)
+    PathFindMap                             mPathFindMap;       // 맵 로딩 이후에는 ChangeCells()로만 수정
+    PathFindService                         mPathFindService;
+    PathSegmentIndex                        mActivePaths;       // 이동 중인 플레이어들의 남은 경로 (키는 세션 ID)
+    std::vector<PathFindService::Result>    mPathFindResults;   // 업데이트 스레드에서만 사용
+    PathFindService::Statistics             mPathFindStatistics{};  // 직전 OnMonitor() 시점의 통계
+    uint32_t                                mPathFindThreadCount = 2;
+    uint32_t                                mPathFindExpandBudgetPerTick = 0;
+    uint32_t                                mPathFindCacheCapacity = 0;
+    uint32_t                                mPathFindExpandCountPerSlice = 0;
+    uint32_t                                mPathFindMicrosecondsPerSlice = 0;
+    uint32_t                                mPathFindMaxActiveSearchCount = 64;
+    uint32_t                                mPathFindMicrosecondsPerTick = 0;
+    uint32_t                                mPathFindPartialExpandCount = 0;
+    uint32_t                                mPathFindPartialMicroseconds = 0;
+    uint32_t                                mPathFindLandmarkCount = 0;
+    size_t                                  mPathFindLandmarkMemoryBytes = 0;
+    bool                                    mbPathFindGoalBounds = false;
 
     std::atomic<uint32_t> mUpdateCount = 0;
 };
\ No newline at end of file
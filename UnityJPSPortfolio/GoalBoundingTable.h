@@ -0,0 +1,270 @@
+// 목표 경계 상자 (Goal Bounding) 테이블
+// 칸마다 8방향 각각에 대해, 그 칸에서 최단 경로의 첫 이동이 그 방향인 모든 칸을 감싸는 경계 상자를 미리 계산해둡니다.
+// 탐색 중에는 노드에서 어떤 방향으로 점프하기 전에 그 방향의 상자에 목적지가 없다면 방향 전체를 건너뜁니다 (JPS + GB).
+// 최단 경로가 여러 개인 칸은 그 첫 이동 방향들의 상자에 모두 넣으므로, 건너뛰는 방향으로 시작하는 최단 경로는 없고
+// JPS가 찾는 정규 최단 경로(각 점프 포인트에서 남은 구간도 최단 경로)는 그대로 남습니다.
+// 칸마다 다익스트라를 한 번씩 하므로 만드는 데 O(칸 수²)가 걸리고 (스레드를 나눠서 만든다), 크기는 칸마다 64 byte입니다.
+// 따라서 작은 정적 맵을 맵 파일(MapFile)에 미리 만들어 두고 쓰는 용도이며, 맵이 바뀌면 Invalidate() 이후로는 쓰지 않습니다.
+
+/************************************** 사용법 **************************************/
+// GoalBoundingTable goalBounds(grid);
+// goalBounds.Build(threadCount);
+//
+// // (x, y)에서 (dx, dy) 방향으로 시작하는 최단 경로로 목적지에 갈 수 있는가
+// if (goalBounds.Contains(x, y, GoalBoundingTable::GetDirection(dx, dy), endX, endY))
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+#include "BitGrid.h"
+#include "GridDijkstra.h"
+
+class GoalBoundingTable
+{
+public:
+	// 경계 상자 (비어 있다면 MinX > MaxX)
+	struct Bounds
+	{
+		uint16_t MinX;
+		uint16_t MinY;
+		uint16_t MaxX;
+		uint16_t MaxY;
+	};
+
+	enum
+	{
+		DIRECTION_COUNT = GridDirection::COUNT,
+	};
+
+public:
+	GoalBoundingTable(const BitGrid& grid)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+	{
+		assert(mWidth <= UINT16_MAX && mHeight <= UINT16_MAX);
+
+		mBounds = new Bounds[static_cast<size_t>(mWidth) * mHeight * DIRECTION_COUNT];
+	}
+
+	// 이미 만들어둔 테이블(맵 파일의 매핑 등)을 복사 없이 그대로 사용한다 (Build() 불필요, 해제하지 않는다)
+	// 배치는 GetData()와 같아야 하고, 다시 Build()할 때 고쳐도 되는 메모리여야 한다
+	GoalBoundingTable(const BitGrid& grid, Bounds* bounds)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+		, mBounds(bounds)
+		, mbOwnsBounds(false)
+		, mbValid(true)
+	{
+	}
+
+	~GoalBoundingTable()
+	{
+		if (mbOwnsBounds)
+		{
+			delete[] mBounds;
+		}
+	}
+
+	GoalBoundingTable(const GoalBoundingTable& other) = delete;
+	GoalBoundingTable& operator=(const GoalBoundingTable& other) = delete;
+
+	// 모든 칸의 경계 상자를 만든다 (threadCount 개의 스레드로 출발 칸을 나눠서)
+	void Build(int threadCount)
+	{
+		threadCount = threadCount > 1 ? threadCount : 1;
+
+		std::vector<std::thread> threads;
+
+		for (int i = 1; i < threadCount; ++i)
+		{
+			threads.emplace_back(&GoalBoundingTable::buildBounds, this, i, threadCount);
+		}
+
+		// 첫 몫은 호출한 스레드가 맡는다
+		buildBounds(0, threadCount);
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		mbValid = true;
+	}
+
+	// 맵이 바뀌었다 (다시 Build()하기 전까지 IsValid()가 false)
+	inline void Invalidate() { mbValid = false; }
+	inline bool IsValid() const { return mbValid; }
+
+	// (x, y)에서 direction 방향으로 시작하는 최단 경로로 (endX, endY)에 갈 수 있는가 (false라면 그 방향은 건너뛰어도 된다)
+	inline bool Contains(int x, int y, int direction, int endX, int endY) const
+	{
+		const Bounds& bounds = mBounds[(static_cast<size_t>(y) * mWidth + x) * DIRECTION_COUNT + direction];
+
+		return bounds.MinX <= endX && endX <= bounds.MaxX && bounds.MinY <= endY && endY <= bounds.MaxY;
+	}
+
+	// (dx, dy) 방향의 번호 (GridDirection의 번호)
+	inline static constexpr int GetDirection(int dx, int dy)
+	{
+		constexpr int DIRECTIONS[9] = { 1, 2, 3, 0, -1, 4, 7, 6, 5 };
+		return DIRECTIONS[(dy + 1) * 3 + (dx + 1)];
+	}
+
+	// [칸][방향] 순서의 테이블 전체 (맵 파일 저장용)
+	inline const Bounds* GetData() const { return mBounds; }
+
+	inline size_t GetReservedBytes() const
+	{
+		return static_cast<size_t>(mWidth) * mHeight * DIRECTION_COUNT * sizeof(Bounds);
+	}
+
+private:
+	// threadIndex 번째 스레드는 threadIndex, threadIndex + threadCount, ... 번째 칸을 맡는다
+	void buildBounds(int threadIndex, int threadCount)
+	{
+		const int stride = mWidth + 2;
+
+		// 한 칸씩 넓힌 배열 (막힌 칸과 맵 바깥은 BLOCKED), 출발 칸마다 복사해서 쓴다
+		std::vector<int> initialDistances(static_cast<size_t>(stride) * (mHeight + 2), static_cast<int>(GridDijkstra::BLOCKED));
+
+		for (int y = 0; y < mHeight; ++y)
+		{
+			for (int x = 0; x < mWidth; ++x)
+			{
+				if (mGrid.IsWalkable(x, y))
+				{
+					initialDistances[(y + 1) * stride + (x + 1)] = GridDijkstra::NOT_VISITED;
+				}
+
+			}
+		}
+
+		std::vector<int> distances(initialDistances.size());
+		std::vector<uint8_t> firstDirections(initialDistances.size());
+		GridDijkstra dijkstra(stride);
+
+		for (int cell = threadIndex; cell < mWidth * mHeight; cell += threadCount)
+		{
+			Bounds* bounds = mBounds + static_cast<size_t>(cell) * DIRECTION_COUNT;
+
+			for (int direction = 0; direction < DIRECTION_COUNT; ++direction)
+			{
+				bounds[direction] = Bounds{ UINT16_MAX, UINT16_MAX, 0, 0 };
+			}
+
+			if (mGrid.IsWalkable(cell % mWidth, cell / mWidth))
+			{
+				std::copy(initialDistances.begin(), initialDistances.end(), distances.begin());
+				computeBounds(cell % mWidth, cell / mWidth, dijkstra, distances, firstDirections, bounds);
+			}
+		}
+	}
+
+	// 칸의 첫 이동 방향들을 이웃에 물려주고, 확정된 칸을 그 방향들의 상자에 넣는다
+	struct BoundsVisitor : GridDijkstra::Visitor
+	{
+		BoundsVisitor(uint8_t* firstDirections, int stride)
+			: FirstDirections(firstDirections)
+			, Stride(stride)
+		{
+			for (int direction = 0; direction < DIRECTION_COUNT; ++direction)
+			{
+				BoundsByDirection[direction] = Bounds{ UINT16_MAX, UINT16_MAX, 0, 0 };
+			}
+		}
+
+		uint8_t* FirstDirections;
+		int Stride;
+		Bounds BoundsByDirection[DIRECTION_COUNT];
+
+		inline void OnSettle(int cell, int)
+		{
+			const uint16_t x = static_cast<uint16_t>(cell % Stride - 1);
+			const uint16_t y = static_cast<uint16_t>(cell / Stride - 1);
+
+			// 대부분의 칸은 첫 이동 방향이 한두 개뿐이므로 켜진 비트만 본다
+			for (uint32_t directions = FirstDirections[cell]; directions != 0; directions &= directions - 1)
+			{
+				Bounds& box = BoundsByDirection[getLowestBit(directions)];
+				box.MinX = x < box.MinX ? x : box.MinX;
+				box.MinY = y < box.MinY ? y : box.MinY;
+				box.MaxX = x > box.MaxX ? x : box.MaxX;
+				box.MaxY = y > box.MaxY ? y : box.MaxY;
+			}
+		}
+
+		inline void OnImprove(int cell, int nextCell, int)
+		{
+			FirstDirections[nextCell] = FirstDirections[cell];
+		}
+
+		// 같은 비용의 다른 최단 경로
+		inline void OnTie(int cell, int nextCell, int)
+		{
+			FirstDirections[nextCell] |= FirstDirections[cell];
+		}
+	};
+
+	// source에서 다익스트라를 하면서, 칸마다 최단 경로의 첫 이동 방향들(비트마스크)을 구해 그 방향들의 상자를 넓힌다
+	// 칸을 확정할 때는 그보다 가까운 칸들이 모두 처리되었으므로 첫 이동 방향들도 확정되어 있다
+	void computeBounds(int sourceX, int sourceY, GridDijkstra& dijkstra, std::vector<int>& ioDistances,
+		std::vector<uint8_t>& outFirstDirections, Bounds* outBounds) const
+	{
+		const int stride = mWidth + 2;
+
+		// uint8_t 쓰기가 vector 내부를 다시 읽게 만들지 않도록 포인터로만 다룬다
+		int* distances = ioDistances.data();
+		BoundsVisitor visitor(outFirstDirections.data(), stride);
+
+		int sourceCell = (sourceY + 1) * stride + (sourceX + 1);
+		distances[sourceCell] = 0;
+
+		// 출발 칸의 이웃은 그 방향 자체가 첫 이동이다 (이웃끼리는 출발 칸을 거치는 것보다 가까울 수 없다)
+		for (int direction = 0; direction < DIRECTION_COUNT; ++direction)
+		{
+			int nextCell = sourceCell + dijkstra.GetCellRelative(direction);
+
+			if (distances[nextCell] == GridDijkstra::BLOCKED)
+			{
+				continue;
+			}
+
+			visitor.FirstDirections[nextCell] = static_cast<uint8_t>(1 << direction);
+			dijkstra.Push(distances, nextCell, OctileCost::Get(direction));
+		}
+
+		dijkstra.Run(distances, visitor);
+
+		std::copy(visitor.BoundsByDirection, visitor.BoundsByDirection + DIRECTION_COUNT, outBounds);
+	}
+
+	inline static int getLowestBit(uint32_t bits)
+	{
+		int index = 0;
+
+		while ((bits & 1) == 0)
+		{
+			bits >>= 1;
+			index++;
+		}
+
+		return index;
+	}
+
+private:
+	const BitGrid& mGrid;
+	const int mWidth;
+	const int mHeight;
+
+	Bounds* mBounds = nullptr;			// [칸][방향]
+	bool mbOwnsBounds = true;			// 밖에서 받은 테이블이라면 false
+	bool mbValid = false;
+};
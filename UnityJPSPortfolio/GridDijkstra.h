@@ -0,0 +1,132 @@
+// 8방향 격자의 다익스트라 (다이얼 알고리즘)
+// 간선 비용이 5, 7 뿐이므로 힙 대신 거리 % BUCKET_COUNT 번째 버킷에 칸을 넣고, 거리 0부터 버킷을 차례로 비웁니다.
+// 거리 배열은 맵보다 한 칸씩 넓게 잡아서 (테두리는 BLOCKED) 이웃 칸이 맵 바깥인지 따로 검사하지 않습니다.
+// 칸을 확정하거나 거리를 줄일 때 할 일은 Visitor로 넘깁니다 (첫 이동 방향, 흐름 방향 등, 템플릿이므로 인라인된다).
+// 랜드마크 거리표, 목표 경계 상자, 흐름장, HPA*의 클러스터 안 거리가 모두 이것으로 계산합니다.
+
+/************************************** 사용법 **************************************/
+// GridDijkstra dijkstra(stride); // stride = 너비 + 2, 버킷은 Run()마다 재사용
+//
+// // distances : 막힌 칸과 테두리는 BLOCKED, 나머지는 NOT_VISITED
+// dijkstra.Push(distances, sourceCell, 0);
+// dijkstra.Run(distances);          // 거리만
+// dijkstra.Run(distances, visitor); // OnSettle(), OnImprove(), OnTie() 중 필요한 것만 정의 (GridDijkstra::Visitor 상속)
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <cassert>
+
+#include "GridDirection.h"
+
+class GridDijkstra
+{
+public:
+	enum
+	{
+		NOT_VISITED = -1,
+		BLOCKED = -2,
+		BUCKET_COUNT = 8,			// 간선 비용의 최댓값(7)보다 커야 한다
+	};
+
+	// 아무 일도 하지 않는 Visitor (필요한 함수만 다시 정의한다)
+	struct Visitor
+	{
+		// 가장 가까운 칸부터 거리가 확정될 때 (그보다 가까운 칸들은 모두 확정되었다)
+		inline void OnSettle(int, int) {}
+
+		// cell에서 direction 방향의 nextCell로 가는 것이 지금까지 찾은 nextCell의 거리보다 짧을 때 (거리는 이미 바뀌었다)
+		inline void OnImprove(int, int, int) {}
+
+		// cell을 거쳐도 nextCell까지의 거리가 같을 때 (같은 비용의 다른 최단 경로)
+		inline void OnTie(int, int, int) {}
+	};
+
+public:
+	explicit GridDijkstra(int stride)
+	{
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+		{
+			mCellRelatives[direction] = GridDirection::Y[direction] * stride + GridDirection::X[direction];
+		}
+	}
+
+	// 칸을 distance로 연다 (출발 칸, 또는 출발 칸의 이웃을 직접 열 때, Run()은 거리 0부터 꺼내므로 distance < BUCKET_COUNT)
+	inline void Push(int* distances, int cell, int distance)
+	{
+		assert(distance >= 0 && distance < BUCKET_COUNT);
+
+		distances[cell] = distance;
+		mBuckets[distance % BUCKET_COUNT].push_back(cell);
+		mPendingCount++;
+	}
+
+	inline void Run(int* distances)
+	{
+		Visitor visitor;
+		Run(distances, visitor);
+	}
+
+	// 열린 칸이 없을 때까지 가까운 칸부터 확정하며 이웃을 연다 (닿지 못한 칸은 NOT_VISITED로 남는다)
+	template <typename VisitorType>
+	void Run(int* distances, VisitorType& visitor)
+	{
+		for (int distance = 0; mPendingCount > 0; ++distance)
+		{
+			// 간선 비용이 BUCKET_COUNT보다 작으므로 꺼내는 동안 이 버킷에는 추가되지 않는다
+			std::vector<int>& bucket = mBuckets[distance % BUCKET_COUNT];
+			const int* cells = bucket.data();
+			const int cellCount = static_cast<int>(bucket.size());
+
+			mPendingCount -= cellCount;
+
+			for (int i = 0; i < cellCount; ++i)
+			{
+				const int cell = cells[i];
+
+				// 더 짧은 거리로 이미 처리된 칸
+				if (distances[cell] != distance)
+				{
+					continue;
+				}
+
+				visitor.OnSettle(cell, distance);
+
+				for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+				{
+					const int nextCell = cell + mCellRelatives[direction];
+					const int nextDistance = distance + OctileCost::Get(direction);
+					const int oldDistance = distances[nextCell];
+
+					// 막힌 칸(BLOCKED)은 음수이므로 두 조건에 모두 걸리지 않는다
+					if (oldDistance == NOT_VISITED || nextDistance < oldDistance)
+					{
+						distances[nextCell] = nextDistance;
+						mBuckets[nextDistance % BUCKET_COUNT].push_back(nextCell);
+						mPendingCount++;
+
+						visitor.OnImprove(cell, nextCell, direction);
+					}
+					else if (nextDistance == oldDistance)
+					{
+						visitor.OnTie(cell, nextCell, direction);
+					}
+				}
+			}
+
+			bucket.clear();
+		}
+	}
+
+	// 한 칸씩 넓힌 배열에서 direction 방향 이웃 칸까지의 차이
+	inline int GetCellRelative(int direction) const
+	{
+		return mCellRelatives[direction];
+	}
+
+private:
+	int mCellRelatives[GridDirection::COUNT];
+	std::vector<int> mBuckets[BUCKET_COUNT];
+	int mPendingCount = 0;
+};
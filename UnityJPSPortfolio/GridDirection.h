@@ -0,0 +1,50 @@
+// 8방향 격자의 방향 표와 이동 비용
+// 길찾기(GridSearchPolicy.h)와 미리 계산하는 표들(LandmarkTable, GoalBoundingTable, FlowField 등)이 같은 방향 번호를 씁니다.
+// 방향 번호는 W부터 시계 방향이고, 홀수 번째가 대각선, direction과 GetOpposite(direction)이 반대 방향입니다.
+
+/************************************** 사용법 **************************************/
+// for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+// {
+//     int x = node.X + GridDirection::X[direction];
+//     int g = node.G + OctileCost::Get(direction);
+// }
+/************************************************************************************/
+
+#pragma once
+
+// 8방향 상대 좌표 (W부터 시계 방향, 홀수 번째가 대각선)
+struct GridDirection final
+{
+	enum
+	{
+		COUNT = 8,
+	};
+
+	static constexpr int X[COUNT] = { -1, -1,  0,  1,  1,  1,  0, -1 };
+	static constexpr int Y[COUNT] = {  0, -1, -1, -1,  0,  1,  1,  1 };
+
+	inline static constexpr bool IsDiagonal(int direction) { return (direction & 1) == 1; }
+
+	inline static constexpr int GetOpposite(int direction) { return (direction + COUNT / 2) % COUNT; }
+};
+
+// 직선 5, 대각선 7 (√2 ≒ 1.4)
+struct OctileCost final
+{
+	enum
+	{
+		STRAIGHT = 5,
+		DIAGONAL = 7,
+	};
+
+	// 한 칸 이동 비용
+	inline static constexpr int Get(int direction) { return GridDirection::IsDiagonal(direction) ? DIAGONAL : STRAIGHT; }
+
+	// 벽이 없을 때 가로 xGap, 세로 yGap 칸을 가는 최소 비용
+	inline static constexpr int GetDistance(int xGap, int yGap)
+	{
+		return xGap < yGap
+			? xGap * DIAGONAL + (yGap - xGap) * STRAIGHT
+			: yGap * DIAGONAL + (xGap - yGap) * STRAIGHT;
+	}
+};
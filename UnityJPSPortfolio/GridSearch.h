@@ -0,0 +1,316 @@
+// AStarPathFinder와 JPSPathFinder가 같이 쓰는 격자 최선 우선 탐색 코어
+// 후속 노드 생성기(Successors), 휴리스틱(Heuristic), 비용 모델(CostModel)을 템플릿 인자로 받아 컴파일 시간에 묶으므로
+// OPEN LIST에서 꺼내고, 후속 노드를 열고, G를 갱신하는 안쪽 루프에 가상 호출이 없습니다 (정책은 GridSearchPolicy.h, JumpPointSuccessors.h).
+// OPEN LIST, 셀 별 노드 번호, 노드 할당기는 탐색기마다 하나씩 가지는 GridSearchState에 두고, GridSearch는 탐색 한 번 동안만 만들어 씁니다.
+// 노드는 NodeArena의 SoA 배열에 있고 번호(NodeIndex)로 가리키며, OPEN LIST는 (F, H, 번호) 키만 비교합니다.
+
+/************************************** 사용법 **************************************/
+// GridSearchState state(grid);
+//
+// state.Clear();
+// GridSearch<NeighborSuccessors, OctileHeuristic<>> search(state, NeighborSuccessors(grid), OctileHeuristic<>(endX, endY));
+// NodeIndex destination = search.Search(startX, startY, endX, endY); // 경로가 없다면 NULL_NODE
+//
+// // 나눠서 찾기 (틱마다 같은 정책으로 GridSearch를 다시 만들어 Resume())
+// search.Start(startX, startY);
+// while (search.Resume(endX, endY, 1000) == ESearchStatus::Suspended) { ... }
+// NodeIndex destination = state.GetDestination();
+//
+// state.ReduceNodes(destination);
+// state.CopyPoints(destination, points);
+/************************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+
+#include "IndexedPriorityQueue.h"
+#include "SearchStateGrid.h"
+#include "NodeArena.h"
+#include "LineOfSight.h"
+#include "BitGrid.h"
+#include "Path.h"
+#include "GridSearchPolicy.h"
+#include "SearchStatistics.h"
+
+// 탐색 한 번 동안 사용하는 상태 (탐색 사이에는 Clear()로 재사용)
+class GridSearchState
+{
+public:
+	// 맵은 이 객체보다 오래 살아 있어야 한다
+	// 노드의 좌표는 16비트이므로 맵의 한 변은 NodeArena::MAX_COORDINATE + 1칸까지
+	explicit GridSearchState(const BitGrid& grid)
+		: mGrid(grid)
+		, mSearchState(grid.GetWidth(), grid.GetHeight())
+	{
+		assert(grid.GetWidth() <= NodeArena::MAX_COORDINATE + 1 && grid.GetHeight() <= NodeArena::MAX_COORDINATE + 1);
+	}
+
+	GridSearchState(const GridSearchState& other) = delete;
+	GridSearchState& operator=(const GridSearchState& other) = delete;
+
+	inline const BitGrid& GetGrid() const { return mGrid; }
+	inline OpenList& GetOpenList() { return mOpenList; }
+	inline SearchStateGrid& GetSearchState() { return mSearchState; }
+	inline NodeArena& GetNodeArena() { return mNodeArena; }
+	inline const NodeArena& GetNodeArena() const { return mNodeArena; }
+
+	// 마지막 탐색에서 OPEN LIST에서 꺼내 확장한 노드 수
+	inline int GetExpandedNodeCount() const { return mExpandedNodeCount; }
+	inline void AddExpandedNode() { mExpandedNodeCount++; }
+
+	// 마지막 탐색에서 OPEN LIST에 넣고, 꺼내고, 키를 줄인 횟수
+	inline int GetHeapOperationCount() const { return mHeapOperationCount; }
+	inline void AddHeapOperation() { mHeapOperationCount++; }
+
+	// 마지막 탐색에서 만든 노드 수
+	inline int GetAllocatedNodeCount() const { return mNodeArena.GetAllocatedCount(); }
+
+	// 마지막 탐색의 통계 (만든 노드 수와 확장한 노드 수는 위의 값을 그대로 담는다)
+	inline SearchStatistics GetStatistics() const
+	{
+		SearchStatistics statistics = mStatistics;
+		statistics.CreatedNodeCount = GetAllocatedNodeCount();
+		statistics.ExpandedNodeCount = mExpandedNodeCount;
+
+		return statistics;
+	}
+
+	// 통계 세기 (PATHFIND_STATISTICS_ON이 아니라면 아무것도 하지 않는다)
+	inline void AddScannedCells(int count) { PATHFIND_STATISTICS(mStatistics.ScannedCellCount += count); }
+	inline void AddDecreaseKey() { PATHFIND_STATISTICS(mStatistics.DecreaseKeyCount++); }
+	inline void AddElapsedNanoseconds(int64_t nanoseconds) { PATHFIND_STATISTICS(mStatistics.ElapsedNanoseconds += nanoseconds); }
+
+	// 직선 검사 한 번 (막혀서 일찍 끝났더라도 직선 위의 칸 수를 센다)
+	inline void AddLineOfSightCheck(int startX, int startY, int endX, int endY)
+	{
+		PATHFIND_STATISTICS(mStatistics.LineOfSightCellCount += (abs(endX - startX) > abs(endY - startY) ? abs(endX - startX) : abs(endY - startY)) + 1);
+	}
+
+	// GridSearch::Resume()이 찾은 도착 노드 (아직 못 찾았다면 NULL_NODE)
+	inline NodeIndex GetDestination() const { return mDestination; }
+	inline void SetDestination(NodeIndex destination) { mDestination = destination; }
+
+	void Clear()
+	{
+		mOpenList.Clear();
+		mSearchState.NewGeneration();
+		mNodeArena.Reset();
+		mExpandedNodeCount = 0;
+		mHeapOperationCount = 0;
+		mDestination = NULL_NODE;
+		mStatistics = SearchStatistics{};
+	}
+
+	// OPEN LIST, 셀 별 노드 번호, 노드 배열의 총 크기 (byte), 맵은 포함하지 않는다
+	inline size_t GetReservedBytes() const
+	{
+		return mOpenList.GetReservedBytes() + mSearchState.GetReservedBytes() + mNodeArena.GetReservedBytes();
+	}
+
+	// 이번 탐색에서 만든 노드 중 H가 가장 작은 (같다면 G가 작은, 그것도 같다면 먼저 만든) 노드, 만든 노드가 없다면 NULL_NODE
+	// 탐색을 끝까지 하지 못했을 때 목적지에 가장 가까이 간 노드로 쓴다
+	NodeIndex FindClosestNode() const
+	{
+		NodeIndex closestNode = NULL_NODE;
+
+		for (NodeIndex node = 0; node < mNodeArena.GetAllocatedCount(); ++node)
+		{
+			if (closestNode == NULL_NODE || mNodeArena.GetH(node) < mNodeArena.GetH(closestNode)
+				|| (mNodeArena.GetH(node) == mNodeArena.GetH(closestNode) && mNodeArena.GetG(node) < mNodeArena.GetG(closestNode)))
+			{
+				closestNode = node;
+			}
+		}
+
+		return closestNode;
+	}
+
+	// 불필요한 중간 노드들의 연결을 끊는다
+	// 직선 검사는 뒤쪽 노드에서 앞쪽 노드 방향으로 한다
+	void ReduceNodes(NodeIndex destination)
+	{
+		NodeIndex startNode = destination;
+		NodeIndex endNode = mNodeArena.GetParent(destination);
+
+		while (endNode != NULL_NODE)
+		{
+			const int startX = mNodeArena.GetX(startNode);
+			const int startY = mNodeArena.GetY(startNode);
+			const int endX = mNodeArena.GetX(endNode);
+			const int endY = mNodeArena.GetY(endNode);
+
+			AddLineOfSightCheck(startX, startY, endX, endY);
+
+			if (LineOfSight::IsClear(mGrid, startX, startY, endX, endY))
+			{
+				mNodeArena.SetParent(startNode, endNode);
+				endNode = mNodeArena.GetParent(endNode);
+			}
+			else
+			{
+				startNode = mNodeArena.GetParent(startNode);
+			}
+		}
+	}
+
+	// 도착 노드부터 부모를 따라가며 좌표를 시작점부터의 순서로 outPoints에 담는다 (destination이 NULL_NODE면 비운다)
+	void CopyPoints(NodeIndex destination, Path& outPoints) const
+	{
+		int pointCount = 0;
+
+		for (NodeIndex visit = destination; visit != NULL_NODE; visit = mNodeArena.GetParent(visit))
+		{
+			pointCount++;
+		}
+
+		outPoints.Resize(pointCount);
+
+		// 도착점부터 거꾸로 채운다
+		for (NodeIndex visit = destination; visit != NULL_NODE; visit = mNodeArena.GetParent(visit))
+		{
+			pointCount--;
+			outPoints[pointCount] = Point{ mNodeArena.GetX(visit), mNodeArena.GetY(visit) };
+		}
+	}
+
+private:
+	const BitGrid& mGrid;
+	OpenList mOpenList;
+	SearchStateGrid mSearchState;
+	NodeArena mNodeArena;
+	int mExpandedNodeCount = 0;
+	int mHeapOperationCount = 0;
+	NodeIndex mDestination = NULL_NODE;
+	SearchStatistics mStatistics{};		// 만든 노드 수와 확장한 노드 수는 GetStatistics()에서 채운다
+};
+
+// 나눠서 찾는 탐색(GridSearch::Resume())의 진행 상태
+enum class ESearchStatus
+{
+	Found,			// 도착 노드를 꺼냈다
+	NotFound,		// OPEN LIST가 비었다 (경로 없음)
+	Suspended,		// 확장 수 한도에 걸려 멈췄다 (OPEN LIST와 G값은 GridSearchState에 그대로 남아 있다)
+};
+
+template <typename Successors, typename Heuristic, typename CostModel = OctileCost>
+class GridSearch
+{
+public:
+	typedef CostModel Cost;
+
+	// 정책 객체들은 탐색 한 번 동안만 쓰므로 값으로 들고 있는다
+	GridSearch(GridSearchState& state, const Successors& successors, const Heuristic& heuristic)
+		: mState(state)
+		, mOpenList(state.GetOpenList())
+		, mSearchState(state.GetSearchState())
+		, mNodeArena(state.GetNodeArena())
+		, mSuccessors(successors)
+		, mHeuristic(heuristic)
+	{
+	}
+
+	// 도착 노드를 반환한다 (경로가 없다면 NULL_NODE)
+	// 부모를 따라가면 시작 노드까지 거슬러 올라가고, 노드 번호는 다음 GridSearchState::Clear() 전까지 유효하다
+	// 시작 칸과 도착 칸은 막혀 있지 않아야 한다
+	NodeIndex Search(int startX, int startY, int endX, int endY)
+	{
+		Start(startX, startY);
+		Resume(endX, endY, 0);
+
+		return mState.GetDestination();
+	}
+
+	// 시작 노드만 열어둔다 (이후 Resume()으로 확장한다)
+	inline void Start(int startX, int startY)
+	{
+		Relax(startX, startY, 0, NULL_NODE);
+	}
+
+	// OPEN LIST에 남아 있는 노드들을 최대 maxExpandedNodeCount개 확장한다 (0 이하면 끝날 때까지)
+	// 탐색 상태는 모두 GridSearchState에 있으므로, 같은 정책으로 다시 만든 GridSearch로 이어서 찾을 수 있다
+	// Found라면 도착 노드는 GridSearchState::GetDestination()
+	ESearchStatus Resume(int endX, int endY, int maxExpandedNodeCount)
+	{
+		int expandedNodeCount = 0;
+
+		while (mOpenList.Empty() == false)
+		{
+			if (maxExpandedNodeCount > 0 && expandedNodeCount == maxExpandedNodeCount)
+			{
+				return ESearchStatus::Suspended;
+			}
+
+			const NodeIndex currentNode = mOpenList.Top();
+			mOpenList.Pop();
+			mState.AddHeapOperation();
+			mState.AddExpandedNode();
+			expandedNodeCount++;
+
+			const ExpandedNode expandedNode{ currentNode, mNodeArena.GetParent(currentNode),
+				mNodeArena.GetX(currentNode), mNodeArena.GetY(currentNode), mNodeArena.GetG(currentNode) };
+
+			// Find
+			if (expandedNode.X == endX && expandedNode.Y == endY)
+			{
+				mState.SetDestination(currentNode);
+				return ESearchStatus::Found;
+			}
+
+			mSuccessors.Expand(*this, expandedNode, endX, endY);
+		}
+
+		return ESearchStatus::NotFound;
+	}
+
+	// 후속 노드 생성기가 노드의 부모 좌표 등을 읽을 때
+	inline const NodeArena& GetNodeArena() const
+	{
+		return mNodeArena;
+	}
+
+	// 후속 노드 생성기가 점프하면서 지나간 칸 수를 센다 (SearchStatistics)
+	inline void AddScannedCells(int count)
+	{
+		mState.AddScannedCells(count);
+	}
+
+	// (x, y)에 G가 g인 노드를 연다 (이미 열린 노드라면 g가 더 작을 때만 부모와 G를 바꾼다)
+	// 일관적인 휴리스틱만 쓰므로 닫힌 노드의 G가 다시 줄어드는 일은 없다
+	inline void Relax(int x, int y, int g, NodeIndex parent)
+	{
+		const NodeIndex node = mSearchState.GetNode(x, y);
+
+		if (node != NULL_NODE)
+		{
+			if (g < mNodeArena.GetG(node))
+			{
+				assert(mOpenList.Contains(node));
+
+				mNodeArena.SetG(node, g);
+				mNodeArena.SetParent(node, parent);
+
+				mOpenList.DecreaseKey(node, g + mNodeArena.GetH(node));
+				mState.AddHeapOperation();
+				mState.AddDecreaseKey();
+			}
+
+			return;
+		}
+
+		const int h = mHeuristic.Get(x, y);
+		const NodeIndex newNode = mNodeArena.Alloc(x, y, g, parent, h);
+		mOpenList.Push(newNode, g + h, h);
+		mState.AddHeapOperation();
+		mSearchState.SetNode(x, y, newNode);
+	}
+
+private:
+	GridSearchState& mState;
+	OpenList& mOpenList;
+	SearchStateGrid& mSearchState;
+	NodeArena& mNodeArena;
+	const Successors mSuccessors;
+	const Heuristic mHeuristic;
+};
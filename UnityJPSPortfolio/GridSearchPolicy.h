@@ -0,0 +1,116 @@
+// GridSearch에 템플릿 인자로 넣는 정책들 (비용 모델, 휴리스틱, 이웃 후속 노드 생성기)
+// 모두 컴파일 시간에 GridSearch와 묶이므로 안쪽 루프에서 가상 호출이나 런타임 분기 없이 인라인됩니다.
+//
+// 비용 모델 : 8방향 이동 비용 (OctileCost : 직선 5, 대각선 7, 방향 표와 함께 GridDirection.h)
+// 휴리스틱  : Get(x, y)로 목적지까지의 비용 하한을 반환한다 (Octile, Landmark)
+// 후속 노드 : Expand(search, node, endX, endY)에서 search.Relax()로 다음 노드들을 연다 (NeighborSuccessors는 8방향 이웃, JPS는 JumpPointSuccessors.h)
+//             node는 GridSearch가 NodeArena에서 읽어서 넘기는 ExpandedNode (좌표, G, 자신과 부모의 번호)
+
+/************************************** 사용법 **************************************/
+// for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+// {
+//     int x = node.X + GridDirection::X[direction];
+//     int g = node.G + OctileCost::Get(direction);
+// }
+//
+// OctileHeuristic<> heuristic(endX, endY);
+// int h = heuristic.Get(x, y);
+/************************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "BitGrid.h"
+#include "GridDirection.h"
+#include "LandmarkTable.h"
+#include "Node.h"
+
+// 옥타일 거리 (벽이 없을 때의 실제 최소 비용, 기본 휴리스틱)
+template <typename CostModel = OctileCost>
+class OctileHeuristic
+{
+public:
+	OctileHeuristic(int endX, int endY)
+		: mEndX(endX)
+		, mEndY(endY)
+	{
+	}
+
+	inline int Get(int x, int y) const
+	{
+		return CostModel::GetDistance(abs(x - mEndX), abs(y - mEndY));
+	}
+
+private:
+	const int mEndX;
+	const int mEndY;
+};
+
+// 옥타일 거리와 랜드마크 하한(ALT) 중 큰 값
+// 둘 다 일관적인 휴리스틱이므로 큰 값도 일관적이고, 닫힌 노드의 G가 다시 줄어드는 일은 없다
+// 랜드마크 거리표는 유효해야 한다 (LandmarkTable::IsValid())
+template <typename CostModel = OctileCost>
+class LandmarkHeuristic
+{
+public:
+	LandmarkHeuristic(const LandmarkTable& landmarks, int endX, int endY)
+		: mLandmarks(landmarks)
+		, mOctile(endX, endY)
+		, mGoalDistances(landmarks.GetDistances(endX, endY))
+	{
+	}
+
+	inline int Get(int x, int y) const
+	{
+		int octileH = mOctile.Get(x, y);
+		int landmarkH = mLandmarks.GetHeuristic(mGoalDistances, x, y);
+
+		return landmarkH > octileH ? landmarkH : octileH;
+	}
+
+private:
+	const LandmarkTable& mLandmarks;
+	const OctileHeuristic<CostModel> mOctile;
+	const uint16_t* mGoalDistances;		// 목적지의 랜드마크 거리들 (탐색마다 한 번만 찾는다)
+};
+
+// 8방향 이웃을 모두 여는 후속 노드 생성기 (A*)
+class NeighborSuccessors
+{
+public:
+	explicit NeighborSuccessors(const BitGrid& grid)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+	{
+	}
+
+	template <typename Search>
+	inline void Expand(Search& search, const ExpandedNode& node, int, int) const
+	{
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+		{
+			int x = node.X + GridDirection::X[direction];
+			int y = node.Y + GridDirection::Y[direction];
+
+			if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+			{
+				continue;
+			}
+
+			if (mGrid.IsWalkable(x, y) == false)
+			{
+				continue;
+			}
+
+			search.Relax(x, y, node.G + Search::Cost::Get(direction), node.Index);
+		}
+	}
+
+private:
+	const BitGrid& mGrid;
+	const int mWidth;
+	const int mHeight;
+};
@@ -0,0 +1,987 @@
+// 계층적 길찾기 (HPA*)
+// 맵을 clusterSize x clusterSize 칸의 클러스터로 나누고, 이웃 클러스터로 넘어갈 수 있는 경계 칸(입구)들만 노드로 하는 추상 그래프를 미리 만들어 둡니다.
+// 추상 그래프의 간선은 경계를 넘는 한 칸 이동과, 같은 클러스터의 입구끼리 클러스터 밖으로 나가지 않고 이동하는 최단 거리입니다.
+// 탐색할 때는 시작점과 도착점을 잠시 그래프에 붙여 추상 그래프에서 A*를 하고, 지나가는 입구 사이 구간만 JPS로 다시 찾아 이어 붙입니다.
+// 클러스터 단위로 경로를 정하기 때문에 평면 JPS보다 경로가 조금 길어질 수 있습니다.
+// Block(), UnBlock()은 바뀐 칸이 속한 클러스터와 맞닿은 경계만 다시 계산합니다.
+
+/************************************** 사용법 **************************************/
+// PathFindMap map(width, height);
+// map.Block(x, y); // 맵 로딩
+//
+// HPAPathFinder pathFinder(map); // 추상 그래프 생성
+// pathFinder.Block(x, y);        // 이후의 맵 수정은 추상 그래프도 같이 갱신하도록 HPAPathFinder로 한다
+//
+// for (auto it = pathFinder.PathFind(startX, startY, endX, endY); it != pathFinder.End(); ++it)
+// {
+//     ...
+// }
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#include "GridDijkstra.h"
+#include "LineOfSight.h"
+#include "Point.h"
+#include "Path.h"
+#include "PathFindMap.h"
+#include "JPSPathFinder.h"
+
+class HPAPathFinder
+{
+public:
+	// 맵은 이 객체보다 오래 살아 있어야 하고, 만든 뒤의 맵 수정은 이 객체의 Block(), UnBlock()으로 해야 한다
+	explicit HPAPathFinder(PathFindMap& map, int clusterSize = DEFAULT_CLUSTER_SIZE)
+		: mMap(map)
+		, mGrid(map.GetGrid())
+		, mWidth(map.GetWidth())
+		, mHeight(map.GetHeight())
+		, mClusterSize(clusterSize)
+		, mClusterCountX((map.GetWidth() + clusterSize - 1) / clusterSize)
+		, mClusterCountY((map.GetHeight() + clusterSize - 1) / clusterSize)
+		, mDijkstra(clusterSize + 2)
+		, mRefiner(map)
+	{
+		assert(mClusterCountX * mClusterCountY <= MAX_CLUSTER_COUNT);
+
+		mClusters = new Cluster[mClusterCountX * mClusterCountY];
+		mBorders = new std::vector<Transition>[mClusterCountX * mClusterCountY * BORDER_COUNT];
+		mLocalCells = new int[(clusterSize + 2) * (clusterSize + 2)];
+		mLocalDistances = new int[(clusterSize + 2) * (clusterSize + 2)];
+
+		Build();
+	}
+
+	~HPAPathFinder()
+	{
+		delete[] mClusters;
+		delete[] mBorders;
+		delete[] mLocalCells;
+		delete[] mLocalDistances;
+	}
+
+	HPAPathFinder(const HPAPathFinder& other) = delete;
+	HPAPathFinder& operator=(const HPAPathFinder& other) = delete;
+
+	inline const Path& GetPoints() const { return mPoints; }
+	inline bool IsBlocked(int x, int y) const { return mMap.IsBlocked(x, y); }
+
+	// 맵과 추상 그래프를 같이 갱신한다
+	void Block(int x, int y)
+	{
+		if (mMap.IsBlocked(x, y))
+		{
+			return;
+		}
+
+		mMap.Block(x, y);
+		onCellChanged(x, y);
+	}
+
+	void UnBlock(int x, int y)
+	{
+		if (x < 0 || x >= mWidth || y < 0 || y >= mHeight || mMap.IsBlocked(x, y) == false)
+		{
+			return;
+		}
+
+		mMap.UnBlock(x, y);
+		onCellChanged(x, y);
+	}
+
+	// 마지막으로 찾은 경로의 비용 (JPS로 다시 찾은 구간들의 G값 합, 경로가 없었다면 -1)
+	inline int GetPathCost() const { return mPathCost; }
+
+	// 마지막 탐색에서 확장한 노드 수 (추상 그래프 + 구간별 JPS)
+	inline int GetExpandedNodeCount() const { return mExpandedNodeCount; }
+
+	// 추상 그래프의 노드(입구) 수
+	inline int GetAbstractNodeCount() const { return mAbstractNodeCount; }
+
+	// 추상 그래프와 탐색 상태(구간 탐색용 JPS 포함)의 총 크기 (byte), 맵은 포함하지 않는다
+	size_t GetReservedBytes() const
+	{
+		size_t bytes = mRefiner.GetReservedBytes() + static_cast<size_t>(mClusterSize + 2) * (mClusterSize + 2) * (sizeof(bool) + sizeof(int));
+
+		for (int i = 0; i < mClusterCountX * mClusterCountY; ++i)
+		{
+			const Cluster& cluster = mClusters[i];
+
+			bytes += sizeof(Cluster)
+				+ cluster.Nodes.capacity() * sizeof(Point)
+				+ cluster.Distances.capacity() * sizeof(int)
+				+ cluster.LinkBegins.capacity() * sizeof(int)
+				+ cluster.Links.capacity() * sizeof(Link)
+				+ cluster.SearchGenerations.capacity() * sizeof(uint32_t)
+				+ cluster.G.capacity() * sizeof(int)
+				+ cluster.Parents.capacity() * sizeof(uint32_t);
+		}
+
+		for (int i = 0; i < mClusterCountX * mClusterCountY * BORDER_COUNT; ++i)
+		{
+			bytes += sizeof(std::vector<Transition>) + mBorders[i].capacity() * sizeof(Transition);
+		}
+
+		return bytes;
+	}
+
+	inline const Point* Begin() const { return mPoints.Begin(); }
+	inline const Point* End() const { return mPoints.End(); }
+
+	// 추상 그래프 전체를 다시 만든다
+	void Build()
+	{
+		for (int cy = 0; cy < mClusterCountY; ++cy)
+		{
+			for (int cx = 0; cx < mClusterCountX; ++cx)
+			{
+				for (int direction = 0; direction < BORDER_COUNT; ++direction)
+				{
+					buildBorder(cx, cy, direction);
+				}
+			}
+		}
+
+		for (int cy = 0; cy < mClusterCountY; ++cy)
+		{
+			for (int cx = 0; cx < mClusterCountX; ++cx)
+			{
+				rebuildCluster(cx, cy);
+			}
+		}
+
+		for (int cy = 0; cy < mClusterCountY; ++cy)
+		{
+			for (int cx = 0; cx < mClusterCountX; ++cx)
+			{
+				resolveLinks(cx, cy);
+			}
+		}
+	}
+
+	const Point* PathFind(int startX, int startY, int endX, int endY)
+	{
+		//PROFILE(L"HPA");
+
+		Clear();
+
+		if (IsBlocked(startX, startY) || IsBlocked(endX, endY))
+		{
+			return End();
+		}
+
+		const ConnectedComponents* components = mMap.GetComponents();
+
+		if (components != nullptr && components->IsInSameComponent(startX, startY, endX, endY) == false)
+		{
+			return End();
+		}
+
+		// 가까운 거리는 추상 그래프를 거치는 비용이 더 크므로 바로 JPS로 찾는다
+		if (std::max(abs(startX - endX), abs(startY - endY)) <= mClusterSize * FLAT_SEARCH_CLUSTER_COUNT)
+		{
+			return findFlatPath(startX, startY, endX, endY);
+		}
+
+		if (searchAbstractPath(startX, startY, endX, endY) == false)
+		{
+			return End();
+		}
+
+		if (refineAbstractPath() == false)
+		{
+			Clear();
+			return End();
+		}
+
+		reduceWaypoints();
+
+		return Begin();
+	}
+
+	void Clear()
+	{
+		mPoints.Clear();
+		mPathCost = -1;
+		mExpandedNodeCount = 0;
+		mAbstractPath.clear();
+		mWaypoints.clear();
+	}
+
+private:
+	// 경계를 넘는 한 칸 이동 (A는 경계를 가진 클러스터 쪽 칸, B는 이웃 클러스터 쪽 칸)
+	struct Transition
+	{
+		Point A;
+		Point B;
+		int Cost;
+	};
+
+	// 다른 클러스터의 입구로 넘어가는 간선
+	struct Link
+	{
+		uint32_t Target;	// makeNodeID(클러스터, 입구 번호)
+		int Cost;
+	};
+
+	struct Cluster
+	{
+		std::vector<Point> Nodes;		// 입구 칸들 (Y, X 순으로 정렬)
+		std::vector<int> Distances;		// Nodes.size() x Nodes.size(), 클러스터 안에서 갈 수 없다면 -1
+		std::vector<int> LinkBegins;	// 입구 i의 간선은 Links[LinkBegins[i]] ~ Links[LinkBegins[i + 1] - 1]
+		std::vector<Link> Links;
+
+		// 추상 그래프 탐색 상태 (SearchGenerations[i]가 현재 세대가 아니면 방문하지 않은 입구)
+		std::vector<uint32_t> SearchGenerations;
+		std::vector<int> G;
+		std::vector<uint32_t> Parents;
+	};
+
+	struct OpenEntry
+	{
+		int F;
+		int G;
+		uint32_t ID;
+	};
+
+	// F가 작은 것 먼저, F가 같다면 G가 큰 것 (도착점에 가까운 것) 먼저
+	struct OpenEntryCompare
+	{
+		inline bool operator()(const OpenEntry& a, const OpenEntry& b) const
+		{
+			if (a.F == b.F)
+			{
+				return a.G < b.G;
+			}
+
+			return a.F > b.F;
+		}
+	};
+
+	// 클러스터의 오른쪽, 아래쪽, 오른쪽 아래, 왼쪽 아래 경계 (위쪽, 왼쪽 경계는 이웃 클러스터가 가진다)
+	enum EBorder
+	{
+		BORDER_RIGHT,
+		BORDER_DOWN,
+		BORDER_DOWN_RIGHT,
+		BORDER_DOWN_LEFT,
+		BORDER_COUNT,
+	};
+
+	enum
+	{
+		DEFAULT_CLUSTER_SIZE = 32,
+		MAX_CLUSTER_COUNT = 0xFFFF,
+		MAX_NODE_COUNT_PER_CLUSTER = 0xFFFF,
+		STRAIGHT_COST = 5,
+		DIAGONAL_COST = 7,
+		WIDE_ENTRANCE_LENGTH = 6,	// 이 길이 이상으로 이어진 입구는 양 끝에 노드를 둔다
+		FLAT_SEARCH_CLUSTER_COUNT = 2,	// 시작점과 도착점이 클러스터 이 개수만큼의 거리 안이라면 추상 그래프 없이 찾는다
+	};
+
+	static constexpr uint32_t START_ID = 0xFFFFFFFE;
+	static constexpr uint32_t GOAL_ID = 0xFFFFFFFF;
+
+	inline static uint32_t makeNodeID(int clusterIndex, int nodeIndex)
+	{
+		return static_cast<uint32_t>(clusterIndex) << 16 | static_cast<uint32_t>(nodeIndex);
+	}
+
+	inline static int getClusterIndex(uint32_t id) { return static_cast<int>(id >> 16); }
+	inline static int getNodeIndex(uint32_t id) { return static_cast<int>(id & 0xFFFF); }
+
+	inline int getClusterIndex(int cx, int cy) const { return cy * mClusterCountX + cx; }
+	inline bool isValidCluster(int cx, int cy) const { return cx >= 0 && cx < mClusterCountX && cy >= 0 && cy < mClusterCountY; }
+
+	inline bool isWalkable(const Point& point) const { return mGrid.IsWalkable(point.X, point.Y); }
+
+	inline static bool isLess(const Point& a, const Point& b)
+	{
+		return a.Y < b.Y || (a.Y == b.Y && a.X < b.X);
+	}
+
+	inline static bool isSame(const Point& a, const Point& b)
+	{
+		return a.X == b.X && a.Y == b.Y;
+	}
+
+	// 옥타일 거리 (Node의 H와 같은 값)
+	inline static int getHeuristic(int x, int y, int endX, int endY)
+	{
+		int xGap = abs(x - endX);
+		int yGap = abs(y - endY);
+		int minGap = xGap < yGap ? xGap : yGap;
+		int maxGap = xGap > yGap ? xGap : yGap;
+		return minGap * DIAGONAL_COST + (maxGap - minGap) * STRAIGHT_COST;
+	}
+
+	// 정렬된 입구 목록에서 칸의 번호를 찾는다 (없다면 -1)
+	inline static int findNode(const Cluster& cluster, const Point& point)
+	{
+		auto found = std::lower_bound(cluster.Nodes.begin(), cluster.Nodes.end(), point, isLess);
+
+		if (found == cluster.Nodes.end() || isSame(*found, point) == false)
+		{
+			return -1;
+		}
+
+		return static_cast<int>(found - cluster.Nodes.begin());
+	}
+
+	/************************************** 추상 그래프 생성 **************************************/
+
+	// (cx, cy) 클러스터가 가진 경계 하나의 입구들을 다시 찾는다
+	void buildBorder(int cx, int cy, int direction)
+	{
+		if (isValidCluster(cx, cy) == false)
+		{
+			return;
+		}
+
+		std::vector<Transition>& border = mBorders[getClusterIndex(cx, cy) * BORDER_COUNT + direction];
+		border.clear();
+
+		const int left = cx * mClusterSize;
+		const int top = cy * mClusterSize;
+		const int right = left + mClusterSize;
+		const int bottom = top + mClusterSize;
+
+		switch (direction)
+		{
+		case BORDER_RIGHT:
+			if (isValidCluster(cx + 1, cy))
+			{
+				buildSideBorder(border, right - 1, top, right, top, 0, 1, std::min(mClusterSize, mHeight - top));
+			}
+			break;
+		case BORDER_DOWN:
+			if (isValidCluster(cx, cy + 1))
+			{
+				buildSideBorder(border, left, bottom - 1, left, bottom, 1, 0, std::min(mClusterSize, mWidth - left));
+			}
+			break;
+		case BORDER_DOWN_RIGHT:
+			if (isValidCluster(cx + 1, cy + 1))
+			{
+				addCornerTransition(border, Point{ right - 1, bottom - 1 }, Point{ right, bottom });
+			}
+			break;
+		case BORDER_DOWN_LEFT:
+			if (isValidCluster(cx - 1, cy + 1))
+			{
+				addCornerTransition(border, Point{ left, bottom - 1 }, Point{ left - 1, bottom });
+			}
+			break;
+		default:
+			assert(false);
+		}
+	}
+
+	// 변 하나를 사이에 둔 두 줄 (A쪽 i번째 칸 : (aX, aY) + i * (stepX, stepY), B쪽도 같음)
+	void buildSideBorder(std::vector<Transition>& border, int aX, int aY, int bX, int bY, int stepX, int stepY, int length)
+	{
+		auto pointA = [=](int i) { return Point{ aX + stepX * i, aY + stepY * i }; };
+		auto pointB = [=](int i) { return Point{ bX + stepX * i, bY + stepY * i }; };
+
+		// 양쪽 칸이 모두 이동 가능한 구간마다 입구를 만든다
+		// 구간 안의 칸들은 경계를 따라 서로 이어져 있으므로 구간마다 한두 개의 노드면 충분하다
+		mRunIDs.assign(length, -1);
+		int runID = 0;
+
+		for (int i = 0; i < length;)
+		{
+			if (isWalkable(pointA(i)) == false || isWalkable(pointB(i)) == false)
+			{
+				++i;
+				continue;
+			}
+
+			int begin = i;
+
+			while (i < length && isWalkable(pointA(i)) && isWalkable(pointB(i)))
+			{
+				mRunIDs[i] = runID;
+				++i;
+			}
+
+			int end = i - 1;
+
+			if (end - begin + 1 < WIDE_ENTRANCE_LENGTH)
+			{
+				int middle = begin + (end - begin) / 2;
+				border.push_back(Transition{ pointA(middle), pointB(middle), STRAIGHT_COST });
+			}
+			else
+			{
+				border.push_back(Transition{ pointA(begin), pointB(begin), STRAIGHT_COST });
+				border.push_back(Transition{ pointA(end), pointB(end), STRAIGHT_COST });
+			}
+
+			runID++;
+		}
+
+		// 대각선으로만 넘어갈 수 있는 곳 (모서리를 끼고 도는 대각선 이동이 허용되므로 실제로 지나갈 수 있다)
+		// 양쪽 칸이 각자 자기 쪽에서 같은 구간과 이어져 있다면 그 구간의 입구로 대신할 수 있다
+		for (int i = 0; i < length; ++i)
+		{
+			if (isWalkable(pointA(i)) == false)
+			{
+				continue;
+			}
+
+			for (int j = i - 1; j <= i + 1; j += 2)
+			{
+				if (j < 0 || j >= length || isWalkable(pointB(j)) == false)
+				{
+					continue;
+				}
+
+				if (isConnectedByRun(i, j, length))
+				{
+					continue;
+				}
+
+				border.push_back(Transition{ pointA(i), pointB(j), DIAGONAL_COST });
+			}
+		}
+	}
+
+	// A쪽 i번째 칸과 B쪽 j번째 칸이 경계를 따라 같은 구간에 이어져 있는가
+	// (같은 줄의 바로 옆 칸끼리는 서로 이웃이고, 구간에 속한 칸은 양쪽 모두 이동 가능하다)
+	bool isConnectedByRun(int i, int j, int length) const
+	{
+		for (int a = i - 1; a <= i + 1; ++a)
+		{
+			if (a < 0 || a >= length || mRunIDs[a] == -1)
+			{
+				continue;
+			}
+
+			for (int b = j - 1; b <= j + 1; ++b)
+			{
+				if (b >= 0 && b < length && mRunIDs[b] == mRunIDs[a])
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	// 네 클러스터가 만나는 꼭짓점을 대각선으로 넘어가는 이동
+	void addCornerTransition(std::vector<Transition>& border, const Point& a, const Point& b)
+	{
+		if (isWalkable(a) && isWalkable(b))
+		{
+			border.push_back(Transition{ a, b, DIAGONAL_COST });
+		}
+	}
+
+	// (cx, cy) 클러스터와 맞닿은 8개 경계의 이동들을 (자신 쪽 칸, 이웃 클러스터, 이웃 쪽 칸, 비용)으로 넘겨준다
+	template <typename Function>
+	void forEachTransition(int cx, int cy, Function function) const
+	{
+		const int OWN_X[BORDER_COUNT] = { 1, 0, 1, -1 };
+		const int OWN_Y[BORDER_COUNT] = { 0, 1, 1, 1 };
+
+		for (int direction = 0; direction < BORDER_COUNT; ++direction)
+		{
+			// 자신이 가진 경계
+			int nx = cx + OWN_X[direction];
+			int ny = cy + OWN_Y[direction];
+
+			if (isValidCluster(nx, ny))
+			{
+				for (const Transition& transition : mBorders[getClusterIndex(cx, cy) * BORDER_COUNT + direction])
+				{
+					function(transition.A, getClusterIndex(nx, ny), transition.B, transition.Cost);
+				}
+			}
+
+			// 이웃이 가진 경계 (반대 방향의 이웃)
+			nx = cx - OWN_X[direction];
+			ny = cy - OWN_Y[direction];
+
+			if (isValidCluster(nx, ny))
+			{
+				for (const Transition& transition : mBorders[getClusterIndex(nx, ny) * BORDER_COUNT + direction])
+				{
+					function(transition.B, getClusterIndex(nx, ny), transition.A, transition.Cost);
+				}
+			}
+		}
+	}
+
+	// 클러스터의 입구 목록과 입구 사이 거리를 다시 계산한다
+	void rebuildCluster(int cx, int cy)
+	{
+		Cluster& cluster = mClusters[getClusterIndex(cx, cy)];
+
+		mAbstractNodeCount -= static_cast<int>(cluster.Nodes.size());
+
+		cluster.Nodes.clear();
+
+		forEachTransition(cx, cy, [&cluster](const Point& own, int, const Point&, int)
+			{
+				cluster.Nodes.push_back(own);
+			});
+
+		std::sort(cluster.Nodes.begin(), cluster.Nodes.end(), isLess);
+		cluster.Nodes.erase(std::unique(cluster.Nodes.begin(), cluster.Nodes.end(), isSame), cluster.Nodes.end());
+
+		const int nodeCount = static_cast<int>(cluster.Nodes.size());
+		assert(nodeCount <= MAX_NODE_COUNT_PER_CLUSTER);
+
+		mAbstractNodeCount += nodeCount;
+
+		cluster.Distances.assign(nodeCount * nodeCount, -1);
+
+		loadLocalGrid(cx, cy);
+
+		for (int from = 0; from < nodeCount; ++from)
+		{
+			computeLocalDistances(cluster.Nodes[from]);
+
+			for (int to = 0; to < nodeCount; ++to)
+			{
+				cluster.Distances[from * nodeCount + to] = getLocalDistance(cluster.Nodes[to]);
+			}
+		}
+
+		cluster.SearchGenerations.assign(nodeCount, 0);
+		cluster.G.assign(nodeCount, -1);
+		cluster.Parents.assign(nodeCount, START_ID);
+	}
+
+	// 이웃 클러스터의 입구 번호로 간선을 다시 연결한다 (이웃의 입구 목록이 바뀔 때마다 호출해야 한다)
+	void resolveLinks(int cx, int cy)
+	{
+		if (isValidCluster(cx, cy) == false)
+		{
+			return;
+		}
+
+		Cluster& cluster = mClusters[getClusterIndex(cx, cy)];
+		const int nodeCount = static_cast<int>(cluster.Nodes.size());
+
+		mLinkBuffer.clear();
+
+		forEachTransition(cx, cy, [this, &cluster](const Point& own, int neighborIndex, const Point& neighbor, int cost)
+			{
+				int ownNode = findNode(cluster, own);
+				int neighborNode = findNode(mClusters[neighborIndex], neighbor);
+				assert(ownNode != -1 && neighborNode != -1);
+
+				mLinkBuffer.push_back(std::make_pair(ownNode, Link{ makeNodeID(neighborIndex, neighborNode), cost }));
+			});
+
+		std::sort(mLinkBuffer.begin(), mLinkBuffer.end(),
+			[](const std::pair<int, Link>& a, const std::pair<int, Link>& b) { return a.first < b.first; });
+
+		cluster.LinkBegins.assign(nodeCount + 1, 0);
+		cluster.Links.clear();
+
+		for (const std::pair<int, Link>& link : mLinkBuffer)
+		{
+			cluster.LinkBegins[link.first + 1]++;
+			cluster.Links.push_back(link.second);
+		}
+
+		for (int i = 0; i < nodeCount; ++i)
+		{
+			cluster.LinkBegins[i + 1] += cluster.LinkBegins[i];
+		}
+	}
+
+	// 칸 하나가 바뀌었을 때 영향을 받는 클러스터만 다시 계산한다
+	void onCellChanged(int x, int y)
+	{
+		const int cx = x / mClusterSize;
+		const int cy = y / mClusterSize;
+		const int offsetX = x % mClusterSize;
+		const int offsetY = y % mClusterSize;
+
+		// 클러스터 안쪽 칸이라면 입구는 그대로이고 입구 사이 거리만 바뀐다
+		if (offsetX != 0 && offsetX != mClusterSize - 1 && offsetY != 0 && offsetY != mClusterSize - 1)
+		{
+			rebuildCluster(cx, cy);
+			return;
+		}
+
+		// 바뀐 칸이 속한 클러스터와 맞닿은 경계 8개
+		for (int direction = 0; direction < BORDER_COUNT; ++direction)
+		{
+			buildBorder(cx, cy, direction);
+		}
+
+		buildBorder(cx - 1, cy, BORDER_RIGHT);
+		buildBorder(cx, cy - 1, BORDER_DOWN);
+		buildBorder(cx - 1, cy - 1, BORDER_DOWN_RIGHT);
+		buildBorder(cx + 1, cy - 1, BORDER_DOWN_LEFT);
+
+		// 입구 목록이 바뀔 수 있는 클러스터 (자신과 8방향 이웃)
+		for (int ny = cy - 1; ny <= cy + 1; ++ny)
+		{
+			for (int nx = cx - 1; nx <= cx + 1; ++nx)
+			{
+				if (isValidCluster(nx, ny))
+				{
+					rebuildCluster(nx, ny);
+				}
+			}
+		}
+
+		// 입구 번호가 바뀌었을 수 있는 클러스터들을 가리키는 간선 (한 칸 더 바깥까지)
+		for (int ny = cy - 2; ny <= cy + 2; ++ny)
+		{
+			for (int nx = cx - 2; nx <= cx + 2; ++nx)
+			{
+				resolveLinks(nx, ny);
+			}
+		}
+	}
+
+	/************************************** 클러스터 안 거리 **************************************/
+
+	// 클러스터의 이동 가능 여부를 작업 공간에 옮겨 둔다 (막힌 칸은 BLOCKED, 나머지는 NOT_VISITED인 GridDijkstra의 거리 배열)
+	// 사방에 한 칸씩 벽을 둘러 두어서 거리 계산 중에는 범위 검사가 필요 없다
+	void loadLocalGrid(int cx, int cy)
+	{
+		const int stride = mClusterSize + 2;
+		const int width = std::min(mClusterSize, mWidth - cx * mClusterSize);
+		const int height = std::min(mClusterSize, mHeight - cy * mClusterSize);
+
+		mLocalLeft = cx * mClusterSize;
+		mLocalTop = cy * mClusterSize;
+
+		std::fill(mLocalCells, mLocalCells + stride * stride, static_cast<int>(GridDijkstra::BLOCKED));
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				if (mGrid.IsWalkable(mLocalLeft + x, mLocalTop + y))
+				{
+					mLocalCells[(y + 1) * stride + (x + 1)] = GridDijkstra::NOT_VISITED;
+				}
+			}
+		}
+	}
+
+	// 클러스터 밖으로 나가지 않고 source에서 클러스터의 모든 칸까지 가는 최단 거리 (갈 수 없다면 -1)
+	// loadLocalGrid()로 옮겨 둔 클러스터 기준이고, 간선 비용이 5, 7 뿐이므로 다이얼 알고리즘을 쓴다 (GridDijkstra)
+	void computeLocalDistances(const Point& source)
+	{
+		const int stride = mClusterSize + 2;
+
+		std::copy(mLocalCells, mLocalCells + stride * stride, mLocalDistances);
+
+		mDijkstra.Push(mLocalDistances, getLocalCell(source), 0);
+		mDijkstra.Run(mLocalDistances);
+	}
+
+	inline int getLocalCell(const Point& point) const
+	{
+		return (point.Y - mLocalTop + 1) * (mClusterSize + 2) + (point.X - mLocalLeft + 1);
+	}
+
+	inline int getLocalDistance(const Point& point) const
+	{
+		return mLocalDistances[getLocalCell(point)];
+	}
+
+	/************************************** 탐색 **************************************/
+
+	const Point* findFlatPath(int startX, int startY, int endX, int endY)
+	{
+		if (mRefiner.PathFind(startX, startY, endX, endY) == mRefiner.End())
+		{
+			return End();
+		}
+
+		mPathCost = mRefiner.GetPathCost();
+		mExpandedNodeCount = mRefiner.GetExpandedNodeCount();
+		mPoints = mRefiner.GetPoints();
+
+		return Begin();
+	}
+
+	// 시작점, 도착점을 붙인 추상 그래프에서 A*를 하고, 지나가는 칸들을 mAbstractPath에 담는다
+	bool searchAbstractPath(int startX, int startY, int endX, int endY)
+	{
+		const int startClusterX = startX / mClusterSize;
+		const int startClusterY = startY / mClusterSize;
+		const int endClusterX = endX / mClusterSize;
+		const int endClusterY = endY / mClusterSize;
+		const int startClusterIndex = getClusterIndex(startClusterX, startClusterY);
+		const int endClusterIndex = getClusterIndex(endClusterX, endClusterY);
+		const Cluster& startCluster = mClusters[startClusterIndex];
+		const Cluster& endCluster = mClusters[endClusterIndex];
+
+		mSearchGeneration++;
+		mOpenList.clear();
+		mGoalG = -1;
+		mGoalParent = START_ID;
+
+		// 시작점 -> 시작 클러스터의 입구들 (같은 클러스터라면 도착점까지 바로 가는 경로도)
+		loadLocalGrid(startClusterX, startClusterY);
+		computeLocalDistances(Point{ startX, startY });
+
+		for (int i = 0; i < (int)startCluster.Nodes.size(); ++i)
+		{
+			int distance = getLocalDistance(startCluster.Nodes[i]);
+
+			if (distance != -1)
+			{
+				relax(makeNodeID(startClusterIndex, i), distance, START_ID, endX, endY);
+			}
+		}
+
+		if (startClusterIndex == endClusterIndex)
+		{
+			int distance = getLocalDistance(Point{ endX, endY });
+
+			if (distance != -1)
+			{
+				relaxGoal(distance, START_ID);
+			}
+		}
+
+		// 도착 클러스터의 입구들 -> 도착점
+		loadLocalGrid(endClusterX, endClusterY);
+		computeLocalDistances(Point{ endX, endY });
+
+		mGoalDistances.resize(endCluster.Nodes.size());
+
+		for (int i = 0; i < (int)endCluster.Nodes.size(); ++i)
+		{
+			mGoalDistances[i] = getLocalDistance(endCluster.Nodes[i]);
+		}
+
+		while (mOpenList.empty() == false)
+		{
+			std::pop_heap(mOpenList.begin(), mOpenList.end(), OpenEntryCompare());
+			OpenEntry current = mOpenList.back();
+			mOpenList.pop_back();
+
+			// Find
+			if (current.ID == GOAL_ID)
+			{
+				buildAbstractPath(startX, startY, endX, endY);
+				return true;
+			}
+
+			const int clusterIndex = getClusterIndex(current.ID);
+			const int nodeIndex = getNodeIndex(current.ID);
+			const Cluster& cluster = mClusters[clusterIndex];
+
+			// 더 짧은 G로 이미 꺼낸 입구
+			if (current.G != cluster.G[nodeIndex])
+			{
+				continue;
+			}
+
+			mExpandedNodeCount++;
+
+			if (clusterIndex == endClusterIndex && mGoalDistances[nodeIndex] != -1)
+			{
+				relaxGoal(current.G + mGoalDistances[nodeIndex], current.ID);
+			}
+
+			// 같은 클러스터의 다른 입구
+			const int nodeCount = static_cast<int>(cluster.Nodes.size());
+			const int* distances = cluster.Distances.data() + nodeIndex * nodeCount;
+
+			for (int i = 0; i < nodeCount; ++i)
+			{
+				if (i != nodeIndex && distances[i] != -1)
+				{
+					relax(makeNodeID(clusterIndex, i), current.G + distances[i], current.ID, endX, endY);
+				}
+			}
+
+			// 경계 너머의 입구
+			for (int i = cluster.LinkBegins[nodeIndex]; i < cluster.LinkBegins[nodeIndex + 1]; ++i)
+			{
+				const Link& link = cluster.Links[i];
+				relax(link.Target, current.G + link.Cost, current.ID, endX, endY);
+			}
+		}
+
+		return false;
+	}
+
+	void relax(uint32_t id, int g, uint32_t parent, int endX, int endY)
+	{
+		Cluster& cluster = mClusters[getClusterIndex(id)];
+		const int nodeIndex = getNodeIndex(id);
+
+		if (cluster.SearchGenerations[nodeIndex] == mSearchGeneration && cluster.G[nodeIndex] <= g)
+		{
+			return;
+		}
+
+		cluster.SearchGenerations[nodeIndex] = mSearchGeneration;
+		cluster.G[nodeIndex] = g;
+		cluster.Parents[nodeIndex] = parent;
+
+		const Point& point = cluster.Nodes[nodeIndex];
+		mOpenList.push_back(OpenEntry{ g + getHeuristic(point.X, point.Y, endX, endY), g, id });
+		std::push_heap(mOpenList.begin(), mOpenList.end(), OpenEntryCompare());
+	}
+
+	void relaxGoal(int g, uint32_t parent)
+	{
+		if (mGoalG != -1 && mGoalG <= g)
+		{
+			return;
+		}
+
+		mGoalG = g;
+		mGoalParent = parent;
+
+		mOpenList.push_back(OpenEntry{ g, g, GOAL_ID });
+		std::push_heap(mOpenList.begin(), mOpenList.end(), OpenEntryCompare());
+	}
+
+	void buildAbstractPath(int startX, int startY, int endX, int endY)
+	{
+		mAbstractPath.push_back(Point{ endX, endY });
+
+		for (uint32_t visit = mGoalParent; visit != START_ID;)
+		{
+			const Cluster& cluster = mClusters[getClusterIndex(visit)];
+			const int nodeIndex = getNodeIndex(visit);
+
+			mAbstractPath.push_back(cluster.Nodes[nodeIndex]);
+			visit = cluster.Parents[nodeIndex];
+		}
+
+		mAbstractPath.push_back(Point{ startX, startY });
+
+		std::reverse(mAbstractPath.begin(), mAbstractPath.end());
+	}
+
+	// 추상 경로의 구간들을 JPS로 다시 찾아 mWaypoints에 이어 붙인다
+	bool refineAbstractPath()
+	{
+		mPathCost = 0;
+		mWaypoints.push_back(mAbstractPath.front());
+
+		for (size_t i = 1; i < mAbstractPath.size(); ++i)
+		{
+			const Point& from = mAbstractPath[i - 1];
+			const Point& to = mAbstractPath[i];
+
+			if (isSame(from, to))
+			{
+				continue;
+			}
+
+			int xGap = abs(from.X - to.X);
+			int yGap = abs(from.Y - to.Y);
+
+			// 경계를 넘는 한 칸 이동
+			if (xGap <= 1 && yGap <= 1)
+			{
+				mPathCost += (xGap == 1 && yGap == 1) ? DIAGONAL_COST : STRAIGHT_COST;
+				mWaypoints.push_back(to);
+				continue;
+			}
+
+			if (mRefiner.PathFind(from.X, from.Y, to.X, to.Y) == mRefiner.End())
+			{
+				return false;
+			}
+
+			mPathCost += mRefiner.GetPathCost();
+			mExpandedNodeCount += mRefiner.GetExpandedNodeCount();
+
+			auto it = mRefiner.Begin();
+
+			for (++it; it != mRefiner.End(); ++it)
+			{
+				mWaypoints.push_back(*it);
+			}
+		}
+
+		return true;
+	}
+
+	// 구간을 이어 붙인 자리에 남는 불필요한 중간 점들을 뺀다 (GridSearchState::ReduceNodes()와 같은 방식)
+	void reduceWaypoints()
+	{
+		// anchor : 마지막으로 남긴 점
+		int anchor = static_cast<int>(mWaypoints.size()) - 1;
+
+		mPoints.PushBack(mWaypoints[anchor]);
+
+		for (int i = anchor - 1; i >= 0; --i)
+		{
+			if (i > 0 && canIgnore(mWaypoints[anchor], mWaypoints[i - 1]))
+			{
+				continue;
+			}
+
+			mPoints.PushBack(mWaypoints[i]);
+			anchor = i;
+		}
+
+		// 도착점부터 담았으므로 뒤집는다
+		for (int left = 0, right = mPoints.Size() - 1; left < right; ++left, --right)
+		{
+			std::swap(mPoints[left], mPoints[right]);
+		}
+	}
+
+	// start ~ end 사이에 벽에 걸리는 것이 없는가
+	bool canIgnore(const Point& start, const Point& end) const
+	{
+		return LineOfSight::IsClear(mGrid, start.X, start.Y, end.X, end.Y);
+	}
+
+private:
+	Path mPoints;
+	int mPathCost = -1;
+	int mExpandedNodeCount = 0;
+
+	PathFindMap& mMap;
+	const BitGrid& mGrid;
+	const int mWidth;
+	const int mHeight;
+
+	// 추상 그래프
+	const int mClusterSize;
+	const int mClusterCountX;
+	const int mClusterCountY;
+	Cluster* mClusters;
+	std::vector<Transition>* mBorders;	// 클러스터 마다 BORDER_COUNT 개
+	int mAbstractNodeCount = 0;
+
+	// 추상 그래프 탐색 상태
+	uint32_t mSearchGeneration = 0;
+	std::vector<OpenEntry> mOpenList;
+	std::vector<int> mGoalDistances;
+	int mGoalG = -1;
+	uint32_t mGoalParent = START_ID;
+	std::vector<Point> mAbstractPath;
+	std::vector<Point> mWaypoints;
+
+	// 그래프 생성, 클러스터 안 거리 계산용 작업 공간
+	int mLocalLeft = 0;			// loadLocalGrid()로 옮겨 둔 클러스터의 왼쪽 위 칸
+	int mLocalTop = 0;
+	int* mLocalCells;			// (clusterSize + 2) x (clusterSize + 2), 막힌 칸은 BLOCKED
+	int* mLocalDistances;
+	GridDijkstra mDijkstra;
+	std::vector<int> mRunIDs;
+	std::vector<std::pair<int, Link>> mLinkBuffer;
+
+	// 입구 사이 구간을 다시 찾는 용도
+	JPSPathFinder mRefiner;
+};
@@ -0,0 +1,273 @@
+// 길찾기 OPEN LIST 용 d-ary 힙
+// 힙에는 노드 대신 (F, H, 노드 번호) 키를 담으므로, 비교할 때 노드의 메모리(NodeArena)를 건드리지 않습니다.
+// 노드 번호 마다 힙 안에서의 위치를 기록해두기 때문에 노드가 OPEN LIST에 있는지 O(1)에 알 수 있고,
+// F가 줄어든 노드는 DecreaseKey()로 O(log n)에 힙을 복구합니다.
+// ARITY = 4 로 사용하면 자식 키 4개(48 byte)가 연속된 메모리에 모여 있어 캐시 효율이 좋아집니다.
+// 키 배열과 위치 배열은 부족할 때 두 배로 늘리고, 늘린 배열은 Clear() 후에도 재사용합니다.
+
+/************************************** 사용법 **************************************/
+// IndexedPriorityQueue<4> openList;
+//
+// openList.Push(node, g + h, h);
+//
+// if (openList.Contains(node))
+// {
+//     nodeArena.SetG(node, newG);
+//     openList.DecreaseKey(node, newG + nodeArena.GetH(node));
+// }
+//
+// NodeIndex top = openList.Top();
+// openList.Pop();
+/************************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+
+#include "Node.h"
+
+// OPEN LIST의 원소 (F가 작은 키가, F가 같다면 H가 작은 키가 먼저 나온다)
+struct OpenListKey
+{
+	int F;
+	int H;
+	NodeIndex Node;
+};
+
+template <int ARITY>
+class IndexedPriorityQueue
+{
+	static_assert(ARITY >= 2, "ARITY must be at least 2");
+
+public:
+	IndexedPriorityQueue(int initialCapacity = DEFAULT_INITIAL_CAPACITY)
+		: mSize(0)
+		, mCapacity(initialCapacity)
+		, mPositionCapacity(initialCapacity)
+	{
+		mKeys = new OpenListKey[mCapacity];
+		mPositions = new int[mPositionCapacity];
+		memset(mPositions, -1, sizeof(int) * mPositionCapacity);
+	}
+
+	~IndexedPriorityQueue()
+	{
+		delete[] mKeys;
+		delete[] mPositions;
+	}
+
+	IndexedPriorityQueue(const IndexedPriorityQueue& other) = delete;
+	IndexedPriorityQueue& operator=(const IndexedPriorityQueue& other) = delete;
+
+	void Push(NodeIndex node, int f, int h)
+	{
+		assert(node >= 0);
+
+		if (mSize == mCapacity)
+		{
+			mKeys = grow(mKeys, mCapacity, mCapacity * 2, mSize);
+			mCapacity *= 2;
+		}
+
+		if (node >= mPositionCapacity)
+		{
+			int positionCapacity = mPositionCapacity * 2;
+
+			while (node >= positionCapacity)
+			{
+				positionCapacity *= 2;
+			}
+
+			mPositions = grow(mPositions, mPositionCapacity, positionCapacity, mPositionCapacity);
+			memset(mPositions + mPositionCapacity, -1, sizeof(int) * (positionCapacity - mPositionCapacity));
+			mPositionCapacity = positionCapacity;
+		}
+
+		place(mSize, OpenListKey{ f, h, node });
+		mSize++;
+
+		siftUp(mSize - 1);
+	}
+
+	// 노드가 OPEN LIST에 있는가
+	// 기록된 위치는 이전 탐색의 값일 수도 있으므로, 그 위치의 키가 실제로 이 노드인지 확인한다
+	inline bool Contains(NodeIndex node) const
+	{
+		if (node < 0 || node >= mPositionCapacity)
+		{
+			return false;
+		}
+
+		int position = mPositions[node];
+
+		return position >= 0 && position < mSize && mKeys[position].Node == node;
+	}
+
+	// 노드의 F값이 f로 줄어들었을 때 호출하여 힙을 복구한다
+	void DecreaseKey(NodeIndex node, int f)
+	{
+		assert(Contains(node));
+
+		int position = mPositions[node];
+		assert(f <= mKeys[position].F);
+
+		mKeys[position].F = f;
+		siftUp(position);
+	}
+
+	// 우선순위가 가장 높은 노드를 제거한다
+	void Pop()
+	{
+		assert(mSize > 0);
+
+		mPositions[mKeys[0].Node] = -1;
+
+		mSize--;
+
+		if (mSize == 0)
+		{
+			return;
+		}
+
+		place(0, mKeys[mSize]);
+		siftDown(0);
+	}
+
+	inline NodeIndex Top() const
+	{
+		assert(mSize > 0);
+		return mKeys[0].Node;
+	}
+
+	inline int Size() const
+	{
+		return mSize;
+	}
+
+	inline bool Empty() const
+	{
+		return mSize == 0;
+	}
+
+	// 노드의 메모리는 관리하지 않는다 (노드를 할당한 쪽에서 반환)
+	inline void Clear()
+	{
+		mSize = 0;
+	}
+
+	// 키 배열과 위치 배열의 총 크기 (byte)
+	inline size_t GetReservedBytes() const
+	{
+		return static_cast<size_t>(mCapacity) * sizeof(OpenListKey) + static_cast<size_t>(mPositionCapacity) * sizeof(int);
+	}
+
+private:
+	// a가 b보다 먼저 나와야 하는가
+	inline static bool isHigher(const OpenListKey& a, const OpenListKey& b)
+	{
+		if (a.F == b.F)
+		{
+			return a.H < b.H;
+		}
+
+		return a.F < b.F;
+	}
+
+	// index 위치에 키를 놓고 노드의 위치 정보를 갱신한다
+	inline void place(int index, const OpenListKey& key)
+	{
+		mKeys[index] = key;
+		mPositions[key.Node] = index;
+	}
+
+	void siftUp(int index)
+	{
+		const OpenListKey key = mKeys[index];
+
+		while (index > 0)
+		{
+			int parentIndex = (index - 1) / ARITY;
+
+			if (isHigher(key, mKeys[parentIndex]) == false)
+			{
+				break;
+			}
+
+			place(index, mKeys[parentIndex]);
+			index = parentIndex;
+		}
+
+		place(index, key);
+	}
+
+	void siftDown(int index)
+	{
+		const OpenListKey key = mKeys[index];
+
+		while (true)
+		{
+			int firstChildIndex = index * ARITY + 1;
+
+			if (firstChildIndex >= mSize)
+			{
+				break;
+			}
+
+			int lastChildIndex = firstChildIndex + ARITY - 1;
+
+			if (lastChildIndex >= mSize)
+			{
+				lastChildIndex = mSize - 1;
+			}
+
+			int bestChildIndex = firstChildIndex;
+
+			for (int i = firstChildIndex + 1; i <= lastChildIndex; ++i)
+			{
+				if (isHigher(mKeys[i], mKeys[bestChildIndex]))
+				{
+					bestChildIndex = i;
+				}
+			}
+
+			if (isHigher(mKeys[bestChildIndex], key) == false)
+			{
+				break;
+			}
+
+			place(index, mKeys[bestChildIndex]);
+			index = bestChildIndex;
+		}
+
+		place(index, key);
+	}
+
+	// capacity개짜리 배열을 newCapacity개로 늘리고 앞의 count개를 옮긴다
+	template <typename T>
+	inline static T* grow(T* datas, int capacity, int newCapacity, int count)
+	{
+		assert(count <= capacity && capacity < newCapacity);
+
+		T* newDatas = new T[newCapacity];
+		memcpy(newDatas, datas, sizeof(T) * count);
+		delete[] datas;
+
+		return newDatas;
+	}
+
+	enum
+	{
+		DEFAULT_INITIAL_CAPACITY = 4096,
+	};
+
+private:
+	OpenListKey* mKeys;
+	int* mPositions;		// 노드 번호 별 힙 안에서의 위치
+	int mSize;
+	int mCapacity;			// 키 배열의 원소 수
+	int mPositionCapacity;	// 위치 배열의 원소 수
+};
+
+// 길찾기에서 사용할 OPEN LIST
+using OpenList = IndexedPriorityQueue<4>;
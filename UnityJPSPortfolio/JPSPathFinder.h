@@ -1,900 +1,652 @@
 #pragma once
 
-#include "PriorityQueue.h"
-#include <list>
-#include "Line.h"
+#include <vector>
+#include <utility>
+#include <climits>
+#include <cmath>
+#include <chrono>
+#include "LineOfSight.h"
 #include "Point.h"
+#include "Path.h"
+#include "PathFindMap.h"
+#include "GridDirection.h"
+#include "GridSearch.h"
+#include "JumpPointSuccessors.h"
 
 class JPSPathFinder
 {
 public:
+	// PathFindBatch()의 쿼리 하나
+	struct Query
+	{
+		int StartX;
+		int StartY;
+		int EndX;
+		int EndY;
+	};
+
+	// PathFindBatch()의 쿼리 하나에 대한 결과
+	struct BatchResult
+	{
+		int PointOffset;        // 경로의 첫 좌표(시작점)가 outPoints의 몇 번째인가
+		int PointCount;         // 경로의 좌표 수 (경로가 없다면 0)
+		int PathCost;           // GetPathCost()와 같은 값
+		int ExpandedNodeCount;  // GetExpandedNodeCount()와 같은 값
+	};
+
+	// 탐색 방식
+	enum ESearchMode
+	{
+		JumpPoint,			// JPS (+ JPS+) 탐색 후 ReduceNodes()로 경로를 줄인다
+		LazyThetaStar,		// Lazy Theta* (탐색하면서 직선으로 이어지는 조상 노드를 부모로 삼아 바로 줄어든 경로를 만든다)
+	};
+
+public:
+	// 자신만의 맵을 만들어 사용한다
 	JPSPathFinder(int mapWidth, int mapHeight)
 		: mWidth(mapWidth)
 		, mHeight(mapHeight)
-		, mOpenList(mapWidth* mapHeight)
+		, mOwnedMap(new PathFindMap(mapWidth, mapHeight))
+		, mMap(*mOwnedMap)
+		, mGrid(mMap.GetGrid())
+		, mState(mGrid)
 	{
-		mMap = new bool* [mapHeight];
-		mbOpenListMade = new bool* [mapHeight];
-		mG = new int* [mapHeight];
-
-		for (int i = 0; i < mapHeight; ++i)
-		{
-			mMap[i] = new bool[mapWidth];
-			mbOpenListMade[i] = new bool[mapWidth];
-			mG[i] = new int[mapWidth];
-
-			for (int j = 0; j < mapWidth; ++j)
-			{
-				mMap[i][j] = true;
-				mbOpenListMade[i][j] = true;
-				mG[i][j] = -1;
-			}
-		}
 	}
 
-	~JPSPathFinder()
+	// 다른 JPSPathFinder들과 맵을 공유한다 (탐색 상태만 따로 가진다)
+	// 맵은 이 객체보다 오래 살아 있어야 하고, 탐색 중에는 수정하면 안 된다
+	explicit JPSPathFinder(const PathFindMap& map)
+		: mWidth(map.GetWidth())
+		, mHeight(map.GetHeight())
+		, mOwnedMap(nullptr)
+		, mMap(map)
+		, mGrid(map.GetGrid())
+		, mState(mGrid)
 	{
-		for (int i = 0; i < mHeight; ++i)
-		{
-			delete[] mMap[i];
-			delete[] mG[i];
-			delete[] mbOpenListMade[i];
-		}
-
-		delete mMap;
-		delete mG;
-		delete mbOpenListMade;
 	}
 
-	inline std::list<Point> GetPoints() { return mPoints; }
-	inline void Block(int x, int y) { mMap[y][x] = false; }
-	inline void UnBlock(int x, int y) { mMap[y][x] = true; }
-	inline bool IsBlocked(int x, int y)
+	~JPSPathFinder()
 	{
-		// out of range
-		if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
-		{
-			return true;
-		}
-
-		return !mMap[y][x];
+		delete mOwnedMap;
 	}
 
-	inline const std::list<Point>::iterator Begin() { return mPoints.begin(); }
-	inline const std::list<Point>::iterator End() { return mPoints.end(); }
-
-	std::list<Point>::iterator PathFind(int startX, int startY, int endX, int endY)
-	{
-		//PROFILE(L"JPS");
-
-		if (startX < 0 || endX < 0 || startX >= mWidth || startY >= mHeight)
-		{
-			return End();
-		}
+	JPSPathFinder(const JPSPathFinder& other) = delete;
+	JPSPathFinder& operator=(const JPSPathFinder& other) = delete;
 
-		if (mMap[startY][startX] == false || mMap[endY][endX] == false)
-		{
-			return End();
-		}
+	// 마지막으로 찾은 경로 (다음 PathFind() 전까지 유효)
+	inline const Path& GetPoints() const { return mPoints; }
 
-		Clear();
-
-		Node* startNode = new Node(startX, startY, 0, nullptr, endX, endY);
-		mOpenList.Push(startNode);
+	// 마지막으로 찾은 경로를 꺼내간다 (복사 없이 옮기고, 이 객체의 경로는 비워진다)
+	inline Path TakePoints() { return std::move(mPoints); }
+	inline bool IsBlocked(int x, int y) const { return mMap.IsBlocked(x, y); }
 
-		while (mOpenList.Empty() == false)
-		{
-			Node* currentNode = mOpenList.Top();
-			mOpenList.Pop();
+	// 맵 수정은 자신만의 맵을 가진 경우에만 가능하다 (공유 맵은 PathFindMap에서 직접 수정)
+	inline void Block(int x, int y) { getOwnedMap()->Block(x, y); }
+	inline void UnBlock(int x, int y) { getOwnedMap()->UnBlock(x, y); }
+	inline void EnableJumpTable() { getOwnedMap()->EnableJumpTable(); }
+	inline void DisableJumpTable() { getOwnedMap()->DisableJumpTable(); }
+	inline bool IsJumpTableEnabled() const { return mMap.IsJumpTableEnabled(); }
 
-			// Find
-			if (currentNode->X == endX && currentNode->Y == endY)
-			{
-				reduceNodes(currentNode);
-
-				Node* visit = currentNode;
-				while (visit != nullptr)
-				{
-					mPoints.push_front(Point{ visit->X, visit->Y });
-					visit = visit->Parent;
-				}
-
-				break;
-			}
+	// 탐색 방식 (기본은 JumpPoint, 다음 PathFind()부터 적용, 나눠서 찾는 중에는 바꿀 수 없다)
+	void SetSearchMode(ESearchMode searchMode)
+	{
+		assert(mStatus != ESearchStatus::Suspended);
 
-			// 8방향 검사
-			if (currentNode->Parent == nullptr)
-			{
-				// 시작 노드인 경우
-				PathCheckLL(currentNode, endX, endY);
-				PathCheckRR(currentNode, endX, endY);
-				PathCheckUU(currentNode, endX, endY);
-				PathCheckDD(currentNode, endX, endY);
-				PathCheckLU(currentNode, endX, endY);
-				PathCheckLD(currentNode, endX, endY);
-				PathCheckRU(currentNode, endX, endY);
-				PathCheckRD(currentNode, endX, endY);
-			}
-			else if (currentNode->Parent->Y == currentNode->Y && currentNode->Parent->X < currentNode->X)
-			{
-				//
-				// [P] -> (N)
-				//
-				PathCheckRR(currentNode, endX, endY);
-				PathCheckRU(currentNode, endX, endY);
-				PathCheckRD(currentNode, endX, endY);
-			}
-			else if (currentNode->Parent->Y == currentNode->Y && currentNode->Parent->X > currentNode->X)
-			{
-				//
-				// (N) <- [P]
-				//
-				PathCheckLL(currentNode, endX, endY);
-				PathCheckLD(currentNode, endX, endY);
-				PathCheckLU(currentNode, endX, endY);
-			}
-			else if (currentNode->Parent->X == currentNode->X && currentNode->Parent->Y > currentNode->Y)
-			{
-				//    (N)
-				//     ↑
-				//    [P]
-				PathCheckUU(currentNode, endX, endY);
-				PathCheckLU(currentNode, endX, endY);
-				PathCheckRU(currentNode, endX, endY);
-			}
-			else if (currentNode->Parent->X == currentNode->X && currentNode->Parent->Y < currentNode->Y)
-			{
-				//    [P]
-				//     ↓
-				//    (N)
-				PathCheckDD(currentNode, endX, endY);
-				PathCheckLD(currentNode, endX, endY);
-				PathCheckRD(currentNode, endX, endY);
-			}
-			else if (currentNode->Parent->X < currentNode->X && currentNode->Parent->Y < currentNode->Y)
-			{
-				// [P]
-				//    ↘ 
-				//      (N)
+		mSearchMode = searchMode;
+	}
 
-				if (IsBlocked(currentNode->X, currentNode->Y - 1) == true && IsBlocked(currentNode->X + 1, currentNode->Y - 1) == false)
-				{
-					PathCheckRU(currentNode, endX, endY);
-				}
+	inline ESearchMode GetSearchMode() const { return mSearchMode; }
 
-				PathCheckRR(currentNode, endX, endY);
-				PathCheckRD(currentNode, endX, endY);
-				PathCheckDD(currentNode, endX, endY);
+	// 마지막으로 찾은 경로의 비용, 경로가 없었다면 -1
+	// JumpPoint : 경로를 줄이기 전 G값 (직선 5, 대각선 7)
+	// LazyThetaStar : 줄어든 경로의 유클리드 거리 x 5 (반올림)
+	inline int GetPathCost() const { return mPathCost; }
 
-				if (IsBlocked(currentNode->X - 1, currentNode->Y) == true && IsBlocked(currentNode->X - 1, currentNode->Y + 1) == false)
-				{
-					PathCheckLD(currentNode, endX, endY);
-				}
-			}
-			else if (currentNode->Parent->X > currentNode->X && currentNode->Parent->Y > currentNode->Y)
-			{
-				// (N)
-				//    ↖ 
-				//      [P]
+	// 마지막 탐색에서 OPEN LIST에서 꺼내 확장한 노드 수
+	inline int GetExpandedNodeCount() const { return mState.GetExpandedNodeCount(); }
 
-				if (IsBlocked(currentNode->X, currentNode->Y + 1) == true && IsBlocked(currentNode->X - 1, currentNode->Y + 1) == false)
-				{
-					PathCheckLD(currentNode, endX, endY);
-				}
+	// 마지막 탐색에서 OPEN LIST에 넣고, 꺼내고, 키를 줄인 횟수와 만든 노드 수
+	inline int GetHeapOperationCount() const { return mState.GetHeapOperationCount(); }
+	inline int GetAllocatedNodeCount() const { return mState.GetAllocatedNodeCount(); }
 
-				PathCheckLL(currentNode, endX, endY);
-				PathCheckLU(currentNode, endX, endY);
-				PathCheckUU(currentNode, endX, endY);
+	// 마지막 탐색의 통계 (점프한 칸 수, 키를 줄인 횟수, 직선 검사한 칸 수, 시간은 PATHFIND_STATISTICS_ON일 때만 센다)
+	// 나눠서 찾았다면 조각들의 합, 부분 경로라면 FinishWithPartialPath()의 경로 줄이기까지 포함한다
+	inline SearchStatistics GetSearchStatistics() const { return mState.GetStatistics(); }
 
-				if (IsBlocked(currentNode->X + 1, currentNode->Y) == true && IsBlocked(currentNode->X + 1, currentNode->Y - 1) == false)
-				{
-					PathCheckRU(currentNode, endX, endY);
-				}
-			}
-			else if (currentNode->Parent->X < currentNode->X && currentNode->Parent->Y > currentNode->Y)
-			{
-				//       (N)
-				//     ↗
-				// [P]
-				if (IsBlocked(currentNode->X - 1, currentNode->Y) == true && IsBlocked(currentNode->X - 1, currentNode->Y - 1) == false)
-				{
-					PathCheckLU(currentNode, endX, endY);
-				}
+	// 마지막 탐색이 시작 칸과 도착 칸의 연결 요소가 달라서 탐색 없이 끝났는가 (맵의 연결 요소가 켜져 있을 때만)
+	inline bool IsRejected() const { return mbRejected; }
 
-				PathCheckUU(currentNode, endX, endY);
-				PathCheckRU(currentNode, endX, endY);
-				PathCheckRR(currentNode, endX, endY);
+	// 탐색 상태(OPEN LIST, 셀 별 노드 번호, 노드 배열)의 총 크기 (byte), 맵은 포함하지 않는다
+	inline size_t GetReservedBytes() const
+	{
+		return mState.GetReservedBytes();
+	}
 
-				if (IsBlocked(currentNode->X, currentNode->Y + 1) == true && IsBlocked(currentNode->X + 1, currentNode->Y + 1) == false)
-				{
-					PathCheckRD(currentNode, endX, endY);
-				}
-			}
-			else if (currentNode->Parent->X > currentNode->X && currentNode->Parent->Y < currentNode->Y)
-			{
-				//       [P]
-				//     ↙
-				// (N)
-				if (IsBlocked(currentNode->X + 1, currentNode->Y) == true && IsBlocked(currentNode->X + 1, currentNode->Y + 1) == false)
-				{
-					PathCheckRD(currentNode, endX, endY);
-				}
+	inline const Point* Begin() const { return mPoints.Begin(); }
+	inline const Point* End() const { return mPoints.End(); }
 
-				PathCheckDD(currentNode, endX, endY);
-				PathCheckLD(currentNode, endX, endY);
-				PathCheckLL(currentNode, endX, endY);
+	const Point* PathFind(int startX, int startY, int endX, int endY)
+	{
+		//PROFILE(L"JPS");
 
-				if (IsBlocked(currentNode->X, currentNode->Y - 1) == true && IsBlocked(currentNode->X - 1, currentNode->Y - 1) == false)
-				{
-					PathCheckLU(currentNode, endX, endY);
-				}
-			}
-			else
-			{
-				assert(false);
-			}
+		if (BeginPathFind(startX, startY, endX, endY) == ESearchStatus::Suspended)
+		{
+			ContinuePathFind(0);
 		}
 
 		return Begin();
 	}
 
-	void Clear()
+	// 확장 노드 수와 시간에 한도를 둔 길찾기 (0 이하면 제한 없음)
+	// 한도 안에 찾지 못했거나 목적지에 갈 수 없다면 FinishWithPartialPath()로 가장 가까이 간 곳까지의 경로를 담는다 (IsPartial())
+	// 부분 경로의 끝에서 목적지까지는 나중에 다시 찾으면 된다
+	const Point* PathFindPartial(int startX, int startY, int endX, int endY, int maxExpandedNodeCount, int maxMicroseconds = 0)
 	{
-		mPoints.clear();
-		mOpenList.Clear();
+		if (BeginPathFind(startX, startY, endX, endY, true) == ESearchStatus::Suspended)
+		{
+			ContinuePathFind(maxExpandedNodeCount, maxMicroseconds);
+		}
 
-		for (int i = 0; i < mHeight; ++i)
+		if (mStatus != ESearchStatus::Found)
 		{
-			for (int j = 0; j < mWidth; ++j)
-			{
-				mG[i][j] = -1;
-				mbOpenListMade[i][j] = false;
-			}
+			FinishWithPartialPath();
 		}
-	}
 
-private:
-	//Path Check
+		return Begin();
+	}
 
-	void PathCheckLL(Node* node, int endX, int endY)
+	// 나눠서 찾기를 시작한다 (확장은 ContinuePathFind()에서 한다)
+	// 막힌 칸이거나 연결 요소가 달라서 찾을 필요가 없다면 NotFound, 아니라면 Suspended
+	// bSearchUnreachable : 연결 요소가 달라도 찾는다 (부분 경로로 가장 가까운 곳까지 가려는 경우, IsRejected()는 그대로 true)
+	ESearchStatus BeginPathFind(int startX, int startY, int endX, int endY, bool bSearchUnreachable = false)
 	{
-		int x = node->X - 1;
-		int y = node->Y;
+		Clear();
 
-		bool bCreateNode = false;
+		return start(startX, startY, endX, endY, bSearchUnreachable);
+	}
 
-		while (true)
-		{
-			if (x == endX && y == endY)
-			{
-				bCreateNode = true;
-				break;
-			}
+	// 멈춘 탐색을 이어서, 노드를 maxExpandedNodeCount개 확장하거나 maxMicroseconds가 지나면 다시 멈춘다 (0 이하면 제한 없음)
+	// OPEN LIST, G값, 노드는 이 객체의 탐색 상태에 그대로 남아 있으므로 다음 틱에 이어서 찾을 수 있다
+	// Found라면 GetPoints()에 경로가 들어 있다
+	// 멈춘 동안 맵이 바뀌었다면 (PathFindMap::GetVersion()) 이전 G값을 믿을 수 없으므로 처음부터 다시 찾는다
+	ESearchStatus ContinuePathFind(int maxExpandedNodeCount, int maxMicroseconds = 0)
+	{
+		assert(mStatus == ESearchStatus::Suspended);
 
-			if (IsBlocked(x, y))
-			{
-				break;
-			}
+		PATHFIND_STATISTICS(const auto sliceBegin = std::chrono::steady_clock::now());
 
-			bool bNewPathUp = IsBlocked(x, y - 1) == true && IsBlocked(x - 1, y - 1) == false;
-			bool bNewPathDown = IsBlocked(x, y + 1) == true && IsBlocked(x - 1, y + 1) == false;
+		if (mSearchVersion != mMap.GetVersion())
+		{
+			mState.Clear();
 
-			if (bNewPathUp || bNewPathDown)
+			if (start(mStartX, mStartY, mEndX, mEndY, mbSearchUnreachable) != ESearchStatus::Suspended)
 			{
-				bCreateNode = true;
-				break;
+				mSliceExpandedNodeCount = 0;
+				return mStatus;
 			}
-
-			x--;
 		}
 
-		if (bCreateNode)
+		const int expandedNodeCount = mState.GetExpandedNodeCount();
+
+		if (maxMicroseconds <= 0)
 		{
-			CreateNode(x, y, node->G + (node->X - x) * 5, node, endX, endY);
+			resume(maxExpandedNodeCount);
 		}
-	}
-
-	void PathCheckRR(Node* node, int endX, int endY)
-	{
-		int x = node->X + 1;
-		int y = node->Y;
-
-		bool bCreateNode = false;
-
-		while (true)
+		else
 		{
-			if (x == endX && y == endY)
-			{
-				bCreateNode = true;
-				break;
-			}
+			// 시계는 TIME_CHECK_INTERVAL개를 확장할 때마다 한 번만 본다
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(maxMicroseconds);
+			int remainingCount = maxExpandedNodeCount;
 
-			if (IsBlocked(x, y))
+			do
 			{
-				break;
-			}
+				int count = TIME_CHECK_INTERVAL;
 
-			bool bNewPathUp = IsBlocked(x, y - 1) == true && IsBlocked(x + 1, y - 1) == false;
-			bool bNewPathDown = IsBlocked(x, y + 1) == true && IsBlocked(x + 1, y + 1) == false;
-
-			if (bNewPathUp || bNewPathDown)
-			{
-				bCreateNode = true;
-				break;
-			}
+				if (maxExpandedNodeCount > 0 && remainingCount < count)
+				{
+					count = remainingCount;
+				}
 
-			x++;
+				resume(count);
+				remainingCount -= count;
+			} while (mStatus == ESearchStatus::Suspended && (maxExpandedNodeCount <= 0 || remainingCount > 0)
+				&& std::chrono::steady_clock::now() < deadline);
 		}
 
-		if (bCreateNode)
+		mSliceExpandedNodeCount = mState.GetExpandedNodeCount() - expandedNodeCount;
+
+		if (mStatus == ESearchStatus::Found)
 		{
-			CreateNode(x, y, node->G + (x - node->X) * 5, node, endX, endY);
+			mState.CopyPoints(mState.GetDestination(), mPoints);
 		}
+
+		PATHFIND_STATISTICS(mState.AddElapsedNanoseconds(getElapsedNanoseconds(sliceBegin)));
+
+		return mStatus;
 	}
 
-	void PathCheckUU(Node* node, int endX, int endY)
+	// 끝나지 않은 탐색(Suspended)이나 경로를 찾지 못한 탐색(NotFound)에서, 지금까지 만든 노드 중
+	// 목적지까지의 휴리스틱이 가장 작은 노드까지의 경로를 GetPoints()에 담는다 (GetPathCost()는 그 노드까지의 비용)
+	// 시작점보다 목적지에 가까워진 노드가 있다면 true를 반환하고 탐색은 끝난다 (NotFound, 더 이어서 찾을 수 없다)
+	// 없다면 false를 반환하고 아무것도 바꾸지 않는다
+	bool FinishWithPartialPath()
 	{
-		int x = node->X;
-		int y = node->Y - 1;
+		assert(mStatus != ESearchStatus::Found);
 
-		bool bCreateNode = false;
+		const NodeArena& nodes = mState.GetNodeArena();
+		const NodeIndex closestNode = mState.FindClosestNode();
 
-		while (true)
+		// 시작 노드는 처음에 만든 노드다
+		if (closestNode == NULL_NODE || nodes.GetParent(closestNode) == NULL_NODE)
 		{
-			if (x == endX && y == endY)
-			{
-				bCreateNode = true;
-				break;
-			}
-
-			if (IsBlocked(x, y))
-			{
-				break;
-			}
-
-			bool bNewPathUp = IsBlocked(x - 1, y) == true && IsBlocked(x - 1, y - 1) == false;
-			bool bNewPathDown = IsBlocked(x + 1, y) == true && IsBlocked(x + 1, y - 1) == false;
+			return false;
+		}
 
-			if (bNewPathUp || bNewPathDown)
+		if (mSearchMode == LazyThetaStar)
+		{
+			// OPEN LIST에 있는 노드는 부모와의 직선 검사를 미뤄둔 상태이므로 여기서 한다
+			if (mState.GetOpenList().Contains(closestNode) && isParentVisible(closestNode) == false)
 			{
-				bCreateNode = true;
-				break;
+				setParentToClosedNeighbor(closestNode);
 			}
-
-			y--;
 		}
-
-		if (bCreateNode)
+		else
 		{
-			CreateNode(x, y, node->G + (node->Y - y) * 5, node, endX, endY);
+			mState.ReduceNodes(closestNode);
 		}
-	}
 
-	void PathCheckDD(Node* node, int endX, int endY)
-	{
-		int x = node->X;
-		int y = node->Y + 1;
-
-		bool bCreateNode = false;
-
-		while (true)
-		{
-			if (x == endX && y == endY)
-			{
-				bCreateNode = true;
-				break;
-			}
+		mStatus = ESearchStatus::NotFound;
+		mbPartial = true;
+		mPathCost = nodes.GetG(closestNode);
+		mState.CopyPoints(closestNode, mPoints);
 
-			if (IsBlocked(x, y))
-			{
-				break;
-			}
+		return true;
+	}
 
-			bool bNewPathUp = IsBlocked(x - 1, y) == true && IsBlocked(x - 1, y + 1) == false;
-			bool bNewPathDown = IsBlocked(x + 1, y) == true && IsBlocked(x + 1, y + 1) == false;
+	// 마지막 경로가 목적지가 아닌 가장 가까이 간 곳까지의 부분 경로인가 (FinishWithPartialPath())
+	inline bool IsPartial() const { return mbPartial; }
 
-			if (bNewPathUp || bNewPathDown)
-			{
-				bCreateNode = true;
-				break;
-			}
+	// 마지막 PathFind(), BeginPathFind(), ContinuePathFind()의 결과 (탐색한 적이 없다면 NotFound)
+	inline ESearchStatus GetStatus() const { return mStatus; }
 
-			y++;
-		}
+	// 마지막 ContinuePathFind() 한 번에서 확장한 노드 수 (GetExpandedNodeCount()는 탐색 전체)
+	inline int GetSliceExpandedNodeCount() const { return mSliceExpandedNodeCount; }
 
-		if (bCreateNode)
+	// 여러 쿼리를 한 번에 찾는다
+	// 탐색 상태는 쿼리 사이에 그대로 재사용하고, 경로 좌표(시작점 포함)는 쿼리마다 Path를 만들지 않고 outPoints 뒤에 이어 붙인다
+	// outResults[i]에는 i번째 쿼리의 경로가 outPoints의 어디에 있는지 기록한다
+	void PathFindBatch(const Query* queries, int queryCount, BatchResult* outResults, std::vector<Point>& outPoints)
+	{
+		for (int i = 0; i < queryCount; ++i)
 		{
-			CreateNode(x, y, node->G + (y - node->Y) * 5, node, endX, endY);
-		}
-	}
+			const Query& query = queries[i];
+			BatchResult& result = outResults[i];
 
-	void PathCheckLU(Node* node, int endX, int endY)
-	{
-		int x = node->X - 1;
-		int y = node->Y - 1;
-		int i = 0;
+			Clear();
 
-		bool bCreateNode = false;
+			const NodeIndex destination = search(query.StartX, query.StartY, query.EndX, query.EndY);
+			const NodeArena& nodes = mState.GetNodeArena();
 
-		while (true)
-		{
-			if (x == endX && y == endY)
-			{
-				bCreateNode = true;
-				break;
-			}
+			result.PointOffset = static_cast<int>(outPoints.size());
+			result.PointCount = 0;
+			result.PathCost = mPathCost;
+			result.ExpandedNodeCount = mState.GetExpandedNodeCount();
 
-			if (IsBlocked(x, y))
+			for (NodeIndex visit = destination; visit != NULL_NODE; visit = nodes.GetParent(visit))
 			{
-				break;
+				result.PointCount++;
 			}
 
-			bool bNewPathSide1 = IsBlocked(x + 1, y) == true && IsBlocked(x + 1, y - 1) == false;
-			bool bNewPathSide2 = IsBlocked(x, y + 1) == true && IsBlocked(x - 1, y + 1) == false;
+			outPoints.resize(outPoints.size() + result.PointCount);
 
-			if (bNewPathSide1 || bNewPathSide2)
-			{
-				bCreateNode = true;
-				break;
-			}
+			// 도착점부터 거꾸로 채운다
+			int index = result.PointOffset + result.PointCount - 1;
 
-			// ←
-			i = 1;
-			while (true)
+			for (NodeIndex visit = destination; visit != NULL_NODE; visit = nodes.GetParent(visit))
 			{
-				if (x - i == endX && y == endY)
-				{
-					bCreateNode = true;
-					break;
-				}
-
-				if (IsBlocked(x - i, y))
-				{
-					break;
-				}
-
-				bool bNewPathUp = IsBlocked(x - i, y - 1) == true && IsBlocked(x - i - 1, y - 1) == false;
-				bool bNewPathDown = IsBlocked(x - i, y + 1) == true && IsBlocked(x - i - 1, y + 1) == false;
+				outPoints[index] = Point{ nodes.GetX(visit), nodes.GetY(visit) };
+				index--;
+			}
+		}
+	}
 
-				if (bNewPathUp || bNewPathDown)
-				{
-					bCreateNode = true;
-					break;
-				}
+	void Clear()
+	{
+		mPoints.Clear();
+		mPathCost = -1;
+		mbRejected = false;
+		mbPartial = false;
+		mStatus = ESearchStatus::NotFound;
+		mSliceExpandedNodeCount = 0;
+		mState.Clear();
+	}
 
-				i++;
-			}
+private:
+	// 경로를 찾아 ReduceNodes()까지 끝낸 도착 노드를 반환한다 (경로가 없다면 NULL_NODE)
+	// 부모를 따라가면 시작 노드까지 거슬러 올라간다 (노드 번호는 다음 Clear() 전까지 유효)
+	NodeIndex search(int startX, int startY, int endX, int endY)
+	{
+		PATHFIND_STATISTICS(const auto searchBegin = std::chrono::steady_clock::now());
 
-			if (bCreateNode)
-			{
-				break;
-			}
+		if (start(startX, startY, endX, endY, false) == ESearchStatus::Suspended)
+		{
+			resume(0);
+		}
 
-			// ↑
-			i = 1;
-			while (true)
-			{
-				if (x == endX && y - i == endY)
-				{
-					bCreateNode = true;
-					break;
-				}
+		PATHFIND_STATISTICS(mState.AddElapsedNanoseconds(getElapsedNanoseconds(searchBegin)));
 
-				if (IsBlocked(x, y - i))
-				{
-					break;
-				}
+		return mStatus == ESearchStatus::Found ? mState.GetDestination() : NULL_NODE;
+	}
 
-				bool bNewPathUp = IsBlocked(x - 1, y - i) == true && IsBlocked(x - 1, y - i - 1) == false;
-				bool bNewPathDown = IsBlocked(x + 1, y - i) == true && IsBlocked(x + 1, y - i - 1) == false;
+	// 찾을 필요가 없는 쿼리를 거르고, 탐색할 쿼리라면 시작 노드는 첫 resume()에서 연다
+	ESearchStatus start(int startX, int startY, int endX, int endY, bool bSearchUnreachable)
+	{
+		mStartX = startX;
+		mStartY = startY;
+		mEndX = endX;
+		mEndY = endY;
+		mbSearchUnreachable = bSearchUnreachable;
+		mSearchVersion = mMap.GetVersion();
+		mbStartPending = true;
+		mbRejected = false;
+		mStatus = ESearchStatus::NotFound;
+
+		if (IsBlocked(startX, startY) || IsBlocked(endX, endY))
+		{
+			return mStatus;
+		}
 
-				if (bNewPathUp || bNewPathDown)
-				{
-					bCreateNode = true;
-					break;
-				}
+		// 막힌 영역 안의 목적지처럼 닿을 수 없는 쿼리는 도달 가능한 칸을 전부 확장해야 실패하므로 미리 거른다
+		const ConnectedComponents* components = mMap.GetComponents();
 
-				i++;
-			}
+		if (components != nullptr && components->IsInSameComponent(startX, startY, endX, endY) == false)
+		{
+			mbRejected = true;
 
-			if (bCreateNode)
+			if (bSearchUnreachable == false)
 			{
-				break;
+				return mStatus;
 			}
-
-			x--;
-			y--;
 		}
 
-		if (bCreateNode)
-		{
-			CreateNode(x, y, node->G + abs(node->Y - y) * 7, node, endX, endY);
-		}
+		mStatus = ESearchStatus::Suspended;
+		return mStatus;
 	}
 
-	void PathCheckLD(Node* node, int endX, int endY)
+	// 노드를 최대 maxExpandedNodeCount개 확장한다 (0 이하면 끝날 때까지)
+	// 정책 선택은 맵 버전이 같은 동안 바뀌지 않으므로, 매번 다시 골라도 같은 GridSearch로 이어서 찾는다
+	void resume(int maxExpandedNodeCount)
 	{
-		int x = node->X - 1;
-		int y = node->Y + 1;
-		int i = 0;
-
-		bool bCreateNode = false;
+		const bool bStart = mbStartPending;
+		mbStartPending = false;
 
-		while (true)
+		if (mSearchMode == LazyThetaStar)
 		{
-			if (x == endX && y == endY)
-			{
-				bCreateNode = true;
-				break;
-			}
-
-			if (IsBlocked(x, y))
-			{
-				break;
-			}
-
-			bool bNewPathSide1 = IsBlocked(x, y - 1) == true && IsBlocked(x - 1, y - 1) == false;
-			bool bNewPathSide2 = IsBlocked(x + 1, y) == true && IsBlocked(x + 1, y + 1) == false;
+			mStatus = searchLazyTheta(bStart, maxExpandedNodeCount);
+			return;
+		}
 
-			if (bNewPathSide1 || bNewPathSide2)
-			{
-				bCreateNode = true;
-				break;
-			}
+		// 랜드마크 거리표가 있다면 옥타일 거리와 랜드마크 하한 중 큰 값을 쓴다 (맵이 바뀌어 무효라면 옥타일 거리만 쓴다)
+		const LandmarkTable* landmarks = mMap.GetLandmarks();
 
-			// ←
-			i = 1;
-			while (true)
-			{
-				if (x - i == endX && y == endY)
-				{
-					bCreateNode = true;
-					break;
-				}
+		mStatus = landmarks != nullptr && landmarks->IsValid()
+			? searchJumpPoint(LandmarkHeuristic<>(*landmarks, mEndX, mEndY), bStart, maxExpandedNodeCount)
+			: searchJumpPoint(OctileHeuristic<>(mEndX, mEndY), bStart, maxExpandedNodeCount);
 
-				if (IsBlocked(x - i, y))
-				{
-					break;
-				}
+		if (mStatus == ESearchStatus::Found)
+		{
+			const NodeIndex destination = mState.GetDestination();
 
-				bool bNewPathUp = IsBlocked(x - i, y - 1) == true && IsBlocked(x - i - 1, y - 1) == false;
-				bool bNewPathDown = IsBlocked(x - i, y + 1) == true && IsBlocked(x - i - 1, y + 1) == false;
+			mPathCost = mState.GetNodeArena().GetG(destination);
+			mState.ReduceNodes(destination);
+		}
+	}
 
-				if (bNewPathUp || bNewPathDown)
-				{
-					bCreateNode = true;
-					break;
-				}
+	// 휴리스틱과 점프 방식(JPS+ 테이블, 목표 경계 상자 여부)에 맞는 GridSearch로 찾는다
+	// 목표 경계 상자는 맵이 바뀌어 무효라면 쓰지 않는다
+	template <typename Heuristic>
+	ESearchStatus searchJumpPoint(const Heuristic& heuristic, bool bStart, int maxExpandedNodeCount)
+	{
+		const GoalBoundingTable* goalBounds = mMap.GetGoalBounds();
+		const bool bGoalBounds = goalBounds != nullptr && goalBounds->IsValid();
 
-				i++;
-			}
+		if (mMap.IsJumpTableEnabled())
+		{
+			return bGoalBounds
+				? searchBy<JumpPointSuccessors<true, true>>(heuristic, bStart, maxExpandedNodeCount)
+				: searchBy<JumpPointSuccessors<true, false>>(heuristic, bStart, maxExpandedNodeCount);
+		}
 
-			if (bCreateNode)
-			{
-				break;
-			}
+		return bGoalBounds
+			? searchBy<JumpPointSuccessors<false, true>>(heuristic, bStart, maxExpandedNodeCount)
+			: searchBy<JumpPointSuccessors<false, false>>(heuristic, bStart, maxExpandedNodeCount);
+	}
 
-			// ↓
-			i = 1;
-			while (true)
-			{
-				if (x == endX && y + i == endY)
-				{
-					bCreateNode = true;
-					break;
-				}
+	template <typename Successors, typename Heuristic>
+	inline ESearchStatus searchBy(const Heuristic& heuristic, bool bStart, int maxExpandedNodeCount)
+	{
+		GridSearch<Successors, Heuristic> search(mState, Successors(mMap), heuristic);
 
-				if (IsBlocked(x, y + i))
-				{
-					break;
-				}
+		if (bStart)
+		{
+			search.Start(mStartX, mStartY);
+		}
 
-				bool bNewPathUp = IsBlocked(x - 1, y + i) == true && IsBlocked(x - 1, y + i + 1) == false;
-				bool bNewPathDown = IsBlocked(x + 1, y + i) == true && IsBlocked(x + 1, y + i + 1) == false;
+		return search.Resume(mEndX, mEndY, maxExpandedNodeCount);
+	}
 
-				if (bNewPathUp || bNewPathDown)
-				{
-					bCreateNode = true;
-					break;
-				}
+	inline static int64_t getElapsedNanoseconds(std::chrono::steady_clock::time_point begin)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+	}
 
-				i++;
-			}
+	inline PathFindMap* getOwnedMap()
+	{
+		assert(mOwnedMap != nullptr);
+		return mOwnedMap;
+	}
 
-			if (bCreateNode)
-			{
-				break;
-			}
+#pragma region Lazy Theta*
 
-			x--;
-			y++;
-		}
+	// Lazy Theta* (8방향 격자, 모서리 통과 허용)
+	// 이웃을 열 때는 직선 검사 없이 현재 노드의 부모를 그대로 부모로 삼고 (G = 부모의 G + 부모까지의 직선 거리),
+	// OPEN LIST에서 꺼낼 때 한 번만 부모와의 직선을 검사한다. 막혀 있다면 이미 닫힌 이웃 중 가장 가까운 경로를 가진 노드로 부모를 바꾼다
+	// 부모를 따라가면 바로 줄어든 경로가 되므로 ReduceNodes()는 하지 않는다
+	// GridSearch::Resume()과 같이 최대 maxExpandedNodeCount개를 확장하면 멈춘다 (0 이하면 끝날 때까지)
+	ESearchStatus searchLazyTheta(bool bStart, int maxExpandedNodeCount)
+	{
+		OpenList& openList = mState.GetOpenList();
+		SearchStateGrid& searchState = mState.GetSearchState();
+		NodeArena& nodes = mState.GetNodeArena();
+		const int endX = mEndX;
+		const int endY = mEndY;
 
-		if (bCreateNode)
+		if (bStart)
 		{
-			CreateNode(x, y, node->G + abs(y - node->Y) * 7, node, endX, endY);
+			createThetaNode(mStartX, mStartY, 0, NULL_NODE, endX, endY);
 		}
-	}
 
-	void PathCheckRU(Node* node, int endX, int endY)
-	{
-		int x = node->X + 1;
-		int y = node->Y - 1;
-		int i = 0;
+		int expandedNodeCount = 0;
 
-		bool bCreateNode = false;
-
-		while (true)
+		while (openList.Empty() == false)
 		{
-			if (x == endX && y == endY)
+			if (maxExpandedNodeCount > 0 && expandedNodeCount == maxExpandedNodeCount)
 			{
-				bCreateNode = true;
-				break;
+				return ESearchStatus::Suspended;
 			}
 
-			if (IsBlocked(x, y))
+			const NodeIndex currentNode = openList.Top();
+			openList.Pop();
+			mState.AddHeapOperation();
+			mState.AddExpandedNode();
+			expandedNodeCount++;
+
+			// 미뤄둔 직선 검사 (ReduceNodes()와 같이 뒤쪽 노드에서 앞쪽 노드 방향으로)
+			if (nodes.GetParent(currentNode) != NULL_NODE && isParentVisible(currentNode) == false)
 			{
-				break;
+				setParentToClosedNeighbor(currentNode);
 			}
 
-			bool bNewPathSide1 = IsBlocked(x - 1, y) == true && IsBlocked(x - 1, y - 1) == false;
-			bool bNewPathSide2 = IsBlocked(x, y + 1) == true && IsBlocked(x + 1, y + 1) == false;
+			const int currentX = nodes.GetX(currentNode);
+			const int currentY = nodes.GetY(currentNode);
 
-			if (bNewPathSide1 || bNewPathSide2)
+			// Find
+			if (currentX == endX && currentY == endY)
 			{
-				bCreateNode = true;
-				break;
+				mPathCost = nodes.GetG(currentNode);
+				mState.SetDestination(currentNode);
+				return ESearchStatus::Found;
 			}
 
-			// →
-			i = 1;
-			while (true)
+			// 이웃의 후보 부모 (시작 노드는 자기 자신)
+			const NodeIndex parent = nodes.GetParent(currentNode) != NULL_NODE ? nodes.GetParent(currentNode) : currentNode;
+			const int parentX = nodes.GetX(parent);
+			const int parentY = nodes.GetY(parent);
+			const int parentG = nodes.GetG(parent);
+
+			for (int direction = 0; direction < GridDirection::COUNT; ++direction)
 			{
-				if (x + i == endX && y == endY)
-				{
-					bCreateNode = true;
-					break;
-				}
+				int x = currentX + GridDirection::X[direction];
+				int y = currentY + GridDirection::Y[direction];
 
-				if (IsBlocked(x + i, y))
+				if (IsBlocked(x, y))
 				{
-					break;
+					continue;
 				}
 
-				bool bNewPathUp = IsBlocked(x + i, y - 1) == true && IsBlocked(x + i + 1, y - 1) == false;
-				bool bNewPathDown = IsBlocked(x + i, y + 1) == true && IsBlocked(x + i + 1, y + 1) == false;
+				int g = parentG + getEuclideanCost(x - parentX, y - parentY);
+				NodeIndex node = searchState.GetNode(x, y);
 
-				if (bNewPathUp || bNewPathDown)
+				if (node == NULL_NODE)
 				{
-					bCreateNode = true;
-					break;
+					createThetaNode(x, y, g, parent, endX, endY);
+					continue;
 				}
 
-				i++;
-			}
-
-			if (bCreateNode)
-			{
-				break;
-			}
-
-			// ↑
-			i = 1;
-			while (true)
-			{
-				if (x == endX && y - i == endY)
+				// 닫힌 노드는 다시 열지 않는다
+				if (g < nodes.GetG(node) && openList.Contains(node))
 				{
-					bCreateNode = true;
-					break;
-				}
+					nodes.SetG(node, g);
+					nodes.SetParent(node, parent);
 
-				if (IsBlocked(x, y - i))
-				{
-					break;
+					openList.DecreaseKey(node, g + nodes.GetH(node));
+					mState.AddHeapOperation();
+					mState.AddDecreaseKey();
 				}
+			}
+		}
 
-				bool bNewPathUp = IsBlocked(x - 1, y - i) == true && IsBlocked(x - 1, y - i - 1) == false;
-				bool bNewPathDown = IsBlocked(x + 1, y - i) == true && IsBlocked(x + 1, y - i - 1) == false;
+		return ESearchStatus::NotFound;
+	}
 
-				if (bNewPathUp || bNewPathDown)
-				{
-					bCreateNode = true;
-					break;
-				}
+	// H를 유클리드 거리로 바꾼 노드를 만들어 OPEN LIST에 넣는다
+	void createThetaNode(int x, int y, int g, NodeIndex parent, int endX, int endY)
+	{
+		const int h = getEuclideanHeuristic(endX - x, endY - y);
+		const NodeIndex node = mState.GetNodeArena().Alloc(x, y, g, parent, h);
 
-				i++;
-			}
+		mState.GetSearchState().SetNode(x, y, node);
+		mState.GetOpenList().Push(node, g + h, h);
+		mState.AddHeapOperation();
+	}
 
-			if (bCreateNode)
-			{
-				break;
-			}
+	// 노드에서 부모까지 직선으로 갈 수 있는가 (직선 검사 통계에 더한다)
+	bool isParentVisible(NodeIndex node)
+	{
+		const NodeArena& nodes = mState.GetNodeArena();
+		const NodeIndex parent = nodes.GetParent(node);
 
-			x++;
-			y--;
-		}
+		mState.AddLineOfSightCheck(nodes.GetX(node), nodes.GetY(node), nodes.GetX(parent), nodes.GetY(parent));
 
-		if (bCreateNode)
-		{
-			CreateNode(x, y, node->G + abs(node->Y - y) * 7, node, endX, endY);
-		}
+		return LineOfSight::IsClear(mGrid, nodes.GetX(node), nodes.GetY(node), nodes.GetX(parent), nodes.GetY(parent));
 	}
 
-	void PathCheckRD(Node* node, int endX, int endY)
+	// 닫힌 이웃 중 (이웃의 G + 이웃까지의 거리)가 가장 작은 노드를 부모로 삼는다
+	// node를 연 노드가 닫힌 이웃이므로 항상 하나 이상 있다
+	void setParentToClosedNeighbor(NodeIndex node)
 	{
-		int x = node->X + 1;
-		int y = node->Y + 1;
-		int i = 0;
+		const SearchStateGrid& searchState = mState.GetSearchState();
+		NodeArena& nodes = mState.GetNodeArena();
 
-		bool bCreateNode = false;
+		NodeIndex bestParent = NULL_NODE;
+		int bestG = INT_MAX;
 
-		while (true)
+		for (int direction = 0; direction < GridDirection::COUNT; ++direction)
 		{
-			if (x == endX && y == endY)
-			{
-				bCreateNode = true;
-				break;
-			}
+			int x = nodes.GetX(node) + GridDirection::X[direction];
+			int y = nodes.GetY(node) + GridDirection::Y[direction];
 
 			if (IsBlocked(x, y))
 			{
-				break;
-			}
-
-			bool bNewPathSide1 = IsBlocked(x, y - 1) == true && IsBlocked(x + 1, y - 1) == false;
-			bool bNewPathSide2 = IsBlocked(x - 1, y) == true && IsBlocked(x - 1, y + 1) == false;
-
-			if (bNewPathSide1 || bNewPathSide2)
-			{
-				bCreateNode = true;
-				break;
+				continue;
 			}
 
-			// →
-			i = 1;
-			while (true)
-			{
-				if (x + i == endX && y == endY)
-				{
-					bCreateNode = true;
-					break;
-				}
-
-				if (IsBlocked(x + i, y))
-				{
-					break;
-				}
-
-				bool bNewPathUp = IsBlocked(x + i, y - 1) == true && IsBlocked(x + i + 1, y - 1) == false;
-				bool bNewPathDown = IsBlocked(x + i, y + 1) == true && IsBlocked(x + i + 1, y + 1) == false;
-
-				if (bNewPathUp || bNewPathDown)
-				{
-					bCreateNode = true;
-					break;
-				}
+			NodeIndex neighbor = searchState.GetNode(x, y);
 
-				i++;
-			}
-
-			if (bCreateNode)
+			if (neighbor == NULL_NODE || mState.GetOpenList().Contains(neighbor))
 			{
-				break;
+				continue;
 			}
 
-			// ↓
-			i = 1;
-			while (true)
-			{
-				if (x == endX && y + i == endY)
-				{
-					bCreateNode = true;
-					break;
-				}
-
-				if (IsBlocked(x, y + i))
-				{
-					break;
-				}
-
-				bool bNewPathUp = IsBlocked(x - 1, y + i) == true && IsBlocked(x - 1, y + i + 1) == false;
-				bool bNewPathDown = IsBlocked(x + 1, y + i) == true && IsBlocked(x + 1, y + i + 1) == false;
-
-				if (bNewPathUp || bNewPathDown)
-				{
-					bCreateNode = true;
-					break;
-				}
-
-				i++;
-			}
+			// 한 칸 거리는 반올림한 직선 거리와 같다 (직선 5, 대각선 7)
+			int g = nodes.GetG(neighbor) + OctileCost::Get(direction);
 
-			if (bCreateNode)
+			if (g < bestG)
 			{
-				break;
+				bestParent = neighbor;
+				bestG = g;
 			}
-
-			x++;
-			y++;
 		}
 
-		if (bCreateNode)
-		{
-			CreateNode(x, y, node->G + abs(node->Y - y) * 7, node, endX, endY);
-		}
+		assert(bestParent != NULL_NODE);
+
+		nodes.SetParent(node, bestParent);
+		nodes.SetG(node, bestG);
 	}
 
-	// 노드 생성 & OPEN LIST에 push
-	void CreateNode(int x, int y, int g, Node* parent, int endX, int endY)
+	// 직선 거리 x 5 (반올림)
+	inline static int getEuclideanCost(int dx, int dy)
 	{
-		if (mbOpenListMade[y][x] == true)
-		{
-			if (g < mG[y][x])
-			{
-				int outIndex;
-				Node* node = mOpenList.GetNodeOrNull(x, y, outIndex);
-				assert(node != nullptr);
-
-				node->G = g;
-				node->F = node->G + node->H;
-				node->Parent = parent;
-				mG[y][x] = node->G;
-
-				mOpenList.RepairHeap(outIndex);
-			}
-
-			return;
-		}
-
-		Node* newNode = new Node(x, y, g, parent, endX, endY);
-		mOpenList.Push(newNode);
-		mbOpenListMade[y][x] = true;
-		mG[y][x] = newNode->G;
+		return static_cast<int>(sqrt(static_cast<double>(dx * dx + dy * dy)) * 5.0 + 0.5);
 	}
 
-private:
-	// 불필요한 중간 노드들의 연결을 끊는다
-	void reduceNodes(Node* destination) const
+	// 직선 거리 x 5 (내림, 과대평가하지 않도록)
+	inline static int getEuclideanHeuristic(int dx, int dy)
 	{
-		Node* startNode = destination;
-		Node* endNode = destination->Parent;
-
-		while (endNode != nullptr)
-		{
-			if (canIgnore(startNode, endNode))
-			{
-				startNode->Parent = endNode;
-				endNode = endNode->Parent;
-			}
-			else
-			{
-				startNode = startNode->Parent;
-			}
-		}
+		return static_cast<int>(sqrt(static_cast<double>(dx * dx + dy * dy)) * 5.0);
 	}
 
-	// start ~ end 사이에 벽에 걸리는 것이 없는가
-	bool canIgnore(const Node* start, const Node* end) const
-	{
-		Line line(start->X, start->Y, end->X, end->Y);
+#pragma endregion
 
-		for (auto it = line.Begin(); it != line.End(); ++it)
-		{
-			if (mMap[(*it).Y][(*it).X] == false)
-			{
-				return false;
-			}
-		}
+	enum
+	{
+		TIME_CHECK_INTERVAL = 32,	// ContinuePathFind()에 시간 한도가 있을 때 시계를 보는 확장 수 간격
+	};
 
-		return true;
-	}
 private:
-	std::list<Point> mPoints;
-	PriorityQueue mOpenList;
+	Path mPoints;
+
+	int mPathCost = -1;
+	bool mbRejected = false;
+	bool mbPartial = false;
 
 	const int mWidth;
 	const int mHeight;
-	bool** mbOpenListMade;
-	bool** mMap;
-	int** mG;
+	PathFindMap* mOwnedMap;		// 자신만의 맵을 만든 경우에만 (아니라면 nullptr)
+	const PathFindMap& mMap;
+	const BitGrid& mGrid;
+	GridSearchState mState;		// OPEN LIST, 셀 별 노드 번호, 노드 할당기 (JumpPoint와 LazyThetaStar가 같이 쓴다)
+
+	ESearchMode mSearchMode = JumpPoint;
+
+	// 나눠서 찾는 중인 쿼리 (PathFind()도 같은 경로로 찾는다)
+	ESearchStatus mStatus = ESearchStatus::NotFound;
+	int mStartX = 0;
+	int mStartY = 0;
+	int mEndX = 0;
+	int mEndY = 0;
+	bool mbSearchUnreachable = false;	// 연결 요소가 달라도 찾는다 (BeginPathFind())
+	uint32_t mSearchVersion = 0;		// 탐색을 시작할 때의 맵 버전
+	bool mbStartPending = false;		// 시작 노드를 아직 열지 않았다 (첫 resume()에서 연다)
+	int mSliceExpandedNodeCount = 0;
 };
\ No newline at end of file
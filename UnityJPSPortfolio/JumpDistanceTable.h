@@ -0,0 +1,351 @@
+// JPS+ 용 점프 거리 테이블
+// 셀마다 8방향 각각에 대해, 그 방향으로 JPS 탐색을 했을 때 멈추는 칸까지의 거리를 미리 계산해둡니다.
+//   양수 k : k칸 앞이 점프 포인트
+//   음수 -k : k칸 앞이 벽 (맵 바깥 포함), 즉 k - 1칸까지만 이동 가능
+// 목적지에 따라 달라지는 부분(목적지를 지나치는지)은 탐색 시점에 JPSPathFinder가 따로 확인합니다.
+// 맵이 바뀌면 OnCellChanged()로 영향을 받는 가로줄, 세로줄, 대각선만 다시 계산합니다.
+
+/************************************** 사용법 **************************************/
+// JumpDistanceTable table(grid);
+// table.Build();
+//
+// int distance = table.Get(x, y, JumpDistanceTable::RR);
+//
+// grid.SetWalkable(x, y, false);
+// table.OnCellChanged(x, y);
+/************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <vector>
+
+#include "BitGrid.h"
+
+class JumpDistanceTable
+{
+public:
+	enum EJumpDirection
+	{
+		LL,
+		RR,
+		UU,
+		DD,
+		LU,
+		LD,
+		RU,
+		RD,
+		DIRECTION_COUNT,
+	};
+
+public:
+	JumpDistanceTable(const BitGrid& grid)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+	{
+		assert(mWidth <= INT16_MAX && mHeight <= INT16_MAX);
+
+		mDistances = new int16_t[mWidth * mHeight * DIRECTION_COUNT];
+	}
+
+	// 이미 계산해둔 테이블(맵 파일의 매핑 등)을 복사 없이 그대로 사용한다 (Build() 불필요, 해제하지 않는다)
+	// 배치는 GetData()와 같아야 하고, OnCellChanged()가 고쳐도 되는 메모리여야 한다
+	JumpDistanceTable(const BitGrid& grid, int16_t* distances)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+		, mDistances(distances)
+		, mbOwnsDistances(false)
+	{
+	}
+
+	~JumpDistanceTable()
+	{
+		if (mbOwnsDistances)
+		{
+			delete[] mDistances;
+		}
+	}
+
+	JumpDistanceTable(const JumpDistanceTable& other) = delete;
+	JumpDistanceTable& operator=(const JumpDistanceTable& other) = delete;
+
+	inline size_t GetReservedBytes() const
+	{
+		return static_cast<size_t>(mWidth) * mHeight * DIRECTION_COUNT * sizeof(int16_t);
+	}
+
+	// [칸][방향] 순서의 테이블 전체 (맵 파일 저장용)
+	inline const int16_t* GetData() const { return mDistances; }
+
+	inline int Get(int x, int y, EJumpDirection direction) const
+	{
+		return mDistances[(y * mWidth + x) * DIRECTION_COUNT + direction];
+	}
+
+	// 테이블 전체를 계산한다
+	void Build()
+	{
+		for (int y = 0; y < mHeight; ++y)
+		{
+			buildRow(y);
+		}
+
+		for (int x = 0; x < mWidth; ++x)
+		{
+			buildColumn(x);
+		}
+
+		for (int sum = 0; sum <= mWidth + mHeight - 2; ++sum)
+		{
+			buildAntiDiagonal(sum);
+		}
+
+		for (int difference = -(mHeight - 1); difference <= mWidth - 1; ++difference)
+		{
+			buildDiagonal(difference);
+		}
+	}
+
+	// (x, y)의 이동 가능 여부가 바뀐 뒤 호출한다
+	// 주위 3개의 가로줄과 세로줄의 직선 거리를 다시 계산하고,
+	// 대각선 거리에 영향을 주는 칸(직선 거리의 점프 포인트 여부가 바뀐 칸, 주위 3x3 칸)을 지나는 대각선만 다시 계산한다
+	void OnCellChanged(int x, int y)
+	{
+		std::vector<bool> dirtyAntiDiagonals(mWidth + mHeight - 1, false);
+		std::vector<bool> dirtyDiagonals(mWidth + mHeight - 1, false);
+
+		auto markDirty = [&](int cellX, int cellY)
+		{
+			dirtyAntiDiagonals[cellX + cellY] = true;
+			dirtyDiagonals[cellX - cellY + mHeight - 1] = true;
+		};
+
+		for (int i = y - 1; i <= y + 1; ++i)
+		{
+			if (i < 0 || i >= mHeight)
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> before = captureJumpPoints(0, i, 1, 0, mWidth, LL, RR);
+			buildRow(i);
+			std::vector<uint8_t> after = captureJumpPoints(0, i, 1, 0, mWidth, LL, RR);
+
+			for (int j = 0; j < mWidth; ++j)
+			{
+				if (before[j] != after[j])
+				{
+					markDirty(j, i);
+				}
+			}
+		}
+
+		for (int i = x - 1; i <= x + 1; ++i)
+		{
+			if (i < 0 || i >= mWidth)
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> before = captureJumpPoints(i, 0, 0, 1, mHeight, UU, DD);
+			buildColumn(i);
+			std::vector<uint8_t> after = captureJumpPoints(i, 0, 0, 1, mHeight, UU, DD);
+
+			for (int j = 0; j < mHeight; ++j)
+			{
+				if (before[j] != after[j])
+				{
+					markDirty(i, j);
+				}
+			}
+		}
+
+		for (int i = y - 1; i <= y + 1; ++i)
+		{
+			for (int j = x - 1; j <= x + 1; ++j)
+			{
+				if (j >= 0 && j < mWidth && i >= 0 && i < mHeight)
+				{
+					markDirty(j, i);
+				}
+			}
+		}
+
+		for (int sum = 0; sum < (int)dirtyAntiDiagonals.size(); ++sum)
+		{
+			if (dirtyAntiDiagonals[sum])
+			{
+				buildAntiDiagonal(sum);
+			}
+		}
+
+		for (int index = 0; index < (int)dirtyDiagonals.size(); ++index)
+		{
+			if (dirtyDiagonals[index])
+			{
+				buildDiagonal(index - (mHeight - 1));
+			}
+		}
+	}
+
+private:
+	inline int16_t& at(int x, int y, EJumpDirection direction)
+	{
+		return mDistances[(y * mWidth + x) * DIRECTION_COUNT + direction];
+	}
+
+	inline bool isBlocked(int x, int y) const
+	{
+		if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+		{
+			return true;
+		}
+
+		return !mGrid.IsWalkable(x, y);
+	}
+
+	// 다음 칸의 거리로부터 현재 칸의 거리를 얻는다
+	inline static int16_t extend(int16_t next)
+	{
+		return next > 0 ? next + 1 : next - 1;
+	}
+
+	// (x, y)가 (dx, dy) 방향 직선 탐색의 점프 포인트인가 (JPSPathFinder의 직선 탐색과 같은 조건)
+	bool isStraightJumpPoint(int x, int y, int dx, int dy) const
+	{
+		int sideX = dy;
+		int sideY = dx;
+
+		return (isBlocked(x + sideX, y + sideY) && !isBlocked(x + sideX + dx, y + sideY + dy))
+			|| (isBlocked(x - sideX, y - sideY) && !isBlocked(x - sideX + dx, y - sideY + dy));
+	}
+
+	// (x, y)가 (dx, dy) 방향 대각선 탐색에서 강제 이웃을 가지는가 (JPSPathFinder의 대각선 탐색과 같은 조건)
+	bool hasDiagonalForcedNeighbor(int x, int y, int dx, int dy) const
+	{
+		return (isBlocked(x - dx, y) && !isBlocked(x - dx, y + dy))
+			|| (isBlocked(x, y - dy) && !isBlocked(x + dx, y - dy));
+	}
+
+	int16_t computeStraight(int x, int y, int dx, int dy, EJumpDirection direction)
+	{
+		int nextX = x + dx;
+		int nextY = y + dy;
+
+		if (isBlocked(nextX, nextY))
+		{
+			return -1;
+		}
+
+		if (isStraightJumpPoint(nextX, nextY, dx, dy))
+		{
+			return 1;
+		}
+
+		return extend(at(nextX, nextY, direction));
+	}
+
+	int16_t computeDiagonal(int x, int y, int dx, int dy, EJumpDirection direction, EJumpDirection horizontal, EJumpDirection vertical)
+	{
+		int nextX = x + dx;
+		int nextY = y + dy;
+
+		if (isBlocked(nextX, nextY))
+		{
+			return -1;
+		}
+
+		if (hasDiagonalForcedNeighbor(nextX, nextY, dx, dy) || at(nextX, nextY, horizontal) > 0 || at(nextX, nextY, vertical) > 0)
+		{
+			return 1;
+		}
+
+		return extend(at(nextX, nextY, direction));
+	}
+
+	void buildRow(int y)
+	{
+		for (int x = 0; x < mWidth; ++x)
+		{
+			at(x, y, LL) = computeStraight(x, y, -1, 0, LL);
+		}
+
+		for (int x = mWidth - 1; x >= 0; --x)
+		{
+			at(x, y, RR) = computeStraight(x, y, 1, 0, RR);
+		}
+	}
+
+	void buildColumn(int x)
+	{
+		for (int y = 0; y < mHeight; ++y)
+		{
+			at(x, y, UU) = computeStraight(x, y, 0, -1, UU);
+		}
+
+		for (int y = mHeight - 1; y >= 0; --y)
+		{
+			at(x, y, DD) = computeStraight(x, y, 0, 1, DD);
+		}
+	}
+
+	// x + y == sum 인 대각선 (RU, LD 방향)
+	void buildAntiDiagonal(int sum)
+	{
+		int minX = sum - (mHeight - 1) > 0 ? sum - (mHeight - 1) : 0;
+		int maxX = sum < mWidth - 1 ? sum : mWidth - 1;
+
+		for (int x = maxX; x >= minX; --x)
+		{
+			at(x, sum - x, RU) = computeDiagonal(x, sum - x, 1, -1, RU, RR, UU);
+		}
+
+		for (int x = minX; x <= maxX; ++x)
+		{
+			at(x, sum - x, LD) = computeDiagonal(x, sum - x, -1, 1, LD, LL, DD);
+		}
+	}
+
+	// x - y == difference 인 대각선 (LU, RD 방향)
+	void buildDiagonal(int difference)
+	{
+		int minX = difference > 0 ? difference : 0;
+		int maxX = difference + (mHeight - 1) < mWidth - 1 ? difference + (mHeight - 1) : mWidth - 1;
+
+		for (int x = minX; x <= maxX; ++x)
+		{
+			at(x, x - difference, LU) = computeDiagonal(x, x - difference, -1, -1, LU, LL, UU);
+		}
+
+		for (int x = maxX; x >= minX; --x)
+		{
+			at(x, x - difference, RD) = computeDiagonal(x, x - difference, 1, 1, RD, RR, DD);
+		}
+	}
+
+	// 한 줄의 칸들이 first, second 방향의 직선 탐색에서 점프 포인트를 찾는지 (거리가 양수인지) 기록한다
+	std::vector<uint8_t> captureJumpPoints(int x, int y, int dx, int dy, int count, EJumpDirection first, EJumpDirection second)
+	{
+		std::vector<uint8_t> result(count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			int cellX = x + dx * i;
+			int cellY = y + dy * i;
+
+			result[i] = (at(cellX, cellY, first) > 0 ? 1 : 0) | (at(cellX, cellY, second) > 0 ? 2 : 0);
+		}
+
+		return result;
+	}
+
+private:
+	const BitGrid& mGrid;
+	const int mWidth;
+	const int mHeight;
+	int16_t* mDistances;	// (y * width + x) * DIRECTION_COUNT + direction
+	bool mbOwnsDistances = true;	// 밖에서 받은 테이블이라면 false
+};
@@ -0,0 +1,377 @@
+// JPS의 후속 노드 생성기 (GridSearch의 Successors 정책)
+// 부모에서 온 방향으로 가지치기한 방향들만 점프해서, 점프 포인트(강제 이웃이 생기는 칸) 또는 목적지에만 노드를 엽니다.
+// 방향은 템플릿 인자(DX, DY)이므로 8방향이 하나의 jump<DX, DY>()로 만들어지고, 방향 별 분기는 컴파일 시간에 사라집니다.
+// USE_JUMP_TABLE이 true면 직선/대각선 점프를 JPS+ 점프 거리 테이블로, false면 BitGrid의 워드 단위 직선 탐색으로 합니다.
+// USE_GOAL_BOUNDS가 true면 점프하기 전에 노드의 그 방향 목표 경계 상자에 목적지가 없는 방향을 건너뜁니다 (JPS + GB).
+
+/************************************** 사용법 **************************************/
+// // 맵의 점프 거리 테이블이 켜져 있을 때만 USE_JUMP_TABLE, 유효한 목표 경계 상자가 있을 때만 USE_GOAL_BOUNDS가 true
+// GridSearch<JumpPointSuccessors<false>, OctileHeuristic<>> search(state, JumpPointSuccessors<false>(map), OctileHeuristic<>(endX, endY));
+// NodeIndex destination = search.Search(startX, startY, endX, endY);
+/************************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <climits>
+#include <cmath>
+
+#include "BitGrid.h"
+#include "JumpDistanceTable.h"
+#include "GoalBoundingTable.h"
+#include "PathFindMap.h"
+#include "Node.h"
+
+template <bool USE_JUMP_TABLE, bool USE_GOAL_BOUNDS = false>
+class JumpPointSuccessors
+{
+public:
+	explicit JumpPointSuccessors(const PathFindMap& map)
+		: mMap(map)
+		, mGrid(map.GetGrid())
+		, mJumpTable(map.GetJumpTable())
+		, mGoalBounds(map.GetGoalBounds())
+		, mWidth(map.GetWidth())
+		, mHeight(map.GetHeight())
+	{
+		assert((mJumpTable != nullptr) == USE_JUMP_TABLE);
+		assert(USE_GOAL_BOUNDS == false || (mGoalBounds != nullptr && mGoalBounds->IsValid()));
+	}
+
+	template <typename Search>
+	void Expand(Search& search, const ExpandedNode& node, int endX, int endY) const
+	{
+		if (node.Parent == NULL_NODE)
+		{
+			// 시작 노드인 경우
+			jump<-1, 0>(search, node, endX, endY);
+			jump<1, 0>(search, node, endX, endY);
+			jump<0, -1>(search, node, endX, endY);
+			jump<0, 1>(search, node, endX, endY);
+			jump<-1, -1>(search, node, endX, endY);
+			jump<-1, 1>(search, node, endX, endY);
+			jump<1, -1>(search, node, endX, endY);
+			jump<1, 1>(search, node, endX, endY);
+			return;
+		}
+
+		const int parentX = search.GetNodeArena().GetX(node.Parent);
+		const int parentY = search.GetNodeArena().GetY(node.Parent);
+		const int dx = (node.X > parentX) - (node.X < parentX);
+		const int dy = (node.Y > parentY) - (node.Y < parentY);
+
+		switch ((dy + 1) * 3 + (dx + 1))
+		{
+		case 5:
+			// [P] -> (N)
+			jump<1, 0>(search, node, endX, endY);
+			jump<1, -1>(search, node, endX, endY);
+			jump<1, 1>(search, node, endX, endY);
+			break;
+		case 3:
+			// (N) <- [P]
+			jump<-1, 0>(search, node, endX, endY);
+			jump<-1, 1>(search, node, endX, endY);
+			jump<-1, -1>(search, node, endX, endY);
+			break;
+		case 1:
+			// [P] 아래에서 위로
+			jump<0, -1>(search, node, endX, endY);
+			jump<-1, -1>(search, node, endX, endY);
+			jump<1, -1>(search, node, endX, endY);
+			break;
+		case 7:
+			// [P] 위에서 아래로
+			jump<0, 1>(search, node, endX, endY);
+			jump<-1, 1>(search, node, endX, endY);
+			jump<1, 1>(search, node, endX, endY);
+			break;
+		case 8:
+			expandDiagonal<1, 1>(search, node, endX, endY);
+			break;
+		case 0:
+			expandDiagonal<-1, -1>(search, node, endX, endY);
+			break;
+		case 2:
+			expandDiagonal<1, -1>(search, node, endX, endY);
+			break;
+		case 6:
+			expandDiagonal<-1, 1>(search, node, endX, endY);
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
+
+private:
+	// 대각선으로 온 노드: 진행 방향의 대각선, 가로, 세로와 강제 이웃 방향
+	// 강제 이웃 : 진행 방향의 뒤쪽 옆 칸이 막혀 있고 그 앞 칸이 열려 있다면 그쪽 대각선도 연다
+	template <int DX, int DY, typename Search>
+	inline void expandDiagonal(Search& search, const ExpandedNode& node, int endX, int endY) const
+	{
+		const int x = node.X;
+		const int y = node.Y;
+
+		const bool bForcedVertical = isBlocked(x, y - DY) && isBlocked(x + DX, y - DY) == false;		// (DX, -DY) 방향
+		const bool bForcedHorizontal = isBlocked(x - DX, y) && isBlocked(x - DX, y + DY) == false;	// (-DX, DY) 방향
+
+		// ↘, ↖ 와 ↗, ↙ 는 여는 순서가 반대 (OPEN LIST의 동점 순서를 예전 PathCheck와 같게 유지)
+		if constexpr (DX == DY)
+		{
+			if (bForcedVertical)
+			{
+				jump<DX, -DY>(search, node, endX, endY);
+			}
+
+			jump<DX, 0>(search, node, endX, endY);
+			jump<DX, DY>(search, node, endX, endY);
+			jump<0, DY>(search, node, endX, endY);
+
+			if (bForcedHorizontal)
+			{
+				jump<-DX, DY>(search, node, endX, endY);
+			}
+		}
+		else
+		{
+			if (bForcedHorizontal)
+			{
+				jump<-DX, DY>(search, node, endX, endY);
+			}
+
+			jump<0, DY>(search, node, endX, endY);
+			jump<DX, DY>(search, node, endX, endY);
+			jump<DX, 0>(search, node, endX, endY);
+
+			if (bForcedVertical)
+			{
+				jump<DX, -DY>(search, node, endX, endY);
+			}
+		}
+	}
+
+	// (DX, DY) 방향으로 점프해서 찾은 칸에 노드를 연다
+	template <int DX, int DY, typename Search>
+	inline void jump(Search& search, const ExpandedNode& node, int endX, int endY) const
+	{
+		typedef typename Search::Cost Cost;
+
+		// 이 방향으로 시작하는 최단 경로로는 목적지에 갈 수 없다
+		if constexpr (USE_GOAL_BOUNDS)
+		{
+			if (mGoalBounds->Contains(node.X, node.Y, GoalBoundingTable::GetDirection(DX, DY), endX, endY) == false)
+			{
+				return;
+			}
+		}
+
+		if constexpr (DX == 0 || DY == 0)
+		{
+			int stop = scan<DX, DY>(search, node.X + DX, node.Y + DY, endX, endY);
+
+			if (stop == NOT_FOUND)
+			{
+				return;
+			}
+
+			if constexpr (DY == 0)
+			{
+				search.Relax(stop, node.Y, node.G + abs(stop - node.X) * Cost::STRAIGHT, node.Index);
+			}
+			else
+			{
+				search.Relax(node.X, stop, node.G + abs(stop - node.Y) * Cost::STRAIGHT, node.Index);
+			}
+		}
+		else if constexpr (USE_JUMP_TABLE)
+		{
+			jumpDiagonalByTable<DX, DY>(search, node, endX, endY);
+		}
+		else
+		{
+			int x = node.X + DX;
+			int y = node.Y + DY;
+
+			while (true)
+			{
+				if (x == endX && y == endY)
+				{
+					break;
+				}
+
+				search.AddScannedCells(1);
+
+				if (isBlocked(x, y))
+				{
+					return;
+				}
+
+				bool bNewPathSide1 = isBlocked(x - DX, y) && isBlocked(x - DX, y + DY) == false;
+				bool bNewPathSide2 = isBlocked(x, y - DY) && isBlocked(x + DX, y - DY) == false;
+
+				if (bNewPathSide1 || bNewPathSide2)
+				{
+					break;
+				}
+
+				// 가로
+				if (scan<DX, 0>(search, x + DX, y, endX, endY) != NOT_FOUND)
+				{
+					break;
+				}
+
+				// 세로
+				if (scan<0, DY>(search, x, y + DY, endX, endY) != NOT_FOUND)
+				{
+					break;
+				}
+
+				x += DX;
+				y += DY;
+			}
+
+			search.Relax(x, y, node.G + abs(node.Y - y) * Cost::DIAGONAL, node.Index);
+		}
+	}
+
+	// 직선 탐색
+	// (x, y)부터 (DX, DY) 방향으로 진행하면서 점프 포인트(강제 이웃이 생기는 칸) 또는 목적지를 찾는다
+	// 찾았다면 해당 칸의 좌표(가로 탐색은 X, 세로 탐색은 Y)를, 벽에 막혔다면 NOT_FOUND를 반환한다
+	// 멈춘 칸까지 지나간 칸 수는 search의 통계에 더한다
+	template <int DX, int DY, typename Search>
+	inline int scan(Search& search, int x, int y, int endX, int endY) const
+	{
+		constexpr bool bHorizontal = DY == 0;
+		constexpr int STEP = DX + DY;
+
+		if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+		{
+			return NOT_FOUND;
+		}
+
+		const int from = bHorizontal ? x : y;
+		const int end = bHorizontal ? (y == endY ? endX : NOT_FOUND) : (x == endX ? endY : NOT_FOUND);
+
+		if constexpr (USE_JUMP_TABLE)
+		{
+			// 테이블은 한 칸 뒤에서 이 방향으로 갈 수 있는 거리를 가지고 있다
+			int distance = mJumpTable->Get(x - DX, y - DY, getJumpDirection(DX, DY));
+			int stop = from - STEP + STEP * abs(distance);
+			search.AddScannedCells(abs(distance));
+
+			return selectJumpPoint(from, stop, end, distance > 0);
+		}
+		else if constexpr (bHorizontal)
+		{
+			const uint64_t* row = mGrid.GetRow(y);
+			const uint64_t* upper = mGrid.GetRow(y - 1);
+			const uint64_t* lower = mGrid.GetRow(y + 1);
+
+			int stopX = STEP > 0
+				? BitGrid::ScanForward(row, upper, lower, mGrid.GetWordsPerRow(), x)
+				: BitGrid::ScanBackward(row, upper, lower, x);
+			search.AddScannedCells(abs(stopX - x) + 1);
+
+			return selectJumpPoint(x, stopX, end, stopX >= 0 && stopX < mWidth && mGrid.IsWalkable(stopX, y));
+		}
+		else
+		{
+			const uint64_t* column = mGrid.GetColumn(x);
+			const uint64_t* left = mGrid.GetColumn(x - 1);
+			const uint64_t* right = mGrid.GetColumn(x + 1);
+
+			int stopY = STEP > 0
+				? BitGrid::ScanForward(column, left, right, mGrid.GetWordsPerColumn(), y)
+				: BitGrid::ScanBackward(column, left, right, y);
+			search.AddScannedCells(abs(stopY - y) + 1);
+
+			return selectJumpPoint(y, stopY, end, stopY >= 0 && stopY < mHeight && mGrid.IsWalkable(x, stopY));
+		}
+	}
+
+	// 점프 거리 테이블을 이용한 대각선 탐색
+	// 테이블의 거리는 목적지를 고려하지 않으므로, 대각선 위 또는 대각선 위의 칸에서 시작하는 직선 탐색 범위 안에
+	// 목적지가 있는지를 따로 확인하고 그 중 가장 가까운 칸에 노드를 만든다
+	template <int DX, int DY, typename Search>
+	inline void jumpDiagonalByTable(Search& search, const ExpandedNode& node, int endX, int endY) const
+	{
+		int distance = mJumpTable->Get(node.X, node.Y, getJumpDirection(DX, DY));
+		int stop = abs(distance);
+		search.AddScannedCells(stop);
+
+		// 직선 탐색까지 진행하는 마지막 대각선 칸 (벽이라면 그 직전 칸)
+		int lastStep = distance > 0 ? stop : stop - 1;
+
+		// 진행 방향 기준 목적지까지의 가로, 세로 칸 수
+		int goalX = (endX - node.X) * DX;
+		int goalY = (endY - node.Y) * DY;
+
+		int step = distance > 0 ? stop : INT_MAX;
+
+		// 대각선 위의 목적지
+		if (goalX == goalY && goalX >= 1 && goalX <= lastStep && goalX < step)
+		{
+			step = goalX;
+		}
+
+		// step 번째 대각선 칸에서 시작하는 가로 방향 직선 탐색 범위 안의 목적지
+		if (goalY >= 1 && goalY <= lastStep && goalY < step && goalX - goalY >= 1)
+		{
+			if (goalX - goalY <= abs(mJumpTable->Get(node.X + DX * goalY, node.Y + DY * goalY, getJumpDirection(DX, 0))))
+			{
+				step = goalY;
+			}
+		}
+
+		// step 번째 대각선 칸에서 시작하는 세로 방향 직선 탐색 범위 안의 목적지
+		if (goalX >= 1 && goalX <= lastStep && goalX < step && goalY - goalX >= 1)
+		{
+			if (goalY - goalX <= abs(mJumpTable->Get(node.X + DX * goalX, node.Y + DY * goalX, getJumpDirection(0, DY))))
+			{
+				step = goalX;
+			}
+		}
+
+		if (step == INT_MAX)
+		{
+			return;
+		}
+
+		search.Relax(node.X + DX * step, node.Y + DY * step, node.G + step * Search::Cost::DIAGONAL, node.Index);
+	}
+
+	inline bool isBlocked(int x, int y) const { return mMap.IsBlocked(x, y); }
+
+	// from ~ stop 구간 안에 목적지가 있다면 목적지를, 아니면 stop이 점프 포인트일 때만 stop을 반환한다
+	inline static int selectJumpPoint(int from, int stop, int end, bool bStopIsJumpPoint)
+	{
+		if (end != NOT_FOUND && ((from <= end && end <= stop) || (stop <= end && end <= from)))
+		{
+			return end;
+		}
+
+		return bStopIsJumpPoint ? stop : NOT_FOUND;
+	}
+
+	inline static constexpr JumpDistanceTable::EJumpDirection getJumpDirection(int dx, int dy)
+	{
+		return dy == 0 ? (dx < 0 ? JumpDistanceTable::LL : JumpDistanceTable::RR)
+			: dx == 0 ? (dy < 0 ? JumpDistanceTable::UU : JumpDistanceTable::DD)
+			: dx < 0 ? (dy < 0 ? JumpDistanceTable::LU : JumpDistanceTable::LD)
+			: (dy < 0 ? JumpDistanceTable::RU : JumpDistanceTable::RD);
+	}
+
+	enum
+	{
+		NOT_FOUND = -1,
+	};
+
+private:
+	const PathFindMap& mMap;
+	const BitGrid& mGrid;
+	const JumpDistanceTable* mJumpTable;
+	const GoalBoundingTable* mGoalBounds;
+	const int mWidth;
+	const int mHeight;
+};
@@ -0,0 +1,329 @@
+// 랜드마크 휴리스틱 (ALT : A*, Landmarks, Triangle inequality)
+// 랜드마크 K개에서 모든 칸까지의 실제 경로 비용을 미리 계산해두고, 탐색 중에는 삼각 부등식
+//   cost(n, goal) >= |dist(L, goal) - dist(L, n)|
+// 의 최댓값을 휴리스틱으로 씁니다. 벽을 돌아가야 하는 미로형 맵에서 옥타일 거리보다 훨씬 정확해서 확장 노드 수가 줄어듭니다.
+// 랜드마크는 가장 큰 연결 요소에서 맵 중심 기준 K개의 방향으로 가장 바깥에 있는 칸을 고르고, 거리표는 랜드마크마다 스레드를 나눠 만듭니다.
+// 거리는 칸마다 K개를 이어서 uint16으로 저장하고 (칸 하나의 K개 값이 한 캐시 라인에 모이도록), 넘치는 거리는 MAX_DISTANCE로 자릅니다.
+// (자른 거리의 차이도 실제 거리의 차이보다 작거나 같으므로 휴리스틱은 계속 일관적이다)
+// 맵이 바뀌면 거리표가 틀리므로 Invalidate() 이후로는 쓰지 않고, Build()를 다시 해야 합니다 (PathFindMap::RefreshLandmarks()).
+
+/************************************** 사용법 **************************************/
+// LandmarkTable landmarks(grid);
+// landmarks.Build(landmarkCount, threadCount);
+//
+// // 쿼리마다 목적지의 거리들을 한 번 얻어두고
+// const uint16_t* goalDistances = landmarks.GetDistances(endX, endY);
+//
+// // 노드마다
+// int h = landmarks.GetHeuristic(goalDistances, x, y);
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+
+#include "Point.h"
+#include "BitGrid.h"
+#include "GridDijkstra.h"
+
+class LandmarkTable
+{
+public:
+	LandmarkTable(const BitGrid& grid)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+	{
+	}
+
+	// 이미 만들어둔 거리표(맵 파일의 매핑 등)를 복사 없이 그대로 사용한다 (Build() 불필요, 해제하지 않는다)
+	// 배치는 GetDistances(0, 0)부터의 [칸][랜드마크] 배열과 같아야 하고, 다시 Build()할 때 고쳐도 되는 메모리여야 한다
+	LandmarkTable(const BitGrid& grid, const Point* landmarks, int landmarkCount, uint16_t* distances)
+		: mGrid(grid)
+		, mWidth(grid.GetWidth())
+		, mHeight(grid.GetHeight())
+		, mLandmarks(landmarks, landmarks + landmarkCount)
+		, mLandmarkCount(landmarkCount)
+		, mDistances(distances)
+		, mbOwnsDistances(false)
+		, mbValid(landmarkCount > 0)
+	{
+	}
+
+	~LandmarkTable()
+	{
+		if (mbOwnsDistances)
+		{
+			delete[] mDistances;
+		}
+	}
+
+	LandmarkTable(const LandmarkTable& other) = delete;
+	LandmarkTable& operator=(const LandmarkTable& other) = delete;
+
+	// 랜드마크 landmarkCount 개를 고르고 거리표를 만든다 (threadCount 개의 스레드로 랜드마크를 나눠서)
+	// 이동 가능한 칸이 랜드마크 수보다 적다면 그만큼만 고른다
+	void Build(int landmarkCount, int threadCount)
+	{
+		selectLandmarks(landmarkCount);
+
+		const int count = static_cast<int>(mLandmarks.size());
+
+		if (mLandmarkCount != count)
+		{
+			if (mbOwnsDistances)
+			{
+				delete[] mDistances;
+			}
+
+			mDistances = count > 0 ? new uint16_t[static_cast<size_t>(mWidth) * mHeight * count] : nullptr;
+			mbOwnsDistances = true;
+			mLandmarkCount = count;
+		}
+
+		threadCount = threadCount < count ? threadCount : count;
+		threadCount = threadCount > 1 ? threadCount : 1;
+
+		std::vector<std::thread> threads;
+
+		for (int i = 1; i < threadCount; ++i)
+		{
+			threads.emplace_back(&LandmarkTable::buildLandmarks, this, i, threadCount);
+		}
+
+		// 첫 몫은 호출한 스레드가 맡는다
+		buildLandmarks(0, threadCount);
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		mbValid = count > 0;
+	}
+
+	// 맵이 바뀌었다 (다시 Build()하기 전까지 IsValid()가 false)
+	inline void Invalidate() { mbValid = false; }
+	inline bool IsValid() const { return mbValid; }
+
+	inline int GetLandmarkCount() const { return mLandmarkCount; }
+	inline const Point& GetLandmark(int index) const { return mLandmarks[index]; }
+
+	// (x, y)에 대한 랜드마크별 거리 (GetLandmarkCount() 개, 닿을 수 없다면 UNREACHABLE)
+	inline const uint16_t* GetDistances(int x, int y) const
+	{
+		return mDistances + (static_cast<size_t>(y) * mWidth + x) * mLandmarkCount;
+	}
+
+	// (x, y)에서 목적지까지 비용의 하한 (goalDistances는 목적지의 GetDistances())
+	inline int GetHeuristic(const uint16_t* goalDistances, int x, int y) const
+	{
+		const uint16_t* distances = GetDistances(x, y);
+		int h = 0;
+
+		for (int i = 0; i < mLandmarkCount; ++i)
+		{
+			// 랜드마크와 다른 연결 요소라면 알 수 있는 것이 없다
+			if (distances[i] == UNREACHABLE || goalDistances[i] == UNREACHABLE)
+			{
+				continue;
+			}
+
+			int difference = distances[i] > goalDistances[i] ? distances[i] - goalDistances[i] : goalDistances[i] - distances[i];
+			h = difference > h ? difference : h;
+		}
+
+		return h;
+	}
+
+	// 맵 크기에 대해 memoryBudgetBytes 안에 들어가는 최대 랜드마크 수
+	inline static int GetMaxLandmarkCount(int width, int height, size_t memoryBudgetBytes)
+	{
+		size_t count = memoryBudgetBytes / (static_cast<size_t>(width) * height * sizeof(uint16_t));
+		return count < static_cast<size_t>(INT_MAX) ? static_cast<int>(count) : INT_MAX;
+	}
+
+	// 거리표의 크기 (byte)
+	inline size_t GetReservedBytes() const
+	{
+		return static_cast<size_t>(mWidth) * mHeight * mLandmarkCount * sizeof(uint16_t);
+	}
+
+	enum : uint16_t
+	{
+		MAX_DISTANCE = 0xFFFE,			// 이보다 먼 거리는 잘라서 저장한다
+		UNREACHABLE = 0xFFFF,
+	};
+
+private:
+	// 가장 큰 연결 요소의 칸 중, 맵 중심에서 K개의 방향 각각으로 가장 멀리 나간 칸을 고른다
+	// (서로 멀리 떨어진 가장자리의 랜드마크일수록 그 너머의 목적지에 대해 정확한 하한을 준다)
+	void selectLandmarks(int landmarkCount)
+	{
+		mLandmarks.clear();
+
+		std::vector<int> largestCells;
+		findLargestComponent(largestCells);
+
+		const double centerX = (mWidth - 1) / 2.0;
+		const double centerY = (mHeight - 1) / 2.0;
+		const double PI = 3.14159265358979323846;
+
+		for (int i = 0; i < landmarkCount && i < static_cast<int>(largestCells.size()); ++i)
+		{
+			double angle = 2.0 * PI * i / landmarkCount;
+			double directionX = std::cos(angle);
+			double directionY = std::sin(angle);
+
+			int bestCell = -1;
+			double bestScore = 0.0;
+
+			for (int cell : largestCells)
+			{
+				int x = cell % mWidth;
+				int y = cell / mWidth;
+
+				if (isLandmark(x, y))
+				{
+					continue;
+				}
+
+				double score = (x - centerX) * directionX + (y - centerY) * directionY;
+
+				if (bestCell == -1 || score > bestScore)
+				{
+					bestCell = cell;
+					bestScore = score;
+				}
+			}
+
+			mLandmarks.push_back(Point{ bestCell % mWidth, bestCell / mWidth });
+		}
+	}
+
+	inline bool isLandmark(int x, int y) const
+	{
+		for (const Point& landmark : mLandmarks)
+		{
+			if (landmark.X == x && landmark.Y == y)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// 8방향 기준 가장 큰 연결 요소의 칸들
+	void findLargestComponent(std::vector<int>& outCells) const
+	{
+		std::vector<bool> visited(static_cast<size_t>(mWidth) * mHeight, false);
+		std::vector<int> cells;
+
+		for (int start = 0; start < mWidth * mHeight; ++start)
+		{
+			if (visited[start] || mGrid.IsWalkable(start % mWidth, start / mWidth) == false)
+			{
+				continue;
+			}
+
+			// cells를 큐 겸 결과로 쓴다 (앞에서부터 꺼내며 뒤에 붙인다)
+			cells.clear();
+			cells.push_back(start);
+			visited[start] = true;
+
+			for (size_t i = 0; i < cells.size(); ++i)
+			{
+				int x = cells[i] % mWidth;
+				int y = cells[i] / mWidth;
+
+				for (int direction = 0; direction < GridDirection::COUNT; ++direction)
+				{
+					int nextX = x + GridDirection::X[direction];
+					int nextY = y + GridDirection::Y[direction];
+
+					if (nextX < 0 || nextX >= mWidth || nextY < 0 || nextY >= mHeight)
+					{
+						continue;
+					}
+
+					int next = nextY * mWidth + nextX;
+
+					if (visited[next] == false && mGrid.IsWalkable(nextX, nextY))
+					{
+						visited[next] = true;
+						cells.push_back(next);
+					}
+				}
+			}
+
+			if (cells.size() > outCells.size())
+			{
+				outCells.swap(cells);
+			}
+		}
+	}
+
+	// threadIndex 번째 스레드는 threadIndex, threadIndex + threadCount, ... 번째 랜드마크를 맡는다
+	void buildLandmarks(int threadIndex, int threadCount)
+	{
+		const int stride = mWidth + 2;
+		std::vector<int> distances(static_cast<size_t>(stride) * (mHeight + 2));
+		GridDijkstra dijkstra(stride);
+
+		for (int landmark = threadIndex; landmark < mLandmarkCount; landmark += threadCount)
+		{
+			computeDistances(mLandmarks[landmark], dijkstra, distances);
+
+			for (int y = 0; y < mHeight; ++y)
+			{
+				for (int x = 0; x < mWidth; ++x)
+				{
+					int distance = distances[(y + 1) * stride + (x + 1)];
+					uint16_t value = distance < 0 ? static_cast<uint16_t>(UNREACHABLE)
+						: static_cast<uint16_t>(distance < MAX_DISTANCE ? distance : MAX_DISTANCE);
+
+					mDistances[(static_cast<size_t>(y) * mWidth + x) * mLandmarkCount + landmark] = value;
+				}
+			}
+		}
+	}
+
+	// source에서 모든 칸까지의 경로 비용 (한 칸씩 넓힌 배열, 닿을 수 없거나 막힌 칸은 음수)
+	void computeDistances(const Point& source, GridDijkstra& dijkstra, std::vector<int>& outDistances) const
+	{
+		const int stride = mWidth + 2;
+
+		std::fill(outDistances.begin(), outDistances.end(), static_cast<int>(GridDijkstra::BLOCKED));
+
+		for (int y = 0; y < mHeight; ++y)
+		{
+			for (int x = 0; x < mWidth; ++x)
+			{
+				if (mGrid.IsWalkable(x, y))
+				{
+					outDistances[(y + 1) * stride + (x + 1)] = GridDijkstra::NOT_VISITED;
+				}
+			}
+		}
+
+		dijkstra.Push(outDistances.data(), (source.Y + 1) * stride + (source.X + 1), 0);
+		dijkstra.Run(outDistances.data());
+	}
+
+private:
+	const BitGrid& mGrid;
+	const int mWidth;
+	const int mHeight;
+
+	std::vector<Point> mLandmarks;
+	int mLandmarkCount = 0;
+	uint16_t* mDistances = nullptr;		// [칸][랜드마크]
+	bool mbOwnsDistances = true;		// 밖에서 받은 거리표라면 false (다시 Build()해서 크기가 바뀌면 새로 할당한다)
+	bool mbValid = false;
+};
@@ -1,5 +1,6 @@
 // 시작점부터 끝점까지의 직선을 구성하는 좌표들을 얻어낼 수 있습니다.
 // 브레젠험 직선 알고리듬을 기반으로 작성되었습니다.
+// 모든 좌표를 목록으로 만들어 두므로 디버깅, 시각화 용도로만 사용합니다 (길찾기의 직선 검사는 LineOfSight 사용).
 
 /************************************** 사용법 **************************************/
 // Line line(startX, startY, endX, endY);
@@ -0,0 +1,153 @@
+// 두 칸 사이의 직선 위에 막힌 칸이 없는지 검사합니다 (경로 다듬기용).
+// Line과 똑같은 브레젠험 칸들을 검사하지만, 좌표를 저장하지 않고 처음 막힌 칸에서 바로 끝냅니다.
+// BitGrid 버전은 같은 가로줄(세로로 긴 직선은 같은 세로줄)에 연속으로 놓인 칸들을 한 구간으로 묶어 워드 단위로 검사합니다.
+
+/************************************** 사용법 **************************************/
+// // 비트 맵
+// bool bClear = LineOfSight::IsClear(grid, startX, startY, endX, endY);
+//
+// // 그 외의 맵 (isWalkable(x, y)가 이동 가능 여부를 반환)
+// bool bClear = LineOfSight::IsClear(startX, startY, endX, endY, [&](int x, int y) { return map[y][x]; });
+/************************************************************************************/
+
+#pragma once
+
+#include "BitGrid.h"
+
+class LineOfSight final
+{
+public:
+	LineOfSight() = delete;
+
+	// 범위 검사를 하지 않으므로 맵 안의 좌표만 넣어야 한다
+	static bool IsClear(const BitGrid& grid, int startX, int startY, int endX, int endY)
+	{
+		const int deltaX = startX > endX ? startX - endX : endX - startX;
+		const int deltaY = startY > endY ? startY - endY : endY - startY;
+
+		const int relativeX = endX > startX ? 1 : -1;
+		const int relativeY = endY > startY ? 1 : -1;
+
+		// 대각선에 가까워 구간이 대부분 1칸이면 워드로 묶는 이득이 없으므로 한 칸씩 검사한다
+		const int longDelta = deltaX >= deltaY ? deltaX : deltaY;
+		const int shortDelta = deltaX >= deltaY ? deltaY : deltaX;
+
+		if (longDelta + 1 < (shortDelta + 1) * 2)
+		{
+			return IsClear(startX, startY, endX, endY, [&grid](int x, int y) { return grid.IsWalkable(x, y); });
+		}
+
+		if (deltaX >= deltaY)
+		{
+			return isRunsClear(grid, true, startX, startY, relativeX, relativeY, deltaX, deltaY);
+		}
+		else
+		{
+			return isRunsClear(grid, false, startY, startX, relativeY, relativeX, deltaY, deltaX);
+		}
+	}
+
+	// 한 칸씩 검사하는 버전 (isWalkable(x, y) -> bool)
+	template <typename IsWalkable>
+	static bool IsClear(int startX, int startY, int endX, int endY, IsWalkable isWalkable)
+	{
+		const int deltaX = startX > endX ? startX - endX : endX - startX;
+		const int deltaY = startY > endY ? startY - endY : endY - startY;
+
+		const int relativeX = endX > startX ? 1 : -1;
+		const int relativeY = endY > startY ? 1 : -1;
+
+		if (isWalkable(startX, startY) == false)
+		{
+			return false;
+		}
+
+		if (deltaX >= deltaY)
+		{
+			int yCarry = 0;
+			int ySum = 0;
+
+			for (int i = 1; i < deltaX; ++i)
+			{
+				ySum += deltaY + 1;
+
+				if (ySum >= deltaX + 1)
+				{
+					ySum -= deltaX + 1;
+					yCarry++;
+				}
+
+				if (isWalkable(startX + relativeX * i, startY + relativeY * yCarry) == false)
+				{
+					return false;
+				}
+			}
+		}
+		else
+		{
+			int xCarry = 0;
+			int xSum = 0;
+
+			for (int i = 1; i < deltaY; ++i)
+			{
+				xSum += deltaX + 1;
+
+				if (xSum >= deltaY + 1)
+				{
+					xSum -= deltaY + 1;
+					xCarry++;
+				}
+
+				if (isWalkable(startX + relativeX * xCarry, startY + relativeY * i) == false)
+				{
+					return false;
+				}
+			}
+		}
+
+		return isWalkable(endX, endY);
+	}
+
+private:
+	// Line의 i번째 칸은 짧은 축으로 (i * (shortDelta + 1)) / (longDelta + 1) 칸 올라가 있으므로,
+	// 올라간 칸 수가 carry인 칸들은 긴 축 방향으로 한 줄에 이어진 구간이 된다 (구간 길이는 quotient 또는 quotient + 1)
+	// bRowMajor : 긴 축이 x축이면 true (구간을 가로줄에서 검사), y축이면 false (세로줄에서 검사)
+	static bool isRunsClear(const BitGrid& grid, bool bRowMajor, int longStart, int shortStart, int longRelative, int shortRelative, int longDelta, int shortDelta)
+	{
+		const int quotient = (longDelta + 1) / (shortDelta + 1);
+		const int remainder = (longDelta + 1) % (shortDelta + 1);
+
+		// runBegin(carry) = ceil(carry * (longDelta + 1) / (shortDelta + 1)) 를 나눗셈 없이 누적한다
+		int runBegin = 0;
+		int extraSum = shortDelta;
+
+		for (int carry = 0; carry <= shortDelta; ++carry)
+		{
+			int nextRunBegin = runBegin + quotient;
+			extraSum += remainder;
+
+			if (extraSum >= shortDelta + 1)
+			{
+				extraSum -= shortDelta + 1;
+				nextRunBegin++;
+			}
+
+			const int runEnd = nextRunBegin - 1 < longDelta ? nextRunBegin - 1 : longDelta;
+
+			const int from = longStart + longRelative * (longRelative > 0 ? runBegin : runEnd);
+			const int to = longStart + longRelative * (longRelative > 0 ? runEnd : runBegin);
+			const int lineIndex = shortStart + shortRelative * carry;
+
+			const uint64_t* line = bRowMajor ? grid.GetRow(lineIndex) : grid.GetColumn(lineIndex);
+
+			if (BitGrid::IsRangeWalkable(line, from, to) == false)
+			{
+				return false;
+			}
+
+			runBegin = nextRunBegin;
+		}
+
+		return true;
+	}
+};
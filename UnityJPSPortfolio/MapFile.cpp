@@ -0,0 +1,424 @@
+#include "MapFile.h"
+#include "PathFindMap.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static FILE* openFile(const char* fileName, const char* mode)
+{
+#ifdef _WIN32
+	FILE* file = nullptr;
+	return fopen_s(&file, fileName, mode) == 0 ? file : nullptr;
+#else
+	return fopen(fileName, mode);
+#endif
+}
+
+// 파일의 크기와 마지막 수정 시각 (파일이 없다면 false)
+static bool getFileStamp(const char* fileName, uint64_t& outBytes, uint64_t& outWriteTime)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+	if (::GetFileAttributesExA(fileName, GetFileExInfoStandard, &attributes) == FALSE)
+	{
+		return false;
+	}
+
+	outBytes = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+	outWriteTime = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+#else
+	struct stat fileStat;
+
+	if (::stat(fileName, &fileStat) != 0)
+	{
+		return false;
+	}
+
+	outBytes = static_cast<uint64_t>(fileStat.st_size);
+	outWriteTime = static_cast<uint64_t>(fileStat.st_mtime);
+#endif
+
+	return true;
+}
+
+static size_t alignSection(size_t offset)
+{
+	return (offset + MapFile::SECTION_ALIGNMENT - 1) / MapFile::SECTION_ALIGNMENT * MapFile::SECTION_ALIGNMENT;
+}
+
+bool MapFile::Open(const char* fileName)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = ::CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (::GetFileSizeEx(file, &fileSize) == FALSE || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header)))
+	{
+		::CloseHandle(file);
+		return false;
+	}
+
+	// 쓰기 시 복사 : 고치지 않은 페이지는 같은 파일을 연 프로세스들이 공유한다
+	HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	::CloseHandle(file);
+
+	if (mapping == nullptr)
+	{
+		return false;
+	}
+
+	// 뷰가 매핑을 붙잡고 있으므로 핸들은 바로 닫는다
+	mView = ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	::CloseHandle(mapping);
+
+	if (mView == nullptr)
+	{
+		return false;
+	}
+
+	mViewBytes = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int file = ::open(fileName, O_RDONLY);
+
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+
+	if (::fstat(file, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(Header)))
+	{
+		::close(file);
+		return false;
+	}
+
+	void* view = ::mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	::close(file);
+
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	mView = view;
+	mViewBytes = static_cast<size_t>(fileStat.st_size);
+#endif
+
+	const Header& header = GetHeader();
+
+	bool bValid = header.Magic == MAGIC && header.Version == VERSION
+		&& header.Width > 0 && header.Height > 0
+		&& header.WordsPerRow == (header.Width + 63) / 64 && header.WordsPerColumn == (header.Height + 63) / 64
+		&& header.ComponentLabelCount >= 0 && header.LandmarkCount >= 0
+		&& header.FileSize == mViewBytes
+		&& header.SectionOffsets[Rows] != 0 && header.SectionOffsets[Columns] != 0;
+
+	// 연결 요소와 랜드마크는 관련 구간이 모두 있거나 모두 없어야 한다
+	bValid = bValid
+		&& (header.SectionOffsets[ComponentLabels] != 0) == (header.SectionOffsets[ComponentParents] != 0)
+		&& (header.SectionOffsets[ComponentLabels] != 0) == (header.SectionOffsets[ComponentCellCounts] != 0)
+		&& (header.SectionOffsets[LandmarkPoints] != 0) == (header.SectionOffsets[LandmarkDistances] != 0)
+		&& (header.SectionOffsets[LandmarkPoints] != 0) == (header.LandmarkCount > 0);
+
+	for (int section = 0; bValid && section < SECTION_COUNT; ++section)
+	{
+		uint64_t offset = header.SectionOffsets[section];
+
+		if (offset == 0)
+		{
+			continue;
+		}
+
+		bValid = offset % SECTION_ALIGNMENT == 0 && offset >= sizeof(Header)
+			&& offset + GetSectionBytes(header, static_cast<ESection>(section)) <= mViewBytes;
+	}
+
+	if (bValid == false)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void MapFile::Close()
+{
+	if (mView == nullptr)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	::UnmapViewOfFile(mView);
+#else
+	::munmap(mView, mViewBytes);
+#endif
+
+	mView = nullptr;
+	mViewBytes = 0;
+}
+
+bool MapFile::IsOutdated(const char* textFileName) const
+{
+	const Header& header = GetHeader();
+	uint64_t bytes;
+	uint64_t writeTime;
+
+	if (header.SourceFileSize == 0 || getFileStamp(textFileName, bytes, writeTime) == false)
+	{
+		return false;
+	}
+
+	return bytes != header.SourceFileSize || writeTime != header.SourceWriteTime;
+}
+
+size_t MapFile::GetSectionBytes(const Header& header, ESection section)
+{
+	const size_t cellCount = static_cast<size_t>(header.Width) * header.Height;
+
+	switch (section)
+	{
+	case Rows:
+		return static_cast<size_t>(header.Height + 2) * header.WordsPerRow * sizeof(uint64_t);
+	case Columns:
+		return static_cast<size_t>(header.Width + 2) * header.WordsPerColumn * sizeof(uint64_t);
+	case JumpTable:
+		return cellCount * JumpDistanceTable::DIRECTION_COUNT * sizeof(int16_t);
+	case ComponentLabels:
+		return cellCount * sizeof(uint32_t);
+	case ComponentParents:
+	case ComponentCellCounts:
+		return static_cast<size_t>(header.ComponentLabelCount) * sizeof(uint32_t);
+	case LandmarkPoints:
+		return static_cast<size_t>(header.LandmarkCount) * sizeof(Point);
+	case LandmarkDistances:
+		return cellCount * header.LandmarkCount * sizeof(uint16_t);
+	case GoalBounds:
+		return cellCount * GoalBoundingTable::DIRECTION_COUNT * sizeof(GoalBoundingTable::Bounds);
+	default:
+		return 0;
+	}
+}
+
+bool MapFile::Save(const PathFindMap& map, const char* fileName, const char* sourceFileName)
+{
+	const BitGrid& grid = map.GetGrid();
+	const JumpDistanceTable* jumpTable = map.GetJumpTable();
+	const ConnectedComponents* components = map.GetComponents();
+	const LandmarkTable* landmarks = map.GetLandmarks();
+	const GoalBoundingTable* goalBounds = map.GetGoalBounds();
+
+	if (components != nullptr && (components->IsDirty() || components->GetLabelCount() == 0))
+	{
+		components = nullptr;
+	}
+
+	if (landmarks != nullptr && (landmarks->IsValid() == false || landmarks->GetLandmarkCount() == 0))
+	{
+		landmarks = nullptr;
+	}
+
+	if (goalBounds != nullptr && goalBounds->IsValid() == false)
+	{
+		goalBounds = nullptr;
+	}
+
+	Header header{};
+	header.Magic = MAGIC;
+	header.Version = VERSION;
+	header.Width = map.GetWidth();
+	header.Height = map.GetHeight();
+	header.WordsPerRow = grid.GetWordsPerRow();
+	header.WordsPerColumn = grid.GetWordsPerColumn();
+	header.ComponentLabelCount = components != nullptr ? components->GetLabelCount() : 0;
+	header.LandmarkCount = landmarks != nullptr ? landmarks->GetLandmarkCount() : 0;
+
+	if (sourceFileName != nullptr && getFileStamp(sourceFileName, header.SourceFileSize, header.SourceWriteTime) == false)
+	{
+		return false;
+	}
+
+	std::vector<Point> landmarkPoints(header.LandmarkCount);
+
+	for (int i = 0; i < header.LandmarkCount; ++i)
+	{
+		landmarkPoints[i] = landmarks->GetLandmark(i);
+	}
+
+	// 구간 별 저장할 데이터 (없는 구간은 nullptr)
+	const void* datas[SECTION_COUNT] = {};
+	datas[Rows] = grid.GetRow(-1);
+	datas[Columns] = grid.GetColumn(-1);
+	datas[JumpTable] = jumpTable != nullptr ? jumpTable->GetData() : nullptr;
+	datas[ComponentLabels] = components != nullptr ? components->GetLabels() : nullptr;
+	datas[ComponentParents] = components != nullptr ? components->GetParents() : nullptr;
+	datas[ComponentCellCounts] = components != nullptr ? components->GetCellCounts() : nullptr;
+	datas[LandmarkPoints] = landmarks != nullptr ? landmarkPoints.data() : nullptr;
+	datas[LandmarkDistances] = landmarks != nullptr ? landmarks->GetDistances(0, 0) : nullptr;
+	datas[GoalBounds] = goalBounds != nullptr ? goalBounds->GetData() : nullptr;
+
+	size_t offset = alignSection(sizeof(Header));
+
+	for (int section = 0; section < SECTION_COUNT; ++section)
+	{
+		if (datas[section] == nullptr)
+		{
+			continue;
+		}
+
+		header.SectionOffsets[section] = offset;
+		offset = alignSection(offset + GetSectionBytes(header, static_cast<ESection>(section)));
+	}
+
+	header.FileSize = offset;
+
+	FILE* file = openFile(fileName, "wb");
+
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	static const uint8_t PADDING[SECTION_ALIGNMENT] = {};
+
+	bool bWritten = fwrite(&header, sizeof(header), 1, file) == 1;
+	size_t written = sizeof(header);
+
+	for (int section = 0; bWritten && section < SECTION_COUNT; ++section)
+	{
+		if (datas[section] == nullptr)
+		{
+			continue;
+		}
+
+		size_t bytes = GetSectionBytes(header, static_cast<ESection>(section));
+
+		bWritten = fwrite(PADDING, 1, header.SectionOffsets[section] - written, file) == header.SectionOffsets[section] - written
+			&& (bytes == 0 || fwrite(datas[section], bytes, 1, file) == 1);
+
+		written = header.SectionOffsets[section] + bytes;
+	}
+
+	bWritten = bWritten && fwrite(PADDING, 1, header.FileSize - written, file) == header.FileSize - written;
+
+	return fclose(file) == 0 && bWritten;
+}
+
+bool MapFile::ReadText(const char* fileName, PathFindMap& outMap)
+{
+	FILE* file = openFile(fileName, "rb");
+
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// fscanf를 줄마다 부르지 않고 한 번에 읽어서 직접 숫자를 자른다
+	std::vector<char> text;
+	char buffer[64 * 1024];
+	size_t readBytes;
+
+	while ((readBytes = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		text.insert(text.end(), buffer, buffer + readBytes);
+	}
+
+	fclose(file);
+
+	int numbers[2];
+	int numberCount = 0;
+	size_t i = 0;
+
+	while (i < text.size())
+	{
+		if (text[i] < '0' || text[i] > '9')
+		{
+			// 음수는 맵 밖이다
+			if (text[i] == '-')
+			{
+				return false;
+			}
+
+			i++;
+			continue;
+		}
+
+		int number = 0;
+
+		while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+		{
+			number = number * 10 + (text[i] - '0');
+			i++;
+
+			if (number > outMap.GetWidth() && number > outMap.GetHeight())
+			{
+				return false;
+			}
+		}
+
+		numbers[numberCount++] = number;
+
+		if (numberCount == 2)
+		{
+			if (numbers[0] >= outMap.GetWidth() || numbers[1] >= outMap.GetHeight())
+			{
+				return false;
+			}
+
+			outMap.Block(numbers[0], numbers[1]);
+			numberCount = 0;
+		}
+	}
+
+	return true;
+}
+
+bool MapFile::ConvertText(const char* textFileName, int width, int height, const char* fileName, bool bJumpTable, int landmarkCount, bool bGoalBounds, int threadCount)
+{
+	PathFindMap map(width, height);
+
+	if (ReadText(textFileName, map) == false)
+	{
+		return false;
+	}
+
+	map.EnableComponents();
+
+	if (bJumpTable)
+	{
+		map.EnableJumpTable();
+	}
+
+	if (landmarkCount > 0)
+	{
+		map.EnableLandmarks(landmarkCount, SIZE_MAX, threadCount);
+	}
+
+	if (bGoalBounds)
+	{
+		map.EnableGoalBounds(threadCount);
+	}
+
+	return Save(map, fileName, textFileName);
+}
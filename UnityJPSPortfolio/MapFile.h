@@ -0,0 +1,115 @@
+// 바이너리 맵 파일 (map.txt를 대신하는 빠른 로딩용 형식)
+// 헤더 뒤에 BitGrid의 가로줄/세로줄 워드 배열이 메모리에 있는 그대로 들어 있고,
+// 선택적으로 JPS+ 점프 거리 테이블, 연결 요소 번호, 랜드마크 거리표, 목표 경계 상자를 미리 계산해서 담을 수 있습니다.
+// Open()은 파일을 쓰기 시 복사(copy-on-write)로 메모리에 매핑만 하고, PathFindMap::Load()는 매핑된 구간들을 복사 없이 그대로 씁니다.
+// 따라서 로딩은 맵 크기와 상관없이 거의 즉시 끝나고, 같은 파일을 연 여러 서버 프로세스는 고치지 않은 페이지를 물리 메모리에서 공유합니다.
+// (ChangeCells() 등으로 고친 페이지만 그 프로세스의 사본이 되며, 파일에는 쓰지 않는다)
+//
+// 파일 구성 (모든 구간은 SECTION_ALIGNMENT 바이트 단위로 정렬)
+// Header | Rows | Columns | [JumpTable] | [ComponentLabels | ComponentParents | ComponentCellCounts] | [LandmarkPoints | LandmarkDistances] | [GoalBounds]
+
+/************************************** 사용법 **************************************/
+// // 변환 (map.txt의 "x y" 줄마다 막힌 칸 하나)
+// MapFile::ConvertText("map.txt", 200, 200, "map.bin", false, landmarkCount, false, threadCount);
+//
+// // 로딩 (mapFile은 map보다 오래 열려 있어야 한다)
+// MapFile mapFile;
+// if (mapFile.Open("map.bin") == false || mapFile.IsOutdated("map.txt"))
+// {
+//     mapFile.Close();
+//     // 다시 변환
+// }
+// map.Load(mapFile, threadCount);
+/************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class PathFindMap;
+
+class MapFile
+{
+public:
+	enum ESection
+	{
+		Rows,					// uint64_t[(height + 2) * wordsPerRow]
+		Columns,				// uint64_t[(width + 2) * wordsPerColumn]
+		JumpTable,				// int16_t[width * height * 8]
+		ComponentLabels,		// uint32_t[width * height]
+		ComponentParents,		// uint32_t[componentLabelCount]
+		ComponentCellCounts,	// uint32_t[componentLabelCount]
+		LandmarkPoints,			// Point[landmarkCount]
+		LandmarkDistances,		// uint16_t[width * height * landmarkCount]
+		GoalBounds,				// GoalBoundingTable::Bounds[width * height * 8]
+		SECTION_COUNT,
+	};
+
+	struct Header
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		int32_t Width;
+		int32_t Height;
+		int32_t WordsPerRow;
+		int32_t WordsPerColumn;
+		int32_t ComponentLabelCount;				// 연결 요소 구간이 없다면 0
+		int32_t LandmarkCount;						// 랜드마크 구간이 없다면 0
+		uint64_t SectionOffsets[SECTION_COUNT];		// 파일 처음부터의 위치, 없는 구간은 0
+		uint64_t FileSize;
+		uint64_t SourceFileSize;					// 변환한 텍스트 맵의 크기 (텍스트 맵 없이 저장했다면 0)
+		uint64_t SourceWriteTime;					// 변환한 텍스트 맵의 마지막 수정 시각 (운영체제의 파일 시각 그대로)
+	};
+
+	enum
+	{
+		MAGIC = 0x4D53504A,			// "JPSM"
+		VERSION = 3,			// 2 : GoalBounds 구간 추가, 3 : 텍스트 맵의 크기와 수정 시각 추가
+		SECTION_ALIGNMENT = 64,
+	};
+
+public:
+	MapFile() = default;
+	~MapFile() { Close(); }
+
+	MapFile(const MapFile& other) = delete;
+	MapFile& operator=(const MapFile& other) = delete;
+
+	// 파일을 매핑하고 헤더와 구간 크기를 검사한다 (형식이 맞지 않다면 false)
+	bool Open(const char* fileName);
+	void Close();
+
+	inline bool IsOpen() const { return mView != nullptr; }
+	inline const Header& GetHeader() const { return *static_cast<const Header*>(mView); }
+
+	// 변환한 뒤 텍스트 맵이 바뀌었는가 (크기나 수정 시각이 다르면 true)
+	// 텍스트 맵이 없거나 텍스트 맵 없이 저장한 파일이라면 비교할 수 없으므로 false
+	bool IsOutdated(const char* textFileName) const;
+
+	// 구간의 시작 주소 (없는 구간은 nullptr)
+	// 쓰기 시 복사 매핑이므로 고쳐도 파일과 다른 프로세스에는 보이지 않는다
+	inline void* GetSection(ESection section) const
+	{
+		uint64_t offset = GetHeader().SectionOffsets[section];
+		return offset != 0 ? static_cast<uint8_t*>(mView) + offset : nullptr;
+	}
+
+	// 구간의 크기 (byte)
+	static size_t GetSectionBytes(const Header& header, ESection section);
+
+	// map의 이동 가능 여부와 켜져 있는 테이블들을 저장한다
+	// 연결 요소는 나뉘었을 수 있음으로 표시된 것이 없을 때만, 랜드마크 거리표와 목표 경계 상자는 유효할 때만 저장한다
+	// sourceFileName을 주면 그 파일의 크기와 수정 시각을 헤더에 기록한다 (IsOutdated())
+	static bool Save(const PathFindMap& map, const char* fileName, const char* sourceFileName = nullptr);
+
+	// 텍스트 맵("x y" 마다 막힌 칸 하나)을 outMap에 읽는다 (맵 밖의 좌표가 있다면 false)
+	static bool ReadText(const char* fileName, PathFindMap& outMap);
+
+	// 텍스트 맵을 읽어 연결 요소(와 선택적으로 JPS+ 테이블, 랜드마크 거리표, 목표 경계 상자)를 미리 계산해서 저장한다
+	static bool ConvertText(const char* textFileName, int width, int height, const char* fileName, bool bJumpTable, int landmarkCount, bool bGoalBounds, int threadCount);
+
+private:
+	void* mView = nullptr;
+	size_t mViewBytes = 0;
+};
@@ -561,6 +561,9 @@ unsigned int NetServer::monitorThread(void* netServerParam)
 		netServer->mMonitorResult.AverageRecvPendingTPS = static_cast<uint32_t>(sumRecvPendingTPS / sumCount);
 		netServer->mMonitorResult.AverageSendPendingTPS = static_cast<uint32_t>(sumSendPendingTPS / sumCount);
 
+		// 컨텐츠 영역 모니터링
+		netServer->OnMonitor(netServer->mMonitorResult);
+
 		// 모니터링 변수 초기화
 		netServer->mMonitoringVariables.AcceptTPS = 0;
 		netServer->mMonitoringVariables.RecvMessageTPS = 0;
@@ -28,6 +28,25 @@ struct MonitoringVariables
     float ProcessTimeUser;
     float ProcessorTimeKernel;
     float ProcessTimeKernel;
+
+    // 컨텐츠 영역에서 OnMonitor()로 채우는 값
+    uint32_t PathFindQueueDepth;        // 시작을 기다리는 길찾기 요청 수
+    uint32_t PathFindTPS;               // 초당 결과를 전달한 길찾기 수
+    uint32_t PathFindCancelTPS;         // 초당 병합, 취소된 길찾기 요청 수
+    uint32_t PathFindExpandTPS;         // 초당 확장한 노드 수
+    uint32_t PathFindRejectTPS;         // 초당 연결 요소가 달라 탐색 없이 실패한 길찾기 수
+    uint32_t PathFindCacheHitTPS;       // 초당 경로 캐시 적중 횟수
+    uint32_t PathFindCacheMissTPS;      // 초당 경로 캐시 실패 횟수
+    uint32_t PathFindSuspendedCount;    // 조각 한도에 걸려 멈춘 길찾기 수
+    uint32_t PathFindSliceTPS;          // 초당 실행한 길찾기 조각 수
+    uint32_t PathFindPartialTPS;        // 초당 부분 경로를 먼저 보낸 길찾기 수
+    float PathFindAverageWaitMs;        // 요청부터 탐색 시작까지의 평균 시간 (최근 1초)
+    float PathFindAverageSearchMs;      // 평균 탐색 시간 (최근 1초)
+    uint32_t PathFindSearchUsHistogram[8];  // 쿼리 별 탐색 시간 분포 (최근 1초, 마이크로초, 구간은 ~4, ~16, ~64, ... ~16384, 그 이상)
+    uint32_t PathFindExpandHistogram[8];    // 쿼리 별 확장 노드 수 분포 (최근 1초, 구간은 위와 같음)
+    float PathFindAverageScannedCells;      // 쿼리 당 점프가 지나간 칸 수 (최근 1초)
+    float PathFindAverageDecreaseKeys;      // 쿼리 당 OPEN LIST 키를 줄인 횟수 (최근 1초)
+    float PathFindAverageLineOfSightCells;  // 쿼리 당 경로 줄이기에서 직선 검사한 칸 수 (최근 1초)
 };
 /************************** monitoring variables **************************/
 
@@ -105,6 +124,10 @@ public: // 서버 핸들러 가상 함수들
     // 이 함수가 호출되면 더 이상 해당 세션ID는 유효하지 않습니다.
     virtual void OnRelease(const uint64_t sessionID) = 0;
 
+    // 모니터링 결과를 갱신할 때 (1초마다) 모니터 스레드에서 호출됩니다.
+    // 컨텐츠 영역의 모니터링 값을 채울 때 사용합니다.
+    virtual void OnMonitor(MonitoringVariables& monitorResult) {}
+
 private: // 스레드 함수들
 
     static unsigned int acceptThread(void* netServerParam);     // Accept, 세션 생성 전담
@@ -1,7 +1,27 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 
+// NodeArena 안의 노드 번호 (다음 NodeArena::Reset() 전까지 유효)
+// 탐색 코어(GridSearch, JPSPathFinder)는 노드를 포인터가 아닌 번호로 가리킨다
+typedef int32_t NodeIndex;
+
+// 부모가 없는 노드(시작 노드)의 부모, 찾지 못한 노드
+constexpr NodeIndex NULL_NODE = -1;
+
+// GridSearch가 확장할 노드를 NodeArena에서 한 번 읽어서 후속 노드 생성기(Successors)에 넘기는 값
+struct ExpandedNode
+{
+	NodeIndex Index;
+	NodeIndex Parent;	// 시작 노드라면 NULL_NODE
+	int X;
+	int Y;
+	int G;
+};
+
+// 좌표, F, G, H, 부모 포인터를 한 덩어리로 가진 노드
+// 탐색 코어는 NodeArena의 SoA 배열을 쓰고, 이 구조체는 예전 OPEN LIST(PriorityQueue)와 비교하는 벤치마크에서만 쓴다
 struct Node
 {
 public:
@@ -13,35 +33,17 @@ public:
 	Node* Parent;
 
 public:
-	Node(int x, int y, int g, Node* parent, int destinationX, int destinationY)
+	// H는 탐색의 휴리스틱 정책이 계산해서 넣는다 (GridSearchPolicy.h)
+	Node(int x, int y, int g, Node* parent, int h)
 		: X(x)
 		, Y(y)
 		, G(g)
+		, H(h)
 		, Parent(parent)
 	{
-		H = getHByRealMinDistance(destinationX, destinationY);
-
 		F = G + H;
 	}
 
-private:
-	// 맨하튼 거리
-	int getHByManhattan(int destinationX, int destinationY)
-	{
-		int xGap = abs(X - destinationX);
-		int yGap = abs(Y - destinationY);
-		return (xGap + yGap) * 5;
-	}
-
-	// 실제 거리 비용
-	int getHByRealMinDistance(int destinationX, int destinationY)
-	{
-		int xGap = abs(X - destinationX);
-		int yGap = abs(Y - destinationY);
-		int minGap = xGap < yGap ? xGap : yGap;
-		int maxGap = xGap > yGap ? xGap : yGap;
-		return minGap * 7 + (maxGap - minGap) * 5;
-	}
 public:
 	bool operator>(const Node& other)
 	{
@@ -0,0 +1,146 @@
+// 길찾기 한 번 동안 사용할 노드들을 할당하는 범프 할당기
+// 노드는 필드 별 배열(SoA)에 나눠 담고 번호(NodeIndex)로 가리킵니다.
+// 좌표는 16비트(한 변 65536칸까지), G와 H는 32비트, 부모는 포인터 대신 32비트 번호이므로 노드 하나가 16 byte입니다.
+// F는 OPEN LIST의 키에만 있고 (IndexedPriorityQueue.h), H는 키를 줄일 때와 부분 경로의 끝(가장 가까운 노드)을 고를 때만 읽습니다.
+// 개별 반환은 없고, 탐색이 끝나면 Reset()으로 한 번에 전부 반환합니다 (O(1)).
+// 배열이 부족하면 두 배로 늘리고, 늘린 배열은 해제하지 않고 다음 탐색에서 재사용합니다 (번호는 늘려도 그대로 유효).
+
+/************************************** 사용법 **************************************/
+// NodeArena arena;
+//
+// NodeIndex node = arena.Alloc(x, y, g, parent, h);
+// int g = arena.GetG(node);
+// NodeIndex parent = arena.GetParent(node);
+// ...
+// arena.Reset(); // 탐색 종료 후, 할당한 노드 전부 반환
+/************************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "Node.h"
+
+class NodeArena
+{
+public:
+	enum
+	{
+		MAX_COORDINATE = UINT16_MAX,	// 좌표는 16비트이므로 맵의 한 변은 MAX_COORDINATE + 1칸까지
+		BYTES_PER_NODE = sizeof(uint16_t) * 2 + sizeof(int) * 2 + sizeof(NodeIndex),
+	};
+
+public:
+	NodeArena(int initialCapacity = DEFAULT_INITIAL_CAPACITY)
+		: mCapacity(0)
+		, mCount(0)
+	{
+		reserve(initialCapacity);
+	}
+
+	~NodeArena()
+	{
+		delete[] mX;
+		delete[] mY;
+		delete[] mG;
+		delete[] mH;
+		delete[] mParents;
+	}
+
+	NodeArena(const NodeArena& other) = delete;
+	NodeArena& operator=(const NodeArena& other) = delete;
+
+	// 노드를 하나 할당받는다
+	NodeIndex Alloc(int x, int y, int g, NodeIndex parent, int h)
+	{
+		assert(x >= 0 && x <= MAX_COORDINATE && y >= 0 && y <= MAX_COORDINATE);
+
+		if (mCount == mCapacity)
+		{
+			reserve(mCapacity * 2);
+		}
+
+		const NodeIndex node = mCount;
+		mCount++;
+
+		mX[node] = static_cast<uint16_t>(x);
+		mY[node] = static_cast<uint16_t>(y);
+		mG[node] = g;
+		mH[node] = h;
+		mParents[node] = parent;
+
+		return node;
+	}
+
+	inline int GetX(NodeIndex node) const { return mX[node]; }
+	inline int GetY(NodeIndex node) const { return mY[node]; }
+	inline int GetG(NodeIndex node) const { return mG[node]; }
+	inline int GetH(NodeIndex node) const { return mH[node]; }
+	inline NodeIndex GetParent(NodeIndex node) const { return mParents[node]; }
+
+	inline void SetG(NodeIndex node, int g) { mG[node] = g; }
+	inline void SetParent(NodeIndex node, NodeIndex parent) { mParents[node] = parent; }
+
+	// 할당한 노드들을 모두 반환한다
+	inline void Reset()
+	{
+		mCount = 0;
+	}
+
+	// Reset() 이후 할당한 노드 수 (번호는 0 ~ 이 값 - 1)
+	inline int GetAllocatedCount() const
+	{
+		return mCount;
+	}
+
+	// 지금까지 늘린 배열들의 총 크기 (byte)
+	inline size_t GetReservedBytes() const
+	{
+		return static_cast<size_t>(mCapacity) * BYTES_PER_NODE;
+	}
+
+private:
+	// 배열들을 capacity개로 늘리고 할당한 노드들을 옮긴다
+	void reserve(int capacity)
+	{
+		assert(capacity > mCapacity);
+
+		mX = grow(mX, capacity);
+		mY = grow(mY, capacity);
+		mG = grow(mG, capacity);
+		mH = grow(mH, capacity);
+		mParents = grow(mParents, capacity);
+
+		mCapacity = capacity;
+	}
+
+	template <typename T>
+	T* grow(T* datas, int capacity) const
+	{
+		T* newDatas = new T[capacity];
+
+		if (datas != nullptr)
+		{
+			memcpy(newDatas, datas, sizeof(T) * mCount);
+			delete[] datas;
+		}
+
+		return newDatas;
+	}
+
+	enum
+	{
+		DEFAULT_INITIAL_CAPACITY = 4096,
+	};
+
+private:
+	uint16_t* mX = nullptr;
+	uint16_t* mY = nullptr;
+	int* mG = nullptr;
+	int* mH = nullptr;
+	NodeIndex* mParents = nullptr;
+	int mCapacity;		// 배열 하나의 원소 수
+	int mCount;			// Reset() 이후 할당한 노드 수
+};
@@ -0,0 +1,232 @@
+// 길찾기 경로 (웨이포인트 목록)
+// 좌표를 연속된 메모리에 담고, 앞에서부터 하나씩 소비하는 커서를 가집니다.
+// INLINE_CAPACITY 개까지는 객체 안의 버퍼를 쓰기 때문에 힙 할당이 없고, 넘어가면 두 배씩 늘려서 한 번에 할당합니다.
+// PopFront()는 커서만 옮기고 메모리는 해제하지 않습니다 (PushBack()할 공간이 모자라면 남은 좌표를 앞으로 당겨서 재사용).
+
+/************************************** 사용법 **************************************/
+// Path path;
+// path.PushBack(Point{ x, y });
+//
+// for (const Point& point : path)
+// {
+//     ...
+// }
+//
+// Point destination = path.Front();
+// path.PopFront();
+/************************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include "Point.h"
+
+class Path
+{
+public:
+	Path() = default;
+
+	Path(const Path& other)
+	{
+		assign(other.Begin(), other.Size());
+	}
+
+	Path(Path&& other) noexcept
+	{
+		moveFrom(other);
+	}
+
+	~Path()
+	{
+		release();
+	}
+
+	Path& operator=(const Path& other)
+	{
+		if (this != &other)
+		{
+			assign(other.Begin(), other.Size());
+		}
+
+		return *this;
+	}
+
+	Path& operator=(Path&& other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+			moveFrom(other);
+		}
+
+		return *this;
+	}
+
+	// 아직 소비하지 않은 좌표 수
+	inline int Size() const { return mSize - mCursor; }
+	inline bool Empty() const { return mSize == mCursor; }
+	inline int Capacity() const { return mCapacity; }
+
+	inline const Point& Front() const
+	{
+		assert(Empty() == false);
+		return mData[mCursor];
+	}
+
+	inline const Point& Back() const
+	{
+		assert(Empty() == false);
+		return mData[mSize - 1];
+	}
+
+	inline const Point& operator[](int index) const
+	{
+		assert(index >= 0 && index < Size());
+		return mData[mCursor + index];
+	}
+
+	inline Point& operator[](int index)
+	{
+		assert(index >= 0 && index < Size());
+		return mData[mCursor + index];
+	}
+
+	inline const Point* Begin() const { return mData + mCursor; }
+	inline const Point* End() const { return mData + mSize; }
+
+	// range-based for 용
+	inline const Point* begin() const { return Begin(); }
+	inline const Point* end() const { return End(); }
+
+	// 맨 앞 좌표를 소비한다 (메모리는 그대로)
+	inline void PopFront()
+	{
+		assert(Empty() == false);
+		mCursor++;
+	}
+
+	void PushBack(const Point& point)
+	{
+		if (mSize == mCapacity)
+		{
+			makeRoom(Size() + 1);
+		}
+
+		mData[mSize] = point;
+		mSize++;
+	}
+
+	// 남은 좌표를 count개로 맞춘다 (늘어난 좌표의 값은 정해지지 않음, 채워서 쓴다)
+	void Resize(int count)
+	{
+		if (mCursor + count > mCapacity)
+		{
+			makeRoom(count);
+		}
+
+		mSize = mCursor + count;
+	}
+
+	// 할당한 메모리는 그대로 두고 비운다
+	inline void Clear()
+	{
+		mSize = 0;
+		mCursor = 0;
+	}
+
+private:
+	// 남은 좌표를 앞으로 당기고, 그래도 모자라면 더 큰 버퍼로 옮긴다
+	void makeRoom(int requiredCount)
+	{
+		const int remainCount = Size();
+
+		if (requiredCount <= mCapacity)
+		{
+			memmove(mData, mData + mCursor, sizeof(Point) * remainCount);
+		}
+		else
+		{
+			int capacity = mCapacity * 2;
+
+			while (capacity < requiredCount)
+			{
+				capacity *= 2;
+			}
+
+			Point* data = new Point[capacity];
+			memcpy(data, mData + mCursor, sizeof(Point) * remainCount);
+
+			release();
+
+			mData = data;
+			mCapacity = capacity;
+		}
+
+		mSize = remainCount;
+		mCursor = 0;
+	}
+
+	void assign(const Point* points, int count)
+	{
+		Clear();
+
+		if (count > mCapacity)
+		{
+			makeRoom(count);
+		}
+
+		memcpy(mData, points, sizeof(Point) * count);
+		mSize = count;
+	}
+
+	// other의 내용을 가져온다 (힙 버퍼는 포인터만 넘기고, 안쪽 버퍼는 남은 좌표만 복사)
+	void moveFrom(Path& other)
+	{
+		if (other.mData == other.mInlineBuffer)
+		{
+			mData = mInlineBuffer;
+			mCapacity = INLINE_CAPACITY;
+			mCursor = 0;
+			mSize = other.Size();
+			memcpy(mInlineBuffer, other.Begin(), sizeof(Point) * mSize);
+		}
+		else
+		{
+			mData = other.mData;
+			mCapacity = other.mCapacity;
+			mCursor = other.mCursor;
+			mSize = other.mSize;
+
+			other.mData = other.mInlineBuffer;
+			other.mCapacity = INLINE_CAPACITY;
+		}
+
+		other.Clear();
+	}
+
+	void release()
+	{
+		if (mData != mInlineBuffer)
+		{
+			delete[] mData;
+		}
+
+		mData = mInlineBuffer;
+		mCapacity = INLINE_CAPACITY;
+	}
+
+	enum
+	{
+		INLINE_CAPACITY = 16,
+	};
+
+private:
+	Point* mData = mInlineBuffer;
+	int mSize = 0;				// mData[0] ~ mData[mSize - 1]까지 사용 중
+	int mCursor = 0;			// 다음에 소비할 좌표 (앞쪽은 이미 소비한 좌표)
+	int mCapacity = INLINE_CAPACITY;
+	Point mInlineBuffer[INLINE_CAPACITY];
+};
@@ -0,0 +1,182 @@
+// 길찾기 결과 캐시
+// (시작 칸, 도착 칸, 맵 버전)을 키로 ReduceNodes()까지 끝난 경로(웨이포인트 목록)를 저장합니다.
+// 맵이 바뀌면 버전이 달라지므로 이전 맵의 경로는 다시 조회되지 않고, LRU 순서에 따라 자연스럽게 밀려납니다.
+// 여러 스레드에서 동시에 사용할 수 있도록 키를 해시해서 샤드로 나누고, 샤드마다 락과 LRU 목록을 따로 둡니다.
+
+/************************************** 사용법 **************************************/
+// PathCache cache(capacity);
+//
+// Path points;
+// if (cache.TryGet(startX, startY, endX, endY, map.GetVersion(), points) == false)
+// {
+//     pathFinder.PathFind(startX, startY, endX, endY);
+//     points = pathFinder.GetPoints();
+//     cache.Put(startX, startY, endX, endY, map.GetVersion(), points);
+// }
+/************************************************************************************/
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "Point.h"
+#include "Path.h"
+
+class PathCache
+{
+public:
+	// capacity : 전체 최대 경로 수 (샤드마다 capacity / shardCount 개씩)
+	PathCache(int capacity, int shardCount = DEFAULT_SHARD_COUNT)
+		: mShardCount(shardCount)
+		, mCapacityPerShard((capacity + shardCount - 1) / shardCount)
+	{
+		mShards = new Shard[shardCount];
+	}
+
+	~PathCache()
+	{
+		delete[] mShards;
+	}
+
+	PathCache(const PathCache& other) = delete;
+	PathCache& operator=(const PathCache& other) = delete;
+
+	// 저장된 경로가 있다면 outPoints에 복사하고 true를 반환한다 (가장 최근에 사용한 것으로 갱신)
+	bool TryGet(int startX, int startY, int endX, int endY, uint32_t mapVersion, Path& outPoints)
+	{
+		Key key = makeKey(startX, startY, endX, endY, mapVersion);
+		Shard& shard = getShard(key);
+
+		{
+			std::lock_guard<std::mutex> lock(shard.Lock);
+
+			auto found = shard.Index.find(key);
+
+			if (found != shard.Index.end())
+			{
+				// 가장 최근에 사용한 경로를 맨 앞으로
+				shard.Entries.splice(shard.Entries.begin(), shard.Entries, found->second);
+				outPoints = found->second->Points;
+
+				mHitCount++;
+				return true;
+			}
+		}
+
+		mMissCount++;
+		return false;
+	}
+
+	// 경로를 저장한다 (가득 찼다면 가장 오래 사용하지 않은 경로를 버린다)
+	void Put(int startX, int startY, int endX, int endY, uint32_t mapVersion, const Path& points)
+	{
+		Key key = makeKey(startX, startY, endX, endY, mapVersion);
+		Shard& shard = getShard(key);
+
+		std::lock_guard<std::mutex> lock(shard.Lock);
+
+		auto found = shard.Index.find(key);
+
+		if (found != shard.Index.end())
+		{
+			found->second->Points = points;
+			shard.Entries.splice(shard.Entries.begin(), shard.Entries, found->second);
+			return;
+		}
+
+		if ((int)shard.Index.size() >= mCapacityPerShard)
+		{
+			shard.Index.erase(shard.Entries.back().CacheKey);
+			shard.Entries.pop_back();
+			mEvictionCount++;
+		}
+
+		shard.Entries.push_front(Entry{ key, points });
+		shard.Index.insert(std::make_pair(key, shard.Entries.begin()));
+	}
+
+	void Clear()
+	{
+		for (int i = 0; i < mShardCount; ++i)
+		{
+			std::lock_guard<std::mutex> lock(mShards[i].Lock);
+
+			mShards[i].Entries.clear();
+			mShards[i].Index.clear();
+		}
+	}
+
+	inline uint64_t GetHitCount() const { return mHitCount; }
+	inline uint64_t GetMissCount() const { return mMissCount; }
+	inline uint64_t GetEvictionCount() const { return mEvictionCount; }
+
+private:
+	struct Key
+	{
+		uint64_t Cells;         // 시작 X, 시작 Y, 도착 X, 도착 Y (각 16비트)
+		uint32_t MapVersion;
+
+		inline bool operator==(const Key& other) const
+		{
+			return Cells == other.Cells && MapVersion == other.MapVersion;
+		}
+	};
+
+	struct KeyHash
+	{
+		inline size_t operator()(const Key& key) const
+		{
+			// splitmix64 마무리 단계
+			uint64_t hash = key.Cells ^ (static_cast<uint64_t>(key.MapVersion) * 0x9E3779B97F4A7C15ull);
+			hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+			hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+			return static_cast<size_t>(hash ^ (hash >> 31));
+		}
+	};
+
+	struct Entry
+	{
+		Key CacheKey;
+		Path Points;
+	};
+
+	struct Shard
+	{
+		std::mutex Lock;
+		std::list<Entry> Entries;   // 앞쪽일수록 최근에 사용
+		std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> Index;
+	};
+
+	inline static Key makeKey(int startX, int startY, int endX, int endY, uint32_t mapVersion)
+	{
+		uint64_t cells = static_cast<uint64_t>(static_cast<uint16_t>(startX))
+			| static_cast<uint64_t>(static_cast<uint16_t>(startY)) << 16
+			| static_cast<uint64_t>(static_cast<uint16_t>(endX)) << 32
+			| static_cast<uint64_t>(static_cast<uint16_t>(endY)) << 48;
+
+		return Key{ cells, mapVersion };
+	}
+
+	inline Shard& getShard(const Key& key)
+	{
+		return mShards[KeyHash()(key) % mShardCount];
+	}
+
+	enum
+	{
+		DEFAULT_SHARD_COUNT = 16,
+	};
+
+private:
+	const int mShardCount;
+	const int mCapacityPerShard;
+	Shard* mShards;
+
+	std::atomic<uint64_t> mHitCount = 0;
+	std::atomic<uint64_t> mMissCount = 0;
+	std::atomic<uint64_t> mEvictionCount = 0;
+};
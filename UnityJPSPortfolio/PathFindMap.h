@@ -0,0 +1,292 @@
+// 길찾기 모듈들이 공유하는 맵
+// 이동 가능 여부(BitGrid)와 JPS+ 점프 거리 테이블, 연결 요소, 랜드마크 거리표, 목표 경계 상자를 가지고 있고, 여러 JPSPathFinder가 동시에 읽기만 합니다.
+// 탐색 도중에 바뀌면 안 되므로 Block(), UnBlock(), Enable...(), Refresh...()는 탐색하는 스레드가 없을 때(맵 로딩 등)에만 호출해야 합니다.
+
+/************************************** 사용법 **************************************/
+// PathFindMap map(width, height);
+// map.Block(x, y);
+// map.EnableComponents(); // 맵을 모두 읽은 뒤 (연결 요소가 다른 쿼리는 탐색 없이 거절)
+// map.EnableLandmarks(landmarkCount, memoryBudgetBytes, threadCount); // 맵을 모두 읽은 뒤 (미로형 맵의 휴리스틱 보강)
+// map.EnableGoalBounds(threadCount); // 맵을 모두 읽은 뒤 (작은 정적 맵에서 JPS의 점프 방향 가지치기, 보통은 맵 파일에 미리 만들어 둔다)
+//
+// // 또는 미리 계산해둔 맵 파일을 복사 없이 그대로 쓴다 (mapFile은 map보다 오래 열려 있어야 한다)
+// map.Load(mapFile, threadCount);
+//
+// // 스레드 마다 자신의 JPSPathFinder를 만들어 같은 맵을 공유한다
+// JPSPathFinder pathFinder(map);
+// pathFinder.PathFind(startX, startY, endX, endY);
+/************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include "BitGrid.h"
+#include "JumpDistanceTable.h"
+#include "ConnectedComponents.h"
+#include "LandmarkTable.h"
+#include "GoalBoundingTable.h"
+#include "MapFile.h"
+
+class PathFindMap
+{
+public:
+	PathFindMap(int width, int height)
+		: mWidth(width)
+		, mHeight(height)
+		, mGrid(width, height)
+	{
+	}
+
+	~PathFindMap()
+	{
+		delete mJumpTable;
+		delete mComponents;
+		delete mLandmarks;
+		delete mGoalBounds;
+	}
+
+	PathFindMap(const PathFindMap& other) = delete;
+	PathFindMap& operator=(const PathFindMap& other) = delete;
+
+	inline int GetWidth() const { return mWidth; }
+	inline int GetHeight() const { return mHeight; }
+
+	inline const BitGrid& GetGrid() const { return mGrid; }
+
+	// 맵이 바뀔 때마다 증가하는 번호 (이전 맵으로 찾은 경로를 구분하는 용도)
+	inline uint32_t GetVersion() const { return mVersion; }
+
+	// JPS+ 모드가 꺼져 있다면 nullptr
+	inline const JumpDistanceTable* GetJumpTable() const { return mJumpTable; }
+
+	inline void Block(int x, int y) { setWalkable(x, y, false); }
+	inline void UnBlock(int x, int y) { setWalkable(x, y, true); }
+	inline bool IsBlocked(int x, int y) const
+	{
+		// out of range
+		if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+		{
+			return true;
+		}
+
+		return !mGrid.IsWalkable(x, y);
+	}
+
+	// 맵 파일의 이동 가능 여부와 (들어 있다면) 점프 거리 테이블, 연결 요소, 랜드마크 거리표, 목표 경계 상자를 복사 없이 그대로 쓴다
+	// 파일에 없는 테이블은 꺼지고, threadCount는 랜드마크 거리표를 다시 만들 때 쓴다 (RefreshLandmarks())
+	// 크기가 다르다면 아무것도 바꾸지 않고 false
+	bool Load(const MapFile& file, int threadCount)
+	{
+		if (file.IsOpen() == false || file.GetHeader().Width != mWidth || file.GetHeader().Height != mHeight)
+		{
+			return false;
+		}
+
+		const MapFile::Header& header = file.GetHeader();
+
+		DisableJumpTable();
+		DisableComponents();
+		DisableLandmarks();
+		DisableGoalBounds();
+
+		mGrid.Attach(static_cast<uint64_t*>(file.GetSection(MapFile::Rows)), static_cast<uint64_t*>(file.GetSection(MapFile::Columns)));
+		mVersion++;
+
+		if (file.GetSection(MapFile::JumpTable) != nullptr)
+		{
+			mJumpTable = new JumpDistanceTable(mGrid, static_cast<int16_t*>(file.GetSection(MapFile::JumpTable)));
+		}
+
+		if (file.GetSection(MapFile::ComponentLabels) != nullptr)
+		{
+			mComponents = new ConnectedComponents(mGrid, static_cast<uint32_t*>(file.GetSection(MapFile::ComponentLabels)),
+				static_cast<const uint32_t*>(file.GetSection(MapFile::ComponentParents)),
+				static_cast<const uint32_t*>(file.GetSection(MapFile::ComponentCellCounts)), header.ComponentLabelCount);
+		}
+
+		if (file.GetSection(MapFile::LandmarkDistances) != nullptr)
+		{
+			mLandmarks = new LandmarkTable(mGrid, static_cast<const Point*>(file.GetSection(MapFile::LandmarkPoints)), header.LandmarkCount,
+				static_cast<uint16_t*>(file.GetSection(MapFile::LandmarkDistances)));
+		}
+
+		if (file.GetSection(MapFile::GoalBounds) != nullptr)
+		{
+			mGoalBounds = new GoalBoundingTable(mGrid, static_cast<GoalBoundingTable::Bounds*>(file.GetSection(MapFile::GoalBounds)));
+		}
+
+		mLandmarkThreadCount = threadCount;
+
+		return true;
+	}
+
+	// JPS+ 모드 (셀마다 8방향의 점프 거리를 미리 계산해두고 탐색 중에는 테이블만 참조한다)
+	// 맵을 모두 읽은 뒤 켜는 것이 좋다 (켜져 있는 동안의 Block(), UnBlock()은 테이블을 부분적으로 갱신한다)
+	void EnableJumpTable()
+	{
+		if (mJumpTable == nullptr)
+		{
+			mJumpTable = new JumpDistanceTable(mGrid);
+			mJumpTable->Build();
+		}
+	}
+
+	void DisableJumpTable()
+	{
+		delete mJumpTable;
+		mJumpTable = nullptr;
+	}
+
+	inline bool IsJumpTableEnabled() const { return mJumpTable != nullptr; }
+
+	// 연결 요소 (시작 칸과 도착 칸의 연결 요소가 다르면 JPSPathFinder가 탐색 없이 바로 실패한다)
+	// 켜져 있는 동안의 UnBlock()은 바로 반영되고, 연결 요소를 나눌 수 있는 Block()은 RefreshComponents()를 호출할 때 반영된다
+	void EnableComponents()
+	{
+		if (mComponents == nullptr)
+		{
+			mComponents = new ConnectedComponents(mGrid);
+			mComponents->Build();
+		}
+	}
+
+	void DisableComponents()
+	{
+		delete mComponents;
+		mComponents = nullptr;
+	}
+
+	inline bool IsComponentsEnabled() const { return mComponents != nullptr; }
+
+	// 꺼져 있다면 nullptr
+	inline const ConnectedComponents* GetComponents() const { return mComponents; }
+
+	// Block()으로 나뉘었을 수 있는 연결 요소들을 다시 나눈다 (맵 수정을 마친 뒤 호출)
+	void RefreshComponents()
+	{
+		if (mComponents != nullptr)
+		{
+			mComponents->Refresh();
+		}
+	}
+
+	// 랜드마크 휴리스틱 (JPSPathFinder가 옥타일 거리 대신 랜드마크 거리표의 하한과 중 큰 값을 쓴다)
+	// 거리표가 memoryBudgetBytes를 넘지 않도록 랜드마크 수를 줄이고, 실제로 만든 랜드마크 수를 반환한다 (0이면 끈 상태)
+	// 켜져 있는 동안의 Block(), UnBlock()은 거리표를 무효로 만들고 (JPSPathFinder는 옥타일 거리만 쓴다), RefreshLandmarks()를 호출할 때 다시 만든다
+	int EnableLandmarks(int landmarkCount, size_t memoryBudgetBytes, int threadCount)
+	{
+		DisableLandmarks();
+
+		int maxLandmarkCount = LandmarkTable::GetMaxLandmarkCount(mWidth, mHeight, memoryBudgetBytes);
+		landmarkCount = landmarkCount < maxLandmarkCount ? landmarkCount : maxLandmarkCount;
+
+		if (landmarkCount <= 0)
+		{
+			return 0;
+		}
+
+		mLandmarks = new LandmarkTable(mGrid);
+		mLandmarks->Build(landmarkCount, threadCount);
+		mLandmarkThreadCount = threadCount;
+
+		return mLandmarks->GetLandmarkCount();
+	}
+
+	void DisableLandmarks()
+	{
+		delete mLandmarks;
+		mLandmarks = nullptr;
+	}
+
+	inline bool IsLandmarksEnabled() const { return mLandmarks != nullptr; }
+
+	// 꺼져 있다면 nullptr (맵이 바뀐 뒤 다시 만들기 전이라면 IsValid()가 false)
+	inline const LandmarkTable* GetLandmarks() const { return mLandmarks; }
+
+	// 맵이 바뀌어 무효가 된 거리표를 다시 만든다 (맵 수정을 마친 뒤 호출)
+	void RefreshLandmarks()
+	{
+		if (mLandmarks != nullptr && mLandmarks->IsValid() == false)
+		{
+			mLandmarks->Build(mLandmarks->GetLandmarkCount(), mLandmarkThreadCount);
+		}
+	}
+
+	// 목표 경계 상자 (JPSPathFinder가 상자에 목적지가 없는 점프 방향을 건너뛴다)
+	// 칸마다 다익스트라를 한 번씩 하므로 큰 맵에서는 아주 오래 걸린다 (작은 정적 맵을 맵 파일에 미리 만들어 두는 용도)
+	// 켜져 있는 동안의 Block(), UnBlock()은 테이블을 무효로 만들고 (JPSPathFinder는 가지치기를 하지 않는다), 다시 만들려면 EnableGoalBounds()를 다시 호출한다
+	void EnableGoalBounds(int threadCount)
+	{
+		if (mGoalBounds == nullptr)
+		{
+			mGoalBounds = new GoalBoundingTable(mGrid);
+		}
+
+		mGoalBounds->Build(threadCount);
+	}
+
+	void DisableGoalBounds()
+	{
+		delete mGoalBounds;
+		mGoalBounds = nullptr;
+	}
+
+	inline bool IsGoalBoundsEnabled() const { return mGoalBounds != nullptr; }
+
+	// 꺼져 있다면 nullptr (맵이 바뀐 뒤 다시 만들기 전이라면 IsValid()가 false)
+	inline const GoalBoundingTable* GetGoalBounds() const { return mGoalBounds; }
+
+	// 이동 가능 여부와 (켜져 있다면) 점프 거리 테이블, 연결 요소, 랜드마크 거리표, 목표 경계 상자의 총 크기 (byte)
+	inline size_t GetReservedBytes() const
+	{
+		return mGrid.GetReservedBytes() + (mJumpTable != nullptr ? mJumpTable->GetReservedBytes() : 0)
+			+ (mComponents != nullptr ? mComponents->GetReservedBytes() : 0)
+			+ (mLandmarks != nullptr ? mLandmarks->GetReservedBytes() : 0)
+			+ (mGoalBounds != nullptr ? mGoalBounds->GetReservedBytes() : 0);
+	}
+
+private:
+	// 맵 정보 변경 (JPS+ 모드라면 테이블, 연결 요소가 켜져 있다면 연결 요소도 갱신, 랜드마크 거리표와 목표 경계 상자는 무효로)
+	void setWalkable(int x, int y, bool bWalkable)
+	{
+		if (mGrid.IsWalkable(x, y) == bWalkable)
+		{
+			return;
+		}
+
+		mGrid.SetWalkable(x, y, bWalkable);
+		mVersion++;
+
+		if (mJumpTable != nullptr)
+		{
+			mJumpTable->OnCellChanged(x, y);
+		}
+
+		if (mComponents != nullptr)
+		{
+			mComponents->OnCellChanged(x, y);
+		}
+
+		if (mLandmarks != nullptr)
+		{
+			mLandmarks->Invalidate();
+		}
+
+		if (mGoalBounds != nullptr)
+		{
+			mGoalBounds->Invalidate();
+		}
+	}
+
+private:
+	const int mWidth;
+	const int mHeight;
+	BitGrid mGrid;
+	JumpDistanceTable* mJumpTable = nullptr;
+	ConnectedComponents* mComponents = nullptr;
+	LandmarkTable* mLandmarks = nullptr;
+	GoalBoundingTable* mGoalBounds = nullptr;
+	int mLandmarkThreadCount = 1;
+	uint32_t mVersion = 0;
+};
@@ -0,0 +1,946 @@
+// 여러 스레드에서 동시에 길찾기를 수행하기 위한 서비스
+// 맵(PathFindMap)은 하나를 읽기 전용으로 공유하고, 탐색 상태(OPEN LIST, G값, 노드 할당기)는 탐색하는 스레드마다 따로 가집니다.
+//
+// 1. 동기 호출 : PathFind()
+//    탐색 상태를 가진 JPSPathFinder를 탐색 한 번 동안 빌려줍니다. 락은 빌리고 반납할 때만 잡습니다.
+//
+// 2. 비동기 요청 : Start() -> Submit() -> (틱마다) OnTick(), TakeResults()
+//    요청은 큐에 쌓이고, 길찾기 스레드들이 꺼내서 처리한 뒤 결과 목록에 넣어둡니다.
+//    같은 요청자(requesterID)의 요청이 아직 시작되지 않았다면 새 요청으로 덮어쓰고(병합),
+//    이미 탐색 중이라면 끝난 뒤 결과를 버립니다 (항상 마지막 요청의 결과만 전달).
+//    아직 가져가지 않은 이전 요청의 결과도 새 요청(또는 취소)이 들어오면 버립니다.
+//    틱 당 확장 노드 수 예산을 정해두면, 예산을 다 쓴 틱에는 다음 OnTick()까지 탐색을 진행하지 않습니다.
+//    실행 중에 맵을 바꿀 때는 Pause()로 진행 중인 탐색이 끝나기를 기다린 뒤 수정하고 Resume()으로 다시 시작합니다.
+//
+//    탐색은 조각(slice) 단위로 실행합니다. 한 조각에서 확장할 노드 수와 시간(SetSliceOption()), 남은 틱 예산을 넘으면
+//    탐색 상태를 보관소에서 빌린 JPSPathFinder에 둔 채 멈추고, 멈춘 탐색들과 새 요청을 돌아가며 이어서 찾습니다.
+//    따라서 최악의 탐색 하나가 다른 요청들과 Pause()를 오래 붙잡지 않습니다.
+//    길찾기 스레드 없이 시작하면 (Start(0, ...)) OnTick()을 호출한 업데이트 스레드가 주어진 시간 안에서 조각들을 실행합니다.
+//
+//    SetPartialPathOption()을 켜면 새 요청의 첫 조각을 그 한도로 찾고, 다 찾지 못했다면 목적지에 가장 가까이 간 곳까지의
+//    부분 경로를 먼저 결과로 보낸 뒤, 나머지는 부분 경로의 끝에서부터 다시 찾아 같은 요청자의 다음 결과로 보냅니다.
+//
+// 3. 일괄 호출 : PathFindBatch()
+//    한 틱에 몰린 여러 쿼리를 한 번에 찾고, 결과 좌표는 연속된 버퍼 하나에 담습니다. 스레드 수를 주면 구간으로 나눠 동시에 찾습니다.
+//
+// EnablePathCache()로 캐시를 켜면 동기 호출과 비동기 요청은 탐색 전에 캐시(PathCache)를 먼저 확인합니다.
+//
+// PATHFIND_STATISTICS_ON이면 동기 호출과 비동기 요청의 쿼리 통계(SearchStatistics)를 모읍니다.
+// TakeQueryProfile()은 직전 호출 이후의 분포를, GetSlowQueries()는 시작 이후 가장 오래 걸린 쿼리들을 돌려줍니다 (벤치마크에서 재생).
+
+/************************************** 사용법 **************************************/
+// PathFindService service(map);
+//
+// // 동기 호출 (아무 스레드에서나)
+// Path points;
+// service.PathFind(startX, startY, endX, endY, points);
+//
+// // 일괄 호출
+// std::vector<JPSPathFinder::BatchResult> results(queries.size());
+// std::vector<Point> points;
+// service.PathFindBatch(queries.data(), (int)queries.size(), results.data(), points, threadCount);
+//
+// // 비동기 요청
+// service.SetSliceOption(expandCountPerSlice, microsecondsPerSlice, maxActiveSearchCount); // 선택
+// service.Start(threadCount, expandBudgetPerTick);
+// service.Submit(sessionID, startX, startY, endX, endY);
+//
+// // 업데이트 스레드에서 틱마다 (threadCount가 0이면 이 안에서 microsecondsPerTick 동안 탐색)
+// service.OnTick(microsecondsPerTick);
+// service.TakeResults(results);
+//
+// // 모니터 스레드에서 주기마다
+// PathFindService::QueryProfile profile = service.TakeQueryProfile();
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+#include "Point.h"
+#include "Path.h"
+#include "PathFindMap.h"
+#include "JPSPathFinder.h"
+#include "PathCache.h"
+
+class PathFindService
+{
+public:
+	// 비동기 요청의 결과
+	struct Result
+	{
+		uint64_t            RequesterID;
+		Path                Points;     // 시작점 포함 (경로가 없다면 비어 있음)
+		bool                bPartial;   // 목적지가 아닌 가장 가까이 간 곳까지의 경로 (나머지는 Points의 끝에서 시작하는 다음 결과로 온다)
+	};
+
+	// 누적 통계 (GetStatistics() 호출 사이의 차이로 초당 값을 계산한다)
+	struct Statistics
+	{
+		uint32_t QueueDepth;            // 시작을 기다리는 요청 수 (현재 값)
+		uint64_t StartedCount;          // 탐색을 시작한 요청 수
+		uint64_t CompletedCount;        // 결과를 전달한 요청 수
+		uint64_t CancelledCount;        // 병합, 취소로 버린 요청 수
+		uint64_t ExpandedNodeCount;     // 확장한 노드 수
+		uint64_t RejectedCount;         // 연결 요소가 달라 탐색 없이 실패한 요청 수 (동기 호출 포함)
+		uint64_t WaitMicroseconds;      // 요청부터 탐색 시작까지 걸린 시간의 합
+		uint64_t SearchMicroseconds;    // 탐색에 걸린 시간의 합
+		uint64_t CacheHitCount;         // 캐시에서 찾은 요청 수 (동기 호출 포함)
+		uint64_t CacheMissCount;
+		uint32_t SuspendedCount;        // 조각 한도에 걸려 멈춘 탐색 수 (현재 값)
+		uint64_t SliceCount;            // 실행한 탐색 조각 수
+		uint64_t PartialCount;          // 부분 경로를 먼저 보낸 요청 수
+	};
+
+	// 탐색한 쿼리 하나 (캐시에서 찾은 쿼리는 제외)
+	struct QueryRecord
+	{
+		int StartX;
+		int StartY;
+		int EndX;
+		int EndY;
+		SearchStatistics Statistics;
+	};
+
+	// TakeQueryProfile() 사이에 탐색한 쿼리들의 분포 (PATHFIND_STATISTICS_ON이 아니라면 모두 0)
+	// 분포의 i번째 구간은 [4^i, 4^(i+1)) (첫 구간은 0부터, 마지막 구간은 그 이상 전부)
+	struct QueryProfile
+	{
+		enum
+		{
+			BUCKET_COUNT = 8,
+		};
+
+		uint64_t QueryCount;
+		uint64_t ElapsedHistogram[BUCKET_COUNT];        // 탐색 시간 (마이크로초)
+		uint64_t ExpandedHistogram[BUCKET_COUNT];       // 확장한 노드 수
+		uint64_t CreatedNodeCount;                      // 이하 쿼리들의 합
+		uint64_t ScannedCellCount;
+		uint64_t DecreaseKeyCount;
+		uint64_t LineOfSightCellCount;
+	};
+
+public:
+	PathFindService(const PathFindMap& map)
+		: mMap(map)
+	{
+	}
+
+	~PathFindService()
+	{
+		Stop();
+
+		delete mCache;
+
+		for (JPSPathFinder* pathFinder : mIdlePathFinders)
+		{
+			delete pathFinder;
+		}
+	}
+
+	PathFindService(const PathFindService& other) = delete;
+	PathFindService& operator=(const PathFindService& other) = delete;
+
+	// (startX, startY) -> (endX, endY) 경로를 찾아 outPoints에 담는다 (시작점 포함)
+	// 경로가 없다면 false를 반환하고 outPoints는 비어 있다
+	bool PathFind(int startX, int startY, int endX, int endY, Path& outPoints)
+	{
+		if (mCache != nullptr && mCache->TryGet(startX, startY, endX, endY, mMap.GetVersion(), outPoints))
+		{
+			return outPoints.Empty() == false;
+		}
+
+		JPSPathFinder* pathFinder = acquire();
+
+		pathFinder->PathFind(startX, startY, endX, endY);
+		outPoints = pathFinder->GetPoints();
+		bool bRejected = pathFinder->IsRejected();
+		QueryRecord query{ startX, startY, endX, endY, pathFinder->GetSearchStatistics() };
+
+		release(pathFinder);
+		recordQuery(query);
+
+		if (bRejected)
+		{
+			std::lock_guard<std::mutex> lock(mQueueLock);
+			mStatistics.RejectedCount++;
+		}
+
+		if (mCache != nullptr)
+		{
+			mCache->Put(startX, startY, endX, endY, mMap.GetVersion(), outPoints);
+		}
+
+		return outPoints.Empty() == false;
+	}
+
+	// 여러 쿼리를 한 번에 찾는다 (JPSPathFinder::PathFindBatch()와 같은 형식, 캐시는 사용하지 않는다)
+	// threadCount가 2 이상이면 쿼리들을 그 수만큼의 구간으로 나눠 동시에 찾고, 구간 순서대로 좌표를 outPoints에 이어 붙인다
+	void PathFindBatch(const JPSPathFinder::Query* queries, int queryCount,
+		JPSPathFinder::BatchResult* outResults, std::vector<Point>& outPoints, int threadCount = 1)
+	{
+		if (threadCount > queryCount)
+		{
+			threadCount = queryCount;
+		}
+
+		if (threadCount <= 1)
+		{
+			JPSPathFinder* pathFinder = acquire();
+			pathFinder->PathFindBatch(queries, queryCount, outResults, outPoints);
+			release(pathFinder);
+			return;
+		}
+
+		std::vector<std::vector<Point>> chunkPoints(threadCount);
+		std::vector<std::thread> threads;
+
+		auto runChunk = [&](int chunk)
+			{
+				int begin = static_cast<int>(static_cast<int64_t>(queryCount) * chunk / threadCount);
+				int end = static_cast<int>(static_cast<int64_t>(queryCount) * (chunk + 1) / threadCount);
+
+				JPSPathFinder* pathFinder = acquire();
+				pathFinder->PathFindBatch(queries + begin, end - begin, outResults + begin, chunkPoints[chunk]);
+				release(pathFinder);
+			};
+
+		// 첫 구간은 호출한 스레드가 맡는다
+		for (int chunk = 1; chunk < threadCount; ++chunk)
+		{
+			threads.emplace_back(runChunk, chunk);
+		}
+
+		runChunk(0);
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		// 구간별 좌표를 이어 붙이고, 결과의 위치를 outPoints 기준으로 옮긴다
+		for (int chunk = 0; chunk < threadCount; ++chunk)
+		{
+			int begin = static_cast<int>(static_cast<int64_t>(queryCount) * chunk / threadCount);
+			int end = static_cast<int>(static_cast<int64_t>(queryCount) * (chunk + 1) / threadCount);
+			int base = static_cast<int>(outPoints.size());
+
+			for (int i = begin; i < end; ++i)
+			{
+				outResults[i].PointOffset += base;
+			}
+
+			outPoints.insert(outPoints.end(), chunkPoints[chunk].begin(), chunkPoints[chunk].end());
+		}
+	}
+
+	// 경로 캐시를 켠다 (Start() 전에 호출)
+	// capacity : 저장할 최대 경로 수
+	void EnablePathCache(int capacity)
+	{
+		if (mCache == nullptr)
+		{
+			mCache = new PathCache(capacity);
+		}
+	}
+
+	// 캐시가 꺼져 있다면 nullptr
+	inline PathCache* GetPathCache() const { return mCache; }
+
+	inline const PathFindMap& GetMap() const { return mMap; }
+
+	// 직전 호출 이후 탐색한 쿼리들의 분포를 가져가고 비운다 (모니터 스레드에서 주기마다)
+	QueryProfile TakeQueryProfile()
+	{
+		std::lock_guard<std::mutex> lock(mProfileLock);
+
+		QueryProfile profile = mQueryProfile;
+		mQueryProfile = QueryProfile{};
+
+		return profile;
+	}
+
+	// 시작 이후 가장 오래 걸린 쿼리들을 느린 순서로 outQueries에 담는다 (최대 SetSlowQueryCount()개)
+	void GetSlowQueries(std::vector<QueryRecord>& outQueries)
+	{
+		std::lock_guard<std::mutex> lock(mProfileLock);
+		outQueries = mSlowQueries;
+	}
+
+	// 보관할 느린 쿼리 수 (기본 DEFAULT_SLOW_QUERY_COUNT)
+	void SetSlowQueryCount(int slowQueryCount)
+	{
+		std::lock_guard<std::mutex> lock(mProfileLock);
+
+		mSlowQueryCount = slowQueryCount > 0 ? slowQueryCount : 0;
+
+		if ((int)mSlowQueries.size() > mSlowQueryCount)
+		{
+			mSlowQueries.resize(mSlowQueryCount);
+		}
+	}
+
+	// 지금까지 만든 JPSPathFinder 개수 (= 동기 호출의 최대 동시 탐색 수)
+	inline int GetPathFinderCount()
+	{
+		std::lock_guard<std::mutex> lock(mPoolLock);
+		return mPathFinderCount;
+	}
+
+public: // 비동기 요청
+
+	// 탐색 조각 설정 (Start() 전에 호출, 기본은 틱 예산 말고는 한도 없음)
+	// expandCountPerSlice, microsecondsPerSlice : 탐색 하나를 한 번에 이어서 찾는 최대 확장 노드 수와 시간 (0이면 제한 없음)
+	// maxActiveSearchCount : 시작했고 끝나지 않은 (멈춘 것 포함) 탐색 수의 한도, 넘으면 새 요청은 큐에서 기다린다
+	//                        멈춘 탐색마다 JPSPathFinder 하나(맵 크기에 비례하는 탐색 상태)를 보관소에서 빌려 쓴다
+	void SetSliceOption(int expandCountPerSlice, int microsecondsPerSlice, int maxActiveSearchCount)
+	{
+		mExpandCountPerSlice = expandCountPerSlice;
+		mMicrosecondsPerSlice = microsecondsPerSlice;
+		mMaxActiveSearchCount = maxActiveSearchCount > 0 ? maxActiveSearchCount : 1;
+	}
+
+	// 부분 경로 설정 (Start() 전에 호출, 기본은 사용 안 함)
+	// expandCount, microseconds : 새 요청의 첫 조각 한도 (0이면 제한 없음, 둘 다 0이면 부분 경로를 쓰지 않는다), 남은 틱 예산과 OnTick()의 시간은 넘지 않는다
+	// 한도 안에 찾지 못했거나 목적지가 다른 연결 요소라면 가장 가까이 간 곳까지의 경로를 먼저 보낸다 (JPSPathFinder::PathFindPartial())
+	void SetPartialPathOption(int expandCount, int microseconds)
+	{
+		mPartialExpandCount = expandCount;
+		mPartialMicroseconds = microseconds;
+	}
+
+	// 길찾기 스레드들을 시작한다 (0이면 스레드 없이 OnTick()에서 탐색한다)
+	// expandBudgetPerTick : 틱 당 확장할 수 있는 노드 수 (0이면 제한 없음), 조각은 남은 예산만큼만 확장하고 멈춘다
+	void Start(int threadCount, int expandBudgetPerTick)
+	{
+		mExpandBudgetPerTick = expandBudgetPerTick;
+		mRemainingBudget = expandBudgetPerTick;
+		mbStop = false;
+
+		for (int i = 0; i < threadCount; ++i)
+		{
+			mThreads.emplace_back(&PathFindService::workerThread, this);
+		}
+	}
+
+	// 처리 중인 조각이 끝나면 길찾기 스레드들을 종료한다 (대기 중인 요청과 멈춘 탐색은 버린다)
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mQueueLock);
+			mbStop = true;
+		}
+
+		mQueueCondition.notify_all();
+
+		for (std::thread& thread : mThreads)
+		{
+			thread.join();
+		}
+
+		mThreads.clear();
+
+		std::lock_guard<std::mutex> lock(mQueueLock);
+
+		for (ActiveSearch& search : mSuspendedSearches)
+		{
+			release(search.PathFinder);
+		}
+
+		mSuspendedSearches.clear();
+		mActiveSearchCount = 0;
+		mStatistics.SuspendedCount = 0;
+
+		// 버린 요청이 요청자 목록과 대기 중인 요청 수에 남지 않도록 한다 (다시 Start()한 뒤 같은 요청자의 새 요청이 버린 요청에 병합되지 않는다)
+		mStatistics.CancelledCount += mStatistics.QueueDepth;
+		mStatistics.QueueDepth = 0;
+		mQueue.clear();
+		mRequesters.clear();
+	}
+
+	// 새 조각을 실행하지 않게 하고, 실행 중인 조각이 모두 끝날 때까지 기다린다 (길찾기 스레드가 도는 중에 맵을 수정하기 전에 호출)
+	// 요청은 계속 받아서 쌓아두고, Resume() 이후 바뀐 맵으로 찾는다 (동기 호출은 막지 않는다)
+	// 멈춘 탐색은 이어서 찾을 때 맵 버전이 바뀐 것을 보고 처음부터 다시 찾는다
+	void Pause()
+	{
+		std::unique_lock<std::mutex> lock(mQueueLock);
+
+		mbPaused = true;
+		mIdleCondition.wait(lock, [this]() { return mSearchingCount == 0; });
+	}
+
+	void Resume()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mQueueLock);
+			mbPaused = false;
+		}
+
+		mQueueCondition.notify_all();
+	}
+
+	// 경로 요청 (같은 requesterID의 이전 요청은 병합 또는 취소된다)
+	void Submit(uint64_t requesterID, int startX, int startY, int endX, int endY)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mQueueLock);
+
+			Requester& requester = mRequesters[requesterID];
+			requester.Sequence = ++mLastSequence;
+			requester.StartX = startX;
+			requester.StartY = startY;
+			requester.EndX = endX;
+			requester.EndY = endY;
+
+			if (requester.bPending)
+			{
+				// 아직 시작하지 않은 요청에 병합 (큐 안의 순서와 대기 시작 시간은 유지)
+				mStatistics.CancelledCount++;
+				return;
+			}
+
+			// 이전 요청이 멈춰 있거나 결과를 아직 가져가지 않았다면 필요 없으므로 바로 버린다
+			dropSuspendedSearch(requesterID);
+			dropResults(requesterID);
+
+			requester.bPending = true;
+			requester.SubmitTime = std::chrono::steady_clock::now();
+
+			mQueue.push_back(requesterID);
+			mStatistics.QueueDepth++;
+		}
+
+		mQueueCondition.notify_one();
+	}
+
+	// requesterID의 요청을 모두 취소한다 (대기 중인 요청은 제거, 탐색 중인 요청과 가져가지 않은 결과는 버림)
+	void Cancel(uint64_t requesterID)
+	{
+		std::lock_guard<std::mutex> lock(mQueueLock);
+
+		// 탐색이 끝나 요청자 목록에서 빠졌더라도 가져가지 않은 결과는 남아 있을 수 있다
+		dropResults(requesterID);
+
+		auto found = mRequesters.find(requesterID);
+
+		if (found == mRequesters.end())
+		{
+			return;
+		}
+
+		if (found->second.bPending)
+		{
+			mStatistics.QueueDepth--;
+			mStatistics.CancelledCount++;
+		}
+
+		dropSuspendedSearch(requesterID);
+		mRequesters.erase(found);
+	}
+
+	// 업데이트 스레드에서 틱마다 호출하여 예산을 채운다
+	// 이전 틱에 예산을 넘겨 쓴 만큼은 이번 틱의 예산에서 뺀다
+	// 길찾기 스레드 없이 시작했다면 이 스레드에서 microsecondsPerTick 동안 (0이면 할 일이 없을 때까지) 조각들을 돌아가며 실행한다
+	void OnTick(int microsecondsPerTick = 0)
+	{
+		std::unique_lock<std::mutex> lock(mQueueLock);
+
+		if (mExpandBudgetPerTick > 0)
+		{
+			mRemainingBudget += mExpandBudgetPerTick;
+
+			if (mRemainingBudget > mExpandBudgetPerTick)
+			{
+				mRemainingBudget = mExpandBudgetPerTick;
+			}
+		}
+
+		if (mThreads.empty() == false)
+		{
+			lock.unlock();
+			mQueueCondition.notify_all();
+			return;
+		}
+
+		const auto tickBegin = std::chrono::steady_clock::now();
+
+		while (canRunSlice())
+		{
+			int64_t remainingMicroseconds = 0;
+
+			if (microsecondsPerTick > 0)
+			{
+				remainingMicroseconds = microsecondsPerTick - std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - tickBegin).count();
+
+				if (remainingMicroseconds <= 0)
+				{
+					break;
+				}
+			}
+
+			runSlice(lock, remainingMicroseconds);
+		}
+	}
+
+	// 완료된 결과들을 outResults 뒤에 옮겨 담는다
+	void TakeResults(std::vector<Result>& outResults)
+	{
+		std::lock_guard<std::mutex> lock(mResultLock);
+
+		for (Result& result : mResults)
+		{
+			outResults.push_back(std::move(result));
+		}
+
+		mResults.clear();
+	}
+
+	Statistics GetStatistics()
+	{
+		Statistics statistics;
+
+		{
+			std::lock_guard<std::mutex> lock(mQueueLock);
+			statistics = mStatistics;
+		}
+
+		if (mCache != nullptr)
+		{
+			statistics.CacheHitCount = mCache->GetHitCount();
+			statistics.CacheMissCount = mCache->GetMissCount();
+		}
+
+		return statistics;
+	}
+
+private:
+	JPSPathFinder* acquire()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mPoolLock);
+
+			if (mIdlePathFinders.empty() == false)
+			{
+				JPSPathFinder* pathFinder = mIdlePathFinders.back();
+				mIdlePathFinders.pop_back();
+				return pathFinder;
+			}
+
+			mPathFinderCount++;
+		}
+
+		// 탐색 상태 할당은 맵 크기에 비례하므로 락 밖에서 한다
+		return new JPSPathFinder(mMap);
+	}
+
+	void release(JPSPathFinder* pathFinder)
+	{
+		std::lock_guard<std::mutex> lock(mPoolLock);
+		mIdlePathFinders.push_back(pathFinder);
+	}
+
+	// 끝난 쿼리 하나를 분포와 느린 쿼리 목록에 넣는다 (PATHFIND_STATISTICS_ON이 아니라면 아무것도 하지 않는다)
+	void recordQuery(const QueryRecord& query)
+	{
+#ifdef PATHFIND_STATISTICS_ON
+		const SearchStatistics& statistics = query.Statistics;
+
+		std::lock_guard<std::mutex> lock(mProfileLock);
+
+		mQueryProfile.QueryCount++;
+		mQueryProfile.ElapsedHistogram[getBucket(statistics.ElapsedNanoseconds / 1000)]++;
+		mQueryProfile.ExpandedHistogram[getBucket(statistics.ExpandedNodeCount)]++;
+		mQueryProfile.CreatedNodeCount += statistics.CreatedNodeCount;
+		mQueryProfile.ScannedCellCount += statistics.ScannedCellCount;
+		mQueryProfile.DecreaseKeyCount += statistics.DecreaseKeyCount;
+		mQueryProfile.LineOfSightCellCount += statistics.LineOfSightCellCount;
+
+		// 느린 순서를 유지하며 끼워 넣는다 (목록이 짧으므로 선형 탐색)
+		if ((int)mSlowQueries.size() == mSlowQueryCount
+			&& (mSlowQueryCount == 0 || mSlowQueries.back().Statistics.ElapsedNanoseconds >= statistics.ElapsedNanoseconds))
+		{
+			return;
+		}
+
+		auto position = mSlowQueries.begin();
+
+		while (position != mSlowQueries.end() && position->Statistics.ElapsedNanoseconds >= statistics.ElapsedNanoseconds)
+		{
+			++position;
+		}
+
+		mSlowQueries.insert(position, query);
+
+		if ((int)mSlowQueries.size() > mSlowQueryCount)
+		{
+			mSlowQueries.pop_back();
+		}
+#else
+		(void)query;
+#endif
+	}
+
+	// 한도 limit을 cap 이하로 줄인다 (둘 다 0 이하면 제한 없음)
+	inline static int clampLimit(int limit, int64_t cap)
+	{
+		if (cap > 0 && (limit <= 0 || limit > cap))
+		{
+			return static_cast<int>(cap);
+		}
+
+		return limit;
+	}
+
+	// value가 들어가는 분포 구간 (QueryProfile)
+	inline static int getBucket(int64_t value)
+	{
+		int bucket = 0;
+
+		while (value >= 4 && bucket < QueryProfile::BUCKET_COUNT - 1)
+		{
+			value >>= 2;
+			bucket++;
+		}
+
+		return bucket;
+	}
+
+	// 새 탐색을 시작하거나 멈춘 탐색을 이어서 찾을 수 있는가 (mQueueLock을 잡은 상태에서 호출)
+	inline bool canRunSlice() const
+	{
+		if (mbPaused || (mExpandBudgetPerTick > 0 && mRemainingBudget <= 0))
+		{
+			return false;
+		}
+
+		return mSuspendedSearches.empty() == false || (mQueue.empty() == false && mActiveSearchCount < mMaxActiveSearchCount);
+	}
+
+	// requesterID의 멈춘 탐색을 버리고 탐색 상태를 보관소에 돌려준다 (mQueueLock을 잡은 상태에서 호출)
+	void dropSuspendedSearch(uint64_t requesterID)
+	{
+		for (auto it = mSuspendedSearches.begin(); it != mSuspendedSearches.end(); ++it)
+		{
+			if (it->RequesterID == requesterID)
+			{
+				release(it->PathFinder);
+				mSuspendedSearches.erase(it);
+				mActiveSearchCount--;
+				mStatistics.SuspendedCount--;
+				mStatistics.CancelledCount++;
+				return;
+			}
+		}
+	}
+
+	// 가져가지 않은 결과 중 requesterID의 것을 버린다 (mQueueLock을 잡은 채로 호출)
+	// 결과는 mQueueLock을 잡은 채로 넣으므로, 이후에 이전 요청의 결과가 들어오지 않는다
+	void dropResults(uint64_t requesterID)
+	{
+		std::lock_guard<std::mutex> resultLock(mResultLock);
+
+		mResults.erase(std::remove_if(mResults.begin(), mResults.end(),
+			[requesterID](const Result& result) { return result.RequesterID == requesterID; }), mResults.end());
+	}
+
+	void workerThread()
+	{
+		std::unique_lock<std::mutex> lock(mQueueLock);
+
+		while (true)
+		{
+			mQueueCondition.wait(lock, [this]() { return mbStop || canRunSlice(); });
+
+			if (mbStop)
+			{
+				return;
+			}
+
+			runSlice(lock, 0);
+		}
+	}
+
+	// 멈춘 탐색 하나를 이어서 찾거나 새 요청 하나를 시작해서 한 조각만큼 찾는다
+	// canRunSlice()가 true일 때 mQueueLock을 잡은 상태로 호출하고, 조각을 실행하는 동안만 락을 놓는다
+	// microsecondsLimit : 0보다 크다면 조각 시간을 이 값 이하로 줄인다 (OnTick()의 남은 시간)
+	void runSlice(std::unique_lock<std::mutex>& lock, int64_t microsecondsLimit)
+	{
+		// 멈춘 탐색과 새 요청을 번갈아 고른다 (새 탐색을 더 시작할 수 없다면 멈춘 탐색만)
+		const bool bResume = mSuspendedSearches.empty() == false
+			&& (mbResumeTurn || mQueue.empty() || mActiveSearchCount >= mMaxActiveSearchCount);
+		mbResumeTurn = bResume == false;
+
+		ActiveSearch search;
+
+		if (bResume)
+		{
+			search = mSuspendedSearches.front();
+			mSuspendedSearches.pop_front();
+			mStatistics.SuspendedCount--;
+		}
+		else
+		{
+			uint64_t requesterID = mQueue.front();
+			mQueue.pop_front();
+
+			// 취소된 요청 (Cancel 이후 다시 Submit 했다면 큐에 같은 ID가 두 번 들어 있을 수 있다)
+			auto found = mRequesters.find(requesterID);
+
+			if (found == mRequesters.end() || found->second.bPending == false)
+			{
+				return;
+			}
+
+			Requester& requester = found->second;
+			requester.bPending = false;
+			search.RequesterID = requesterID;
+			search.Sequence = requester.Sequence;
+			search.PathFinder = nullptr;
+			search.StartX = requester.StartX;
+			search.StartY = requester.StartY;
+			search.EndX = requester.EndX;
+			search.EndY = requester.EndY;
+
+			mActiveSearchCount++;
+			mStatistics.QueueDepth--;
+			mStatistics.StartedCount++;
+			mStatistics.WaitMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - requester.SubmitTime).count();
+		}
+
+		// 조각 한도 (남은 틱 예산과 OnTick()의 남은 시간을 넘지 않는다)
+		// 새 요청의 첫 조각을 부분 경로 한도로 찾을 때도 같은 상한을 둔다
+		const int64_t expandCountLimit = mExpandBudgetPerTick > 0 ? mRemainingBudget : 0;
+		const int maxExpandedNodeCount = clampLimit(mExpandCountPerSlice, expandCountLimit);
+		const int maxMicroseconds = clampLimit(mMicrosecondsPerSlice, microsecondsLimit);
+		const int maxPartialExpandedNodeCount = clampLimit(mPartialExpandCount, expandCountLimit);
+		const int maxPartialMicroseconds = clampLimit(mPartialMicroseconds, microsecondsLimit);
+
+		mSearchingCount++;
+		lock.unlock();
+
+		auto searchBegin = std::chrono::steady_clock::now();
+
+		Path points;
+		Path partialPoints;
+		ESearchStatus status = ESearchStatus::Found;
+		int expandedNodeCount = 0;
+		bool bRejected = false;
+
+		// 이번 조각에서 끝난 쿼리 (부분 경로와 바로 끝난 나머지 탐색)
+		QueryRecord finishedQueries[2];
+		int finishedQueryCount = 0;
+
+		if (search.PathFinder != nullptr)
+		{
+			status = search.PathFinder->ContinuePathFind(maxExpandedNodeCount, maxMicroseconds);
+		}
+		else if (mCache == nullptr || mCache->TryGet(search.StartX, search.StartY, search.EndX, search.EndY, mMap.GetVersion(), points) == false)
+		{
+			const bool bPartialPath = mPartialExpandCount > 0 || mPartialMicroseconds > 0;
+
+			search.PathFinder = acquire();
+			status = search.PathFinder->BeginPathFind(search.StartX, search.StartY, search.EndX, search.EndY, bPartialPath);
+
+			if (status == ESearchStatus::Suspended)
+			{
+				status = bPartialPath
+					? search.PathFinder->ContinuePathFind(maxPartialExpandedNodeCount, maxPartialMicroseconds)
+					: search.PathFinder->ContinuePathFind(maxExpandedNodeCount, maxMicroseconds);
+			}
+
+			// 한도 안에 찾지 못했다면 가장 가까이 간 곳까지의 부분 경로를 먼저 보내고, 나머지는 그 끝에서부터 다시 찾는다
+			if (bPartialPath && status != ESearchStatus::Found)
+			{
+				int partialExpandedNodeCount = search.PathFinder->GetSliceExpandedNodeCount();
+
+				if (search.PathFinder->FinishWithPartialPath())
+				{
+					finishedQueries[finishedQueryCount++] = QueryRecord{ search.StartX, search.StartY, search.EndX, search.EndY,
+						search.PathFinder->GetSearchStatistics() };
+
+					partialPoints = search.PathFinder->TakePoints();
+					expandedNodeCount = partialExpandedNodeCount;
+					search.StartX = partialPoints.Back().X;
+					search.StartY = partialPoints.Back().Y;
+
+					status = search.PathFinder->BeginPathFind(search.StartX, search.StartY, search.EndX, search.EndY);
+				}
+				else if (search.PathFinder->IsRejected())
+				{
+					// 다른 연결 요소라 시작점보다 가까워진 곳이 없다면, 이어서 찾아도 연결 요소 전체를 확장할 뿐이므로 거부된 요청으로 끝낸다
+					status = ESearchStatus::NotFound;
+				}
+			}
+		}
+
+		if (search.PathFinder != nullptr)
+		{
+			expandedNodeCount += search.PathFinder->GetSliceExpandedNodeCount();
+
+			if (status != ESearchStatus::Suspended)
+			{
+				points = search.PathFinder->TakePoints();
+				bRejected = search.PathFinder->IsRejected();
+				finishedQueries[finishedQueryCount++] = QueryRecord{ search.StartX, search.StartY, search.EndX, search.EndY,
+					search.PathFinder->GetSearchStatistics() };
+
+				if (mCache != nullptr)
+				{
+					mCache->Put(search.StartX, search.StartY, search.EndX, search.EndY, mMap.GetVersion(), points);
+				}
+
+				release(search.PathFinder);
+				search.PathFinder = nullptr;
+			}
+		}
+
+		auto searchEnd = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < finishedQueryCount; ++i)
+		{
+			recordQuery(finishedQueries[i]);
+		}
+
+		lock.lock();
+
+		mRemainingBudget -= expandedNodeCount;
+		mStatistics.ExpandedNodeCount += expandedNodeCount;
+		mStatistics.RejectedCount += bRejected ? 1 : 0;
+		mStatistics.SliceCount++;
+		mStatistics.SearchMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(searchEnd - searchBegin).count();
+
+		// 탐색하는 동안 새 요청이 들어왔거나 취소되었다면 결과를 버린다
+		auto found = mRequesters.find(search.RequesterID);
+		bool bLatest = found != mRequesters.end() && found->second.Sequence == search.Sequence;
+
+		if (bLatest && partialPoints.Empty() == false)
+		{
+			mStatistics.PartialCount++;
+
+			// mQueueLock을 놓지 않고 넣어야 그 사이의 Submit(), Cancel()이 이 결과를 버릴 수 있다
+			std::lock_guard<std::mutex> resultLock(mResultLock);
+			mResults.push_back(Result{ search.RequesterID, std::move(partialPoints), true });
+		}
+
+		if (status == ESearchStatus::Suspended && bLatest)
+		{
+			// 다음 차례에 이어서 찾는다
+			mSuspendedSearches.push_back(search);
+			mStatistics.SuspendedCount++;
+		}
+		else
+		{
+			if (search.PathFinder != nullptr)
+			{
+				release(search.PathFinder);
+			}
+
+			mActiveSearchCount--;
+
+			if (bLatest)
+			{
+				mStatistics.CompletedCount++;
+
+				if (found->second.bPending == false)
+				{
+					mRequesters.erase(found);
+				}
+
+				std::lock_guard<std::mutex> resultLock(mResultLock);
+				mResults.push_back(Result{ search.RequesterID, std::move(points), false });
+			}
+			else
+			{
+				mStatistics.CancelledCount++;
+			}
+		}
+
+		// Pause()는 결과가 mResults에 들어간 뒤에 풀려야 바로 TakeResults()로 가져갈 수 있다
+		mSearchingCount--;
+		mIdleCondition.notify_all();
+	}
+
+private:
+	// 요청자 별 마지막 요청
+	struct Requester
+	{
+		uint64_t Sequence = 0;          // 마지막 요청의 번호 (서비스 전체에서 증가)
+		bool bPending = false;          // 큐에서 시작을 기다리는 중인가
+		int StartX = 0;
+		int StartY = 0;
+		int EndX = 0;
+		int EndY = 0;
+		std::chrono::steady_clock::time_point SubmitTime;
+	};
+
+	// 시작했고 끝나지 않은 탐색 (탐색 상태는 보관소에서 빌린 PathFinder에 있다, 캐시에서 찾는 중이라면 nullptr)
+	struct ActiveSearch
+	{
+		uint64_t RequesterID;
+		uint64_t Sequence;
+		JPSPathFinder* PathFinder;
+		int StartX;
+		int StartY;
+		int EndX;
+		int EndY;
+	};
+
+	enum
+	{
+		DEFAULT_MAX_ACTIVE_SEARCH_COUNT = 64,
+		DEFAULT_SLOW_QUERY_COUNT = 16,
+	};
+
+	const PathFindMap& mMap;
+	PathCache* mCache = nullptr;
+
+	// 동기 호출용 JPSPathFinder 보관
+	std::mutex mPoolLock;
+	std::vector<JPSPathFinder*> mIdlePathFinders;
+	int mPathFinderCount = 0;
+
+	// 비동기 요청
+	std::mutex mQueueLock;
+	std::condition_variable mQueueCondition;
+	std::deque<uint64_t> mQueue;                            // 요청자 ID
+	std::unordered_map<uint64_t, Requester> mRequesters;    // 대기 또는 탐색 중인 요청자
+	uint64_t mLastSequence = 0;
+	int mExpandBudgetPerTick = 0;
+	int64_t mRemainingBudget = 0;
+	bool mbStop = false;
+	bool mbPaused = false;
+	int mSearchingCount = 0;                                // 조각을 실행 중인 탐색 수
+	std::condition_variable mIdleCondition;                 // Pause() 대기용
+
+	// 탐색 조각
+	std::deque<ActiveSearch> mSuspendedSearches;            // 멈춘 탐색 (앞에서부터 돌아가며 이어서 찾는다)
+	int mActiveSearchCount = 0;                             // 시작했고 끝나지 않은 탐색 수 (조각 실행 중 포함)
+	bool mbResumeTurn = false;                              // 다음 조각은 멈춘 탐색의 차례인가 (새 요청과 번갈아)
+	int mExpandCountPerSlice = 0;
+	int mMicrosecondsPerSlice = 0;
+	int mMaxActiveSearchCount = DEFAULT_MAX_ACTIVE_SEARCH_COUNT;
+	int mPartialExpandCount = 0;
+	int mPartialMicroseconds = 0;
+	Statistics mStatistics{};
+
+	std::mutex mResultLock;
+	std::vector<Result> mResults;
+
+	// 쿼리 통계
+	std::mutex mProfileLock;
+	QueryProfile mQueryProfile{};
+	std::vector<QueryRecord> mSlowQueries;                  // 느린 순서
+	int mSlowQueryCount = DEFAULT_SLOW_QUERY_COUNT;
+
+	std::vector<std::thread> mThreads;
+};
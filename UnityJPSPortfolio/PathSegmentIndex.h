@@ -0,0 +1,189 @@
+// 이동 중인 경로들의 구간(웨이포인트 사이의 직선)을 맵 위의 버킷에 나눠 담아두는 공간 색인
+// 맵의 칸이 막혔을 때 그 칸을 지나는 경로의 주인만 찾아서 다시 길찾기를 하기 위해 씁니다 (모든 경로를 다시 찾지 않도록).
+// 구간은 LineOfSight가 검사하는 것과 같은 브레젠험 칸들이 지나는 버킷마다 넣고 (뒤쪽 점 -> 앞쪽 점 방향, ReduceNodes()와 같음),
+// Query()는 해당 버킷의 구간들 중 정말로 그 칸을 지나는 것만 골라냅니다.
+// 스레드 안전하지 않습니다 (GameServer에서는 게임 락을 잡은 업데이트 스레드에서만 사용).
+
+/************************************** 사용법 **************************************/
+// PathSegmentIndex index(mapWidth, mapHeight);
+//
+// index.Insert(ownerID, points); // 같은 주인의 이전 경로는 지워진다
+// index.Remove(ownerID);         // 도착했거나 나갔을 때
+//
+// // 맵의 (x, y) 칸이 막혔을 때
+// std::vector<uint64_t> owners;
+// index.Query(x, y, owners);
+/************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
+#include "LineOfSight.h"
+#include "Point.h"
+#include "Path.h"
+
+class PathSegmentIndex
+{
+public:
+	// bucketSize : 버킷 한 변의 칸 수 (작을수록 Query()가 검사할 구간이 줄고, Insert()가 넣을 버킷이 늘어난다)
+	PathSegmentIndex(int mapWidth, int mapHeight, int bucketSize = DEFAULT_BUCKET_SIZE)
+		: mBucketSize(bucketSize)
+		, mBucketWidth((mapWidth + bucketSize - 1) / bucketSize)
+		, mBucketHeight((mapHeight + bucketSize - 1) / bucketSize)
+		, mBuckets(static_cast<size_t>(mBucketWidth) * mBucketHeight)
+	{
+	}
+
+	PathSegmentIndex(const PathSegmentIndex& other) = delete;
+	PathSegmentIndex& operator=(const PathSegmentIndex& other) = delete;
+
+	// ownerID의 경로를 넣는다 (이전 경로는 지운다), 좌표는 모두 맵 안이어야 한다
+	void Insert(uint64_t ownerID, const Path& points)
+	{
+		Remove(ownerID);
+
+		if (points.Size() < 2)
+		{
+			return;
+		}
+
+		std::vector<int>& ownerBuckets = mOwners[ownerID];
+
+		for (int i = 1; i < points.Size(); ++i)
+		{
+			insertSegment(ownerID, points[i], points[i - 1], ownerBuckets);
+		}
+
+		std::sort(ownerBuckets.begin(), ownerBuckets.end());
+		ownerBuckets.erase(std::unique(ownerBuckets.begin(), ownerBuckets.end()), ownerBuckets.end());
+	}
+
+	void Remove(uint64_t ownerID)
+	{
+		auto found = mOwners.find(ownerID);
+
+		if (found == mOwners.end())
+		{
+			return;
+		}
+
+		for (int bucket : found->second)
+		{
+			std::vector<Segment>& segments = mBuckets[bucket];
+
+			// 순서는 상관없으므로 마지막 구간으로 덮어쓴다
+			for (size_t i = 0; i < segments.size();)
+			{
+				if (segments[i].OwnerID == ownerID)
+				{
+					segments[i] = segments.back();
+					segments.pop_back();
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+
+		mOwners.erase(found);
+	}
+
+	inline bool Contains(uint64_t ownerID) const { return mOwners.find(ownerID) != mOwners.end(); }
+
+	// 들어 있는 경로 수
+	inline int GetOwnerCount() const { return static_cast<int>(mOwners.size()); }
+
+	// (x, y) 칸을 지나는 경로의 주인들을 outOwnerIDs 뒤에 담는다 (이번 호출 안에서는 중복 없이)
+	void Query(int x, int y, std::vector<uint64_t>& outOwnerIDs) const
+	{
+		const size_t firstOutput = outOwnerIDs.size();
+		const std::vector<Segment>& segments = mBuckets[getBucket(x, y)];
+
+		for (const Segment& segment : segments)
+		{
+			if (std::find(outOwnerIDs.begin() + firstOutput, outOwnerIDs.end(), segment.OwnerID) != outOwnerIDs.end())
+			{
+				continue;
+			}
+
+			// 검사하는 칸이 (x, y)일 때 멈추므로 false면 지나는 구간
+			bool bPassed = LineOfSight::IsClear(segment.From.X, segment.From.Y, segment.To.X, segment.To.Y,
+				[x, y](int cellX, int cellY) { return cellX != x || cellY != y; }) == false;
+
+			if (bPassed)
+			{
+				outOwnerIDs.push_back(segment.OwnerID);
+			}
+		}
+	}
+
+	// 버킷과 구간, 주인 목록의 총 크기 (byte, 해시 테이블의 노드는 대략)
+	size_t GetReservedBytes() const
+	{
+		size_t bytes = mBuckets.capacity() * sizeof(std::vector<Segment>);
+
+		for (const std::vector<Segment>& segments : mBuckets)
+		{
+			bytes += segments.capacity() * sizeof(Segment);
+		}
+
+		for (const auto& pair : mOwners)
+		{
+			bytes += sizeof(pair) + pair.second.capacity() * sizeof(int);
+		}
+
+		return bytes;
+	}
+
+private:
+	struct Segment
+	{
+		uint64_t OwnerID;
+		Point From;		// 뒤쪽 점
+		Point To;		// 앞쪽 점
+	};
+
+	// 구간의 칸들이 지나는 버킷마다 구간을 넣는다
+	void insertSegment(uint64_t ownerID, const Point& from, const Point& to, std::vector<int>& outOwnerBuckets)
+	{
+		int lastBucket = -1;
+
+		// 브레젠험 칸은 한 방향으로만 움직이므로 떠난 버킷으로 다시 돌아오지 않는다
+		LineOfSight::IsClear(from.X, from.Y, to.X, to.Y, [&](int x, int y)
+			{
+				int bucket = getBucket(x, y);
+
+				if (bucket != lastBucket)
+				{
+					mBuckets[bucket].push_back(Segment{ ownerID, from, to });
+					outOwnerBuckets.push_back(bucket);
+					lastBucket = bucket;
+				}
+
+				return true;
+			});
+	}
+
+	inline int getBucket(int x, int y) const
+	{
+		return (y / mBucketSize) * mBucketWidth + (x / mBucketSize);
+	}
+
+	enum
+	{
+		DEFAULT_BUCKET_SIZE = 16,
+	};
+
+private:
+	const int mBucketSize;
+	const int mBucketWidth;
+	const int mBucketHeight;
+
+	std::vector<std::vector<Segment>> mBuckets;
+	std::unordered_map<uint64_t, std::vector<int>> mOwners;		// 주인 -> 구간을 넣은 버킷들 (Remove()용)
+};
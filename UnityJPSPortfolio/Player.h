@@ -1,8 +1,7 @@
 #pragma once
 
-#include <list>
-
 #include "Point.h"
+#include "Path.h"
 
 class Player
 {
@@ -16,7 +15,8 @@ public:
         mY = y;
 
         mName.clear();
-        mDestPositions.clear();
+        mDestPositions.Clear();
+        mGoal = Point{ 0, 0 };
         mState = EPlayerState::Idle;
         mLastRecvTick = ::timeGetTime();
         mLastTick = 0;
@@ -32,10 +32,19 @@ public:
     inline void     SetStateToMove(void) { mState = EPlayerState::Moving; }
     inline void     SetStateToIdle(void) { mState = EPlayerState::Idle; }
 
-    inline const std::list<Point>& GetDestPositions(void) const { return mDestPositions; }
+    inline const Path& GetDestPositions(void) const { return mDestPositions; }
+
+    // 마지막으로 요청한 목적지 (부분 경로를 받았다면 GetDestPositions().Back()은 중간 지점이다)
+    inline const Point& GetGoal(void) const { return mGoal; }
+
+    inline void SetGoal(const Point& goal) { mGoal = goal; }
+
+    inline void PushToDestPositions(const Point& point) { mDestPositions.PushBack(point); }
+
+    inline void ClearDestPositions(void) { mDestPositions.Clear(); }
 
-    inline void PushToDestPositions(const Point& point) { mDestPositions.push_back(point); }
-    inline void PopDestPositions(void) { mDestPositions.pop_front(); }
+    // 커서만 옮기므로 메모리를 해제하지 않는다 (다음 경로를 받을 때 재사용)
+    inline void PopDestPositions(void) { mDestPositions.PopFront(); }
 
     inline uint32_t GetLastTick(void) const { return mLastTick; }
 
@@ -88,7 +97,8 @@ private:
     float               mX;
     float               mY;
     std::wstring        mName;
-    std::list<Point>    mDestPositions;
+    Path                mDestPositions;
+    Point               mGoal;
     EPlayerState        mState;
     uint32_t            mLastRecvTick;   // timeout을 위한 tick
     uint32_t            mLastTick;       // 프레임마다 이동을 위한 tick
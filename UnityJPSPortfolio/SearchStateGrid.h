@@ -0,0 +1,101 @@
+// 길찾기 한 번 동안 사용하는 셀 별 탐색 상태 (그 셀에 만든 노드의 번호)를 저장합니다.
+// 셀마다 노드 번호 옆에 세대(Generation) 번호를 같이 기록하고, 현재 세대와 다른 셀은 방문하지 않은 셀로 취급합니다.
+// 따라서 매 탐색마다 전체 셀을 초기화할 필요 없이 NewGeneration() 호출 한 번으로 초기화됩니다.
+// G값은 노드에만 있으므로 (NodeArena) 셀의 G값은 GetNode()로 얻은 노드에서 읽습니다.
+
+/************************************** 사용법 **************************************/
+// SearchStateGrid state(width, height);
+//
+// state.NewGeneration(); // 탐색 시작 전
+//
+// if (state.IsVisited(x, y) == false)
+// {
+//     state.SetNode(x, y, nodeArena.Alloc(x, y, g, parent, h));
+// }
+/************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include "Node.h"
+
+class SearchStateGrid
+{
+public:
+	SearchStateGrid(int width, int height)
+		: mWidth(width)
+		, mHeight(height)
+		, mGeneration(1)
+	{
+		mCells = new Cell[width * height];
+
+		for (int i = 0; i < width * height; ++i)
+		{
+			mCells[i].Generation = 0;
+			mCells[i].Node = NULL_NODE;
+		}
+	}
+
+	~SearchStateGrid()
+	{
+		delete[] mCells;
+	}
+
+	SearchStateGrid(const SearchStateGrid& other) = delete;
+	SearchStateGrid& operator=(const SearchStateGrid& other) = delete;
+
+	// 새로운 탐색을 시작한다 (이전 탐색의 기록은 모두 무효화된다)
+	void NewGeneration()
+	{
+		++mGeneration;
+
+		// 세대 번호가 한 바퀴 돌았다면 이전 기록과 겹치지 않도록 실제로 초기화한다
+		if (mGeneration == 0)
+		{
+			for (int i = 0; i < mWidth * mHeight; ++i)
+			{
+				mCells[i].Generation = 0;
+			}
+
+			mGeneration = 1;
+		}
+	}
+
+	// 이번 탐색에서 노드를 만든 셀인가
+	inline bool IsVisited(int x, int y) const
+	{
+		return mCells[y * mWidth + x].Generation == mGeneration;
+	}
+
+	// 이번 탐색에서 이 셀에 만든 노드를 얻는다 (만들지 않았다면 NULL_NODE)
+	inline NodeIndex GetNode(int x, int y) const
+	{
+		const Cell& cell = mCells[y * mWidth + x];
+		return cell.Generation == mGeneration ? cell.Node : NULL_NODE;
+	}
+
+	inline void SetNode(int x, int y, NodeIndex node)
+	{
+		Cell& cell = mCells[y * mWidth + x];
+		cell.Generation = mGeneration;
+		cell.Node = node;
+	}
+
+	inline size_t GetReservedBytes() const
+	{
+		return static_cast<size_t>(mWidth) * mHeight * sizeof(Cell);
+	}
+
+private:
+	struct Cell
+	{
+		uint32_t Generation;
+		NodeIndex Node;
+	};
+
+	const int mWidth;
+	const int mHeight;
+	uint32_t mGeneration;
+	Cell* mCells;
+};
@@ -0,0 +1,36 @@
+// 길찾기 한 번의 통계 (JPSPathFinder::GetSearchStatistics())
+// 어떤 쿼리가 왜 느린지 (노드를 많이 열었는지, 점프가 길었는지, 경로 줄이기가 길었는지) 구분하기 위해 탐색 코어에서 셉니다.
+// 만든 노드 수와 확장한 노드 수는 원래 세고 있던 값이고, 나머지는 PATHFIND_STATISTICS_ON일 때만 셉니다.
+// PATHFIND_STATISTICS_OFF를 정의하면 (프로젝트 설정 또는 이 파일 위에서) 세는 코드가 전부 빠지고 그 값들은 0으로 남습니다.
+
+/************************************** 사용법 **************************************/
+// pathFinder.PathFind(startX, startY, endX, endY);
+// SearchStatistics statistics = pathFinder.GetSearchStatistics();
+//
+// // 탐색 코어 안에서 셀 때 (꺼져 있으면 통째로 빠진다)
+// PATHFIND_STATISTICS(mStatistics.DecreaseKeyCount++);
+/************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#ifndef PATHFIND_STATISTICS_OFF
+#define PATHFIND_STATISTICS_ON
+#endif
+
+#ifdef PATHFIND_STATISTICS_ON
+#define PATHFIND_STATISTICS(Statement) Statement
+#else
+#define PATHFIND_STATISTICS(Statement)
+#endif
+
+struct SearchStatistics
+{
+	int CreatedNodeCount;           // 만든 노드 수
+	int ExpandedNodeCount;          // OPEN LIST에서 꺼내 확장한 노드 수
+	int ScannedCellCount;           // 점프(직선, 대각선 탐색)가 지나간 칸 수 (JPS+ 테이블은 한 번에 건너뛴 칸 수)
+	int DecreaseKeyCount;           // OPEN LIST에 있는 노드의 G를 줄인 횟수
+	int LineOfSightCellCount;       // 경로 줄이기(ReduceNodes(), Lazy Theta*의 부모 검사)에서 직선 검사한 칸 수
+	int64_t ElapsedNanoseconds;     // 탐색에 걸린 시간 (나눠서 찾았다면 조각들의 합)
+};
@@ -15,6 +15,9 @@ int main(void)
 #ifdef PROFILE_ON
     LOGF(ELogLevel::System, L"Profiler: PROFILE_ON");
 #endif
+#ifdef PATHFIND_STATISTICS_ON
+    LOGF(ELogLevel::System, L"PathFind Statistics: PATHFIND_STATISTICS_ON");
+#endif
 
 #pragma region config 파일 읽기
     const WCHAR* CONFIG_FILE_NAME = L"UnityJPSPortfolio.config";
@@ -74,6 +77,53 @@ int main(void)
         g_gameServer.SetSendBufferSizeToZero(true);
         LOGF(ELogLevel::System, L"ChatServer - SetSendBufferSizeToZero(true)");
     }
+
+    /*************************************** Config - PathFind ***************************************/
+
+    uint32_t inputPathFindThreadCount;
+    uint32_t inputPathFindExpandBudget;
+    uint32_t inputPathFindCacheSize;
+    uint32_t inputPathFindLandmarkCount;
+    uint32_t inputPathFindLandmarkMemoryMB;
+    uint32_t inputPathFindGoalBounds;
+    uint32_t inputPathFindSliceExpand;
+    uint32_t inputPathFindSliceMicroseconds;
+    uint32_t inputPathFindMaxActiveSearch;
+    uint32_t inputPathFindTickMicroseconds;
+    uint32_t inputPathFindPartialExpand;
+    uint32_t inputPathFindPartialMicroseconds;
+
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_THREAD_COUNT", &inputPathFindThreadCount), L"ERROR: config file read failed (PATHFIND_THREAD_COUNT)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_EXPAND_BUDGET", &inputPathFindExpandBudget), L"ERROR: config file read failed (PATHFIND_EXPAND_BUDGET)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_CACHE_SIZE", &inputPathFindCacheSize), L"ERROR: config file read failed (PATHFIND_CACHE_SIZE)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_LANDMARK_COUNT", &inputPathFindLandmarkCount), L"ERROR: config file read failed (PATHFIND_LANDMARK_COUNT)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_LANDMARK_MEMORY_MB", &inputPathFindLandmarkMemoryMB), L"ERROR: config file read failed (PATHFIND_LANDMARK_MEMORY_MB)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_GOAL_BOUNDS", &inputPathFindGoalBounds), L"ERROR: config file read failed (PATHFIND_GOAL_BOUNDS)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_SLICE_EXPAND", &inputPathFindSliceExpand), L"ERROR: config file read failed (PATHFIND_SLICE_EXPAND)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_SLICE_US", &inputPathFindSliceMicroseconds), L"ERROR: config file read failed (PATHFIND_SLICE_US)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_MAX_ACTIVE", &inputPathFindMaxActiveSearch), L"ERROR: config file read failed (PATHFIND_MAX_ACTIVE)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_TICK_US", &inputPathFindTickMicroseconds), L"ERROR: config file read failed (PATHFIND_TICK_US)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_PARTIAL_EXPAND", &inputPathFindPartialExpand), L"ERROR: config file read failed (PATHFIND_PARTIAL_EXPAND)");
+    ASSERT_LIVE(ConfigReader::GetInt(CONFIG_FILE_NAME, L"PATHFIND_PARTIAL_US", &inputPathFindPartialMicroseconds), L"ERROR: config file read failed (PATHFIND_PARTIAL_US)");
+
+    LOGF(ELogLevel::System, L"PATHFIND_THREAD_COUNT = %u", inputPathFindThreadCount);
+    LOGF(ELogLevel::System, L"PATHFIND_EXPAND_BUDGET = %u", inputPathFindExpandBudget);
+    LOGF(ELogLevel::System, L"PATHFIND_CACHE_SIZE = %u", inputPathFindCacheSize);
+    LOGF(ELogLevel::System, L"PATHFIND_LANDMARK_COUNT = %u", inputPathFindLandmarkCount);
+    LOGF(ELogLevel::System, L"PATHFIND_LANDMARK_MEMORY_MB = %u", inputPathFindLandmarkMemoryMB);
+    LOGF(ELogLevel::System, L"PATHFIND_GOAL_BOUNDS = %u", inputPathFindGoalBounds);
+    LOGF(ELogLevel::System, L"PATHFIND_SLICE_EXPAND = %u", inputPathFindSliceExpand);
+    LOGF(ELogLevel::System, L"PATHFIND_SLICE_US = %u", inputPathFindSliceMicroseconds);
+    LOGF(ELogLevel::System, L"PATHFIND_MAX_ACTIVE = %u", inputPathFindMaxActiveSearch);
+    LOGF(ELogLevel::System, L"PATHFIND_TICK_US = %u", inputPathFindTickMicroseconds);
+    LOGF(ELogLevel::System, L"PATHFIND_PARTIAL_EXPAND = %u", inputPathFindPartialExpand);
+    LOGF(ELogLevel::System, L"PATHFIND_PARTIAL_US = %u", inputPathFindPartialMicroseconds);
+
+    g_gameServer.SetPathFindOption(inputPathFindThreadCount, inputPathFindExpandBudget, inputPathFindCacheSize);
+    g_gameServer.SetLandmarkOption(inputPathFindLandmarkCount, static_cast<size_t>(inputPathFindLandmarkMemoryMB) * 1024 * 1024);
+    g_gameServer.SetGoalBoundsOption(inputPathFindGoalBounds != 0);
+    g_gameServer.SetPathFindSliceOption(inputPathFindSliceExpand, inputPathFindSliceMicroseconds, inputPathFindMaxActiveSearch, inputPathFindTickMicroseconds);
+    g_gameServer.SetPartialPathOption(inputPathFindPartialExpand, inputPathFindPartialMicroseconds);
 #pragma endregion
 
     // 최대 페이로드 길이 지정
@@ -109,13 +159,20 @@ int main(void)
                 LOGF(ELogLevel::System, L"UnityJPSPortfolio.txt saved");
             }
 #endif
+            else if (input == 'D' || input == 'd')
+            {
+                if (g_gameServer.SaveSlowPathFindQueries("PathFindSlowQueries.txt"))
+                {
+                    LOGF(ELogLevel::System, L"PathFindSlowQueries.txt saved");
+                }
+            }
         }
 
         // NetServer Monitoring
         monitoringInfo = g_gameServer.GetMonitoringInfo();
 
         wprintf(L"\n\n");
-        wprintf(L"[ GameServer Running (S: profile save) (Q: quit)]\n");
+        wprintf(L"[ GameServer Running (S: profile save) (D: slow path find dump) (Q: quit)]\n");
         wprintf(L"=================================================\n");
         wprintf(L"Session Count        = %u / %u\n", g_gameServer.GetSessionCount(), g_gameServer.GetMaxSessionCount());
         wprintf(L"Accept Total         = %llu\n", g_gameServer.GetTotalAcceptCount());
@@ -127,6 +184,24 @@ int main(void)
         wprintf(L"Recv Message TPS     = %9u (Avg: %9u)\n", monitoringInfo.RecvMessageTPS, monitoringInfo.AverageRecvMessageTPS);
         wprintf(L"Send Pending TPS     = %9u (Avg: %9u)\n", monitoringInfo.SendPendingTPS, monitoringInfo.AverageSendPendingTPS);
         wprintf(L"Recv Pending TPS     = %9u (Avg: %9u)\n", monitoringInfo.RecvPendingTPS, monitoringInfo.AverageRecvPendingTPS);
+        wprintf(L"-------------------- PathFind -------------------\n");
+        wprintf(L"Queue Depth          = %9u\n", monitoringInfo.PathFindQueueDepth);
+        wprintf(L"PathFind TPS         = %9u (Cancel: %9u)\n", monitoringInfo.PathFindTPS, monitoringInfo.PathFindCancelTPS);
+        wprintf(L"Expand Node TPS      = %9u\n", monitoringInfo.PathFindExpandTPS);
+        wprintf(L"Reject TPS           = %9u\n", monitoringInfo.PathFindRejectTPS);
+        wprintf(L"Cache Hit TPS        = %9u (Miss: %9u)\n", monitoringInfo.PathFindCacheHitTPS, monitoringInfo.PathFindCacheMissTPS);
+        wprintf(L"Slice TPS            = %9u (Suspended: %6u)\n", monitoringInfo.PathFindSliceTPS, monitoringInfo.PathFindSuspendedCount);
+        wprintf(L"Partial Path TPS     = %9u\n", monitoringInfo.PathFindPartialTPS);
+        wprintf(L"Wait / Search (ms)   = %9.3f / %9.3f\n", monitoringInfo.PathFindAverageWaitMs, monitoringInfo.PathFindAverageSearchMs);
+        wprintf(L"Query Histogram      =     <4    <16    <64   <256    <1K    <4K   <16K   16K+\n");
+        wprintf(L"  Search (us)        = %6u %6u %6u %6u %6u %6u %6u %6u\n",
+            monitoringInfo.PathFindSearchUsHistogram[0], monitoringInfo.PathFindSearchUsHistogram[1], monitoringInfo.PathFindSearchUsHistogram[2], monitoringInfo.PathFindSearchUsHistogram[3],
+            monitoringInfo.PathFindSearchUsHistogram[4], monitoringInfo.PathFindSearchUsHistogram[5], monitoringInfo.PathFindSearchUsHistogram[6], monitoringInfo.PathFindSearchUsHistogram[7]);
+        wprintf(L"  Expand Node        = %6u %6u %6u %6u %6u %6u %6u %6u\n",
+            monitoringInfo.PathFindExpandHistogram[0], monitoringInfo.PathFindExpandHistogram[1], monitoringInfo.PathFindExpandHistogram[2], monitoringInfo.PathFindExpandHistogram[3],
+            monitoringInfo.PathFindExpandHistogram[4], monitoringInfo.PathFindExpandHistogram[5], monitoringInfo.PathFindExpandHistogram[6], monitoringInfo.PathFindExpandHistogram[7]);
+        wprintf(L"Scan / DecKey / LOS  = %9.1f / %9.1f / %9.1f (per query)\n",
+            monitoringInfo.PathFindAverageScannedCells, monitoringInfo.PathFindAverageDecreaseKeys, monitoringInfo.PathFindAverageLineOfSightCells);
         wprintf(L"----------------------- CPU ---------------------\n");
         wprintf(L"Total  = Processor: %6.3f / Process: %6.3f\n", monitoringInfo.ProcessorTimeTotal, monitoringInfo.ProcessTimeTotal);
         wprintf(L"User   = Processor: %6.3f / Process: %6.3f\n", monitoringInfo.ProcessorTimeUser, monitoringInfo.ProcessTimeUser);